@@ -0,0 +1,410 @@
+/**
+ * @file bar_engine.hpp
+ * @brief Inline per-symbol trade bars (OHLCV, VWAP) with seqlock snapshots
+ *
+ * The feed handler calls BarEngine::on_trade() from its execution paths, so
+ * bars are built once on the feed thread instead of by every consumer from
+ * on_trade callbacks. State lives in a flat [locate][interval] array; each
+ * entry holds the current bar and the most recent completed bar.
+ *
+ * Features:
+ * - Up to MAX_INTERVALS bar intervals, aligned to multiples of the interval
+ * - Seqlock publication: wait-free writer, lock-free snapshot readers
+ * - BrokenTradeMessage corrections applied incrementally from a bounded
+ *   trade log (volume, VWAP and count exactly; OHLC is rebuilt from the
+ *   log's surviving trades in the affected bar). A match-number index finds
+ *   the broken trade in O(1) and a per-symbol chain through the log limits
+ *   the OHLC rebuild to that symbol's trades.
+ *
+ * Bars roll on the first trade past the interval end, so a reader should
+ * compare BarSnapshot::current.start with its own clock.
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "order_book.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace itch {
+
+/**
+ * @brief One OHLCV bar; prices are ITCH fixed-point (4 decimal places)
+ */
+struct Bar {
+    Timestamp     start = 0;        // Interval start, aligned to the interval
+    Price         open = 0;
+    Price         high = 0;
+    Price         low = 0;
+    Price         close = 0;
+    std::uint64_t volume = 0;
+    std::uint64_t notional = 0;     // Sum of price * shares
+    std::uint64_t trade_count = 0;
+
+    bool empty() const noexcept { return trade_count == 0; }
+
+    /// Volume-weighted average price in the same fixed-point units as Price
+    double vwap() const noexcept {
+        return volume ? static_cast<double>(notional) / static_cast<double>(volume) : 0.0;
+    }
+};
+static_assert(sizeof(Bar) == 64, "Bar must be 64 bytes");
+
+/**
+ * @brief Consistent copy of one symbol / interval
+ */
+struct BarSnapshot {
+    Bar current;
+    Bar previous;               // Most recent completed bar that had trades
+    std::uint64_t version = 0;
+};
+
+/**
+ * @brief Single-writer seqlock slot holding the current and previous bar
+ *
+ * Same protocol as SeqlockBBOSlot: fields are relaxed atomics, ordering
+ * comes from the sequence counter and fences.
+ */
+struct ITCH_CACHE_ALIGNED SeqlockBarSlot {
+    static constexpr std::size_t WORDS = sizeof(Bar) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<std::uint64_t> current[WORDS] = {};
+    std::atomic<std::uint64_t> previous[WORDS] = {};
+
+    ITCH_FORCE_INLINE void store(const Bar& cur, const Bar* prev) noexcept {
+        const std::uint64_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        store_words(current, cur);
+        if (prev) store_words(previous, *prev);
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    ITCH_FORCE_INLINE bool try_load(BarSnapshot& out) const noexcept {
+        const std::uint64_t seq1 = sequence.load(std::memory_order_acquire);
+        if (ITCH_UNLIKELY(seq1 & 1)) {
+            return false;
+        }
+        load_words(current, out.current);
+        load_words(previous, out.previous);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t seq2 = sequence.load(std::memory_order_relaxed);
+        out.version = seq1;
+        return seq1 == seq2;
+    }
+
+private:
+    // Field-by-field rather than memcpy through a word array: a 64-byte
+    // vector store followed by 8-byte reloads defeats store forwarding.
+    static ITCH_FORCE_INLINE void store_words(std::atomic<std::uint64_t>* dst, const Bar& bar) noexcept {
+        dst[0].store(bar.start, std::memory_order_relaxed);
+        dst[1].store(static_cast<std::uint64_t>(bar.open), std::memory_order_relaxed);
+        dst[2].store(static_cast<std::uint64_t>(bar.high), std::memory_order_relaxed);
+        dst[3].store(static_cast<std::uint64_t>(bar.low), std::memory_order_relaxed);
+        dst[4].store(static_cast<std::uint64_t>(bar.close), std::memory_order_relaxed);
+        dst[5].store(bar.volume, std::memory_order_relaxed);
+        dst[6].store(bar.notional, std::memory_order_relaxed);
+        dst[7].store(bar.trade_count, std::memory_order_relaxed);
+    }
+
+    static ITCH_FORCE_INLINE void load_words(const std::atomic<std::uint64_t>* src, Bar& bar) noexcept {
+        bar.start = src[0].load(std::memory_order_relaxed);
+        bar.open = static_cast<Price>(src[1].load(std::memory_order_relaxed));
+        bar.high = static_cast<Price>(src[2].load(std::memory_order_relaxed));
+        bar.low = static_cast<Price>(src[3].load(std::memory_order_relaxed));
+        bar.close = static_cast<Price>(src[4].load(std::memory_order_relaxed));
+        bar.volume = src[5].load(std::memory_order_relaxed);
+        bar.notional = src[6].load(std::memory_order_relaxed);
+        bar.trade_count = src[7].load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Per-locate rolling bars for a fixed set of intervals
+ *
+ * on_trade() / on_broken_trade() / clear() must only be called from the
+ * feed thread; read() / try_read() may be called from any thread.
+ */
+class BarEngine {
+public:
+    static constexpr std::size_t MAX_SYMBOLS = OrderBookManager::MAX_SYMBOLS;
+    static constexpr std::size_t MAX_INTERVALS = 4;
+    static constexpr std::size_t DEFAULT_TRADE_LOG = 1 << 20;
+
+    struct Stats {
+        std::uint64_t trades = 0;
+        std::uint64_t breaks = 0;           // Corrections applied
+        std::uint64_t unmatched_breaks = 0; // Match number not in the trade log
+        std::uint64_t stale_breaks = 0;     // Trade older than every retained bar
+        std::uint64_t inexact_breaks = 0;   // OHLC kept: bar's trades partly evicted from the log
+    };
+
+    /**
+     * @param intervals_ns  Bar lengths in nanoseconds (at most MAX_INTERVALS, non-zero)
+     * @param trade_log     Trades retained for broken-trade corrections (rounded up to a power of 2)
+     */
+    explicit BarEngine(const std::vector<std::uint64_t>& intervals_ns,
+                       std::size_t trade_log = DEFAULT_TRADE_LOG)
+        : interval_count_(std::min(intervals_ns.size(), MAX_INTERVALS)),
+          bars_(new BarState[MAX_SYMBOLS * MAX_INTERVALS]),
+          slots_(new SeqlockBarSlot[MAX_SYMBOLS * MAX_INTERVALS]) {
+        for (std::size_t i = 0; i < interval_count_; ++i) {
+            intervals_[i] = intervals_ns[i] ? intervals_ns[i] : 1;
+        }
+        std::size_t capacity = 1;
+        while (capacity < trade_log) capacity <<= 1;
+        log_.resize(capacity);
+        log_mask_ = capacity - 1;
+        match_index_.resize(capacity * 2);
+        match_mask_ = capacity * 2 - 1;
+        std::fill(std::begin(last_trade_), std::end(last_trade_), NO_TRADE);
+    }
+
+    BarEngine(const BarEngine&) = delete;
+    BarEngine& operator=(const BarEngine&) = delete;
+
+    std::size_t interval_count() const noexcept { return interval_count_; }
+    std::uint64_t interval_ns(std::size_t i) const noexcept { return intervals_[i]; }
+
+    /**
+     * @brief Fold one printable execution into every interval's bar
+     */
+    ITCH_FORCE_INLINE void on_trade(StockLocate locate, Price price, Quantity shares,
+                                    std::uint64_t match_number, Timestamp ts) noexcept {
+        const std::uint64_t seq = log_head_++;
+        TradeRecord& rec = log_[seq & log_mask_];
+        rec.match_number = match_number;
+        rec.timestamp = ts;
+        rec.price = price;
+        rec.shares = shares;
+        rec.stock_locate = locate;
+        rec.broken = false;
+        rec.prev_same_locate = last_trade_[locate];
+        last_trade_[locate] = seq;
+        index_trade(match_number, seq);
+        ++stats_.trades;
+
+        const std::uint64_t notional = static_cast<std::uint64_t>(price) * shares;
+        for (std::size_t i = 0; i < interval_count_; ++i) {
+            const std::size_t idx = index(locate, i);
+            BarState& state = bars_[idx];
+            Bar& cur = state.current;
+            bool rolled = false;
+            if (ITCH_UNLIKELY(ts >= cur.start + intervals_[i] || cur.empty())) {
+                if (!cur.empty()) {
+                    state.previous = cur;
+                    rolled = true;
+                }
+                cur = Bar{};
+                cur.start = ts - ts % intervals_[i];
+                cur.open = cur.high = cur.low = price;
+            }
+            cur.high = std::max(cur.high, price);
+            cur.low = std::min(cur.low, price);
+            cur.close = price;
+            cur.volume += shares;
+            cur.notional += notional;
+            ++cur.trade_count;
+            slots_[idx].store(cur, rolled ? &state.previous : nullptr);
+        }
+    }
+
+    /**
+     * @brief Remove a broken execution from whichever retained bars contain it
+     */
+    void on_broken_trade(StockLocate locate, std::uint64_t match_number) noexcept {
+        TradeRecord* rec = find(locate, match_number);
+        if (!rec || rec->broken) {
+            ++stats_.unmatched_breaks;
+            return;
+        }
+        rec->broken = true;
+        ++stats_.breaks;
+
+        for (std::size_t i = 0; i < interval_count_; ++i) {
+            const std::size_t idx = index(locate, i);
+            BarState& state = bars_[idx];
+            Bar* bar = contains(state.current, i, rec->timestamp) ? &state.current
+                     : contains(state.previous, i, rec->timestamp) ? &state.previous
+                     : nullptr;
+            if (!bar) {
+                ++stats_.stale_breaks;
+                continue;
+            }
+            bar->volume -= rec->shares;
+            bar->notional -= static_cast<std::uint64_t>(rec->price) * rec->shares;
+            --bar->trade_count;
+            rebuild_ohlc(*bar, i, locate);
+            slots_[idx].store(state.current, &state.previous);
+        }
+    }
+
+    ITCH_FORCE_INLINE bool try_read(StockLocate locate, std::size_t interval,
+                                    BarSnapshot& out) const noexcept {
+        return slots_[index(locate, interval)].try_load(out);
+    }
+
+    /**
+     * @brief Spin until a consistent snapshot is obtained
+     */
+    BarSnapshot read(StockLocate locate, std::size_t interval) const noexcept {
+        BarSnapshot out;
+        while (!try_read(locate, interval, out)) {
+            cpu_relax();
+        }
+        return out;
+    }
+
+    const Stats& stats() const noexcept { return stats_; }
+
+    /**
+     * @brief Forget all bars and trades (writer thread only)
+     */
+    void clear() noexcept {
+        const Bar empty{};
+        for (std::size_t idx = 0; idx < MAX_SYMBOLS * MAX_INTERVALS; ++idx) {
+            if (bars_[idx].current.empty() && bars_[idx].previous.empty()) continue;
+            bars_[idx] = BarState{};
+            slots_[idx].store(empty, &empty);
+        }
+        std::fill(log_.begin(), log_.end(), TradeRecord{});
+        std::fill(match_index_.begin(), match_index_.end(), MatchEntry{});
+        std::fill(std::begin(last_trade_), std::end(last_trade_), NO_TRADE);
+        log_head_ = 0;
+        stats_ = Stats{};
+    }
+
+private:
+    struct BarState {
+        Bar current;
+        Bar previous;
+    };
+
+    static constexpr std::uint64_t NO_TRADE = ~0ULL;
+    static constexpr std::size_t MATCH_PROBES = 8;
+
+    struct TradeRecord {
+        std::uint64_t match_number = 0;
+        Timestamp     timestamp = 0;
+        Price         price = 0;
+        std::uint64_t prev_same_locate = NO_TRADE;  // Log sequence of the symbol's previous trade
+        Quantity      shares = 0;
+        StockLocate   stock_locate = 0;
+        bool          broken = true;    // Empty slots never match
+    };
+
+    /// Match index slot; refers to log sequence seq_plus_one - 1 (0 = empty)
+    struct MatchEntry {
+        std::uint32_t match_low = 0;
+        std::uint32_t seq_plus_one = 0;
+    };
+
+    std::size_t interval_count_;
+    std::uint64_t intervals_[MAX_INTERVALS] = {};
+    std::unique_ptr<BarState[]> bars_;
+    std::unique_ptr<SeqlockBarSlot[]> slots_;
+    std::vector<TradeRecord> log_;
+    std::size_t log_mask_ = 0;
+    std::uint64_t log_head_ = 0;
+    std::vector<MatchEntry> match_index_;   // Twice the log, so live entries stay sparse
+    std::size_t match_mask_ = 0;
+    std::uint64_t last_trade_[MAX_SYMBOLS];
+    Stats stats_;
+
+    static ITCH_FORCE_INLINE std::size_t index(StockLocate locate, std::size_t interval) noexcept {
+        return static_cast<std::size_t>(locate) * MAX_INTERVALS + interval;
+    }
+
+    bool contains(const Bar& bar, std::size_t interval, Timestamp ts) const noexcept {
+        return !bar.empty() && ts >= bar.start && ts < bar.start + intervals_[interval];
+    }
+
+    /// Log sequence `seq` has not been overwritten yet
+    bool retained(std::uint64_t seq) const noexcept {
+        return seq < log_head_ && log_head_ - seq <= log_.size();
+    }
+
+    /// Entries whose trade has left the log are free; `age` is how long ago it was logged
+    std::uint32_t entry_age(const MatchEntry& e) const noexcept {
+        return static_cast<std::uint32_t>(log_head_) - (e.seq_plus_one - 1);
+    }
+    bool entry_live(const MatchEntry& e) const noexcept {
+        return e.seq_plus_one != 0 && entry_age(e) <= log_.size();
+    }
+
+    /**
+     * Match numbers are day-unique and mostly increasing, so their low bits
+     * index the table directly and consecutive trades land in consecutive
+     * slots. Probing is bounded: with no free slot in reach the oldest entry
+     * is overwritten and that trade can no longer be broken (unmatched).
+     */
+    ITCH_FORCE_INLINE void index_trade(std::uint64_t match_number, std::uint64_t seq) noexcept {
+        const std::size_t home = static_cast<std::size_t>(match_number) & match_mask_;
+        MatchEntry* victim = &match_index_[home];
+        for (std::size_t p = 0; p < MATCH_PROBES; ++p) {
+            MatchEntry& e = match_index_[(home + p) & match_mask_];
+            if (!entry_live(e)) {
+                victim = &e;
+                break;
+            }
+            if (entry_age(e) > entry_age(*victim)) victim = &e;
+        }
+        victim->match_low = static_cast<std::uint32_t>(match_number);
+        victim->seq_plus_one = static_cast<std::uint32_t>(seq + 1);
+    }
+
+    TradeRecord* find(StockLocate locate, std::uint64_t match_number) noexcept {
+        const std::size_t home = static_cast<std::size_t>(match_number) & match_mask_;
+        for (std::size_t p = 0; p < MATCH_PROBES; ++p) {
+            const MatchEntry& e = match_index_[(home + p) & match_mask_];
+            if (e.match_low != static_cast<std::uint32_t>(match_number) || !entry_live(e)) continue;
+            TradeRecord& rec = log_[(e.seq_plus_one - 1) & log_mask_];
+            if (rec.match_number == match_number && rec.stock_locate == locate) {
+                return &rec;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Recompute open/high/low/close from the unbroken logged trades inside `bar`
+    void rebuild_ohlc(Bar& bar, std::size_t interval, StockLocate locate) noexcept {
+        const Timestamp end = bar.start + intervals_[interval];
+        if (bar.empty()) {
+            const Timestamp start = bar.start;
+            bar = Bar{};
+            bar.start = start;
+            return;
+        }
+        Bar rebuilt = bar;
+        std::uint64_t seen = 0;
+        // Newest first along the symbol's own chain
+        for (std::uint64_t seq = last_trade_[locate]; seq != NO_TRADE && retained(seq); ) {
+            const TradeRecord& rec = log_[seq & log_mask_];
+            seq = rec.prev_same_locate;
+            if (rec.timestamp < bar.start) break;
+            if (rec.broken || rec.timestamp >= end) continue;
+            if (seen++ == 0) {
+                rebuilt.close = rebuilt.high = rebuilt.low = rec.price;
+            }
+            rebuilt.open = rec.price;
+            rebuilt.high = std::max(rebuilt.high, rec.price);
+            rebuilt.low = std::min(rebuilt.low, rec.price);
+        }
+        if (seen == bar.trade_count) {
+            bar = rebuilt;
+        } else {
+            ++stats_.inexact_breaks;
+        }
+    }
+};
+
+} // namespace itch
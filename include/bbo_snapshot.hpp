@@ -0,0 +1,158 @@
+/**
+ * @file bbo_snapshot.hpp
+ * @brief Seqlock-published top-of-book snapshots for cross-thread readers
+ *
+ * The feed thread is the only writer. Each symbol owns one cache-line slot
+ * guarded by a sequence counter: odd while a write is in progress, even when
+ * stable. Readers never block the writer; they retry if the counter moved
+ * while they copied the fields.
+ *
+ * Features:
+ * - One 64-byte slot per stock locate (no false sharing between symbols)
+ * - Wait-free writer, lock-free readers
+ * - Unchanged BBOs are not republished, so readers' cache lines stay valid
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "order_book.hpp"
+
+#include <atomic>
+#include <memory>
+#include <limits>
+
+namespace itch {
+
+/**
+ * @brief Consistent copy of a symbol's top of book
+ */
+struct BBOSnapshot {
+    BBO bbo;
+    Timestamp timestamp = 0;    // Exchange timestamp of the update that produced it
+    std::uint64_t version = 0;  // Even sequence value; changes on every publish
+};
+
+/**
+ * @brief Single-writer seqlock slot for one symbol
+ *
+ * Fields are atomics accessed with relaxed ordering; the sequence counter
+ * and the fences provide the ordering, the atomics only rule out data races.
+ */
+struct ITCH_CACHE_ALIGNED SeqlockBBOSlot {
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<Price>         bid_price{0};
+    std::atomic<Price>         ask_price{std::numeric_limits<Price>::max()};
+    std::atomic<Timestamp>     timestamp{0};
+    std::atomic<Quantity>      bid_quantity{0};
+    std::atomic<Quantity>      ask_quantity{0};
+
+    /**
+     * @brief Publish a new BBO (writer thread only)
+     */
+    ITCH_FORCE_INLINE void store(const BBO& bbo, Timestamp ts) noexcept {
+        const std::uint64_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        bid_price.store(bbo.bid_price, std::memory_order_relaxed);
+        ask_price.store(bbo.ask_price, std::memory_order_relaxed);
+        bid_quantity.store(bbo.bid_quantity, std::memory_order_relaxed);
+        ask_quantity.store(bbo.ask_quantity, std::memory_order_relaxed);
+        timestamp.store(ts, std::memory_order_relaxed);
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Single read attempt; returns false if it raced with the writer
+     */
+    ITCH_FORCE_INLINE bool try_load(BBOSnapshot& out) const noexcept {
+        const std::uint64_t seq1 = sequence.load(std::memory_order_acquire);
+        if (ITCH_UNLIKELY(seq1 & 1)) {
+            return false;
+        }
+
+        out.bbo.bid_price = bid_price.load(std::memory_order_relaxed);
+        out.bbo.ask_price = ask_price.load(std::memory_order_relaxed);
+        out.bbo.bid_quantity = bid_quantity.load(std::memory_order_relaxed);
+        out.bbo.ask_quantity = ask_quantity.load(std::memory_order_relaxed);
+        out.timestamp = timestamp.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t seq2 = sequence.load(std::memory_order_relaxed);
+        out.version = seq1;
+        return seq1 == seq2;
+    }
+
+    /**
+     * @brief Writer-side check; the writer owns the slot so relaxed loads are exact
+     */
+    ITCH_FORCE_INLINE bool matches(const BBO& bbo) const noexcept {
+        return bid_price.load(std::memory_order_relaxed) == bbo.bid_price &&
+               ask_price.load(std::memory_order_relaxed) == bbo.ask_price &&
+               bid_quantity.load(std::memory_order_relaxed) == bbo.bid_quantity &&
+               ask_quantity.load(std::memory_order_relaxed) == bbo.ask_quantity;
+    }
+};
+
+static_assert(sizeof(SeqlockBBOSlot) == CACHE_LINE_SIZE, "SeqlockBBOSlot must fill one cache line");
+
+/**
+ * @brief Per-locate table of seqlock BBO slots
+ *
+ * publish() must only be called from the feed thread; read()/try_read() may
+ * be called from any number of threads.
+ */
+class BBOPublisher {
+public:
+    static constexpr std::size_t MAX_SYMBOLS = OrderBookManager::MAX_SYMBOLS;
+
+    BBOPublisher() : slots_(new SeqlockBBOSlot[MAX_SYMBOLS]) {}
+
+    BBOPublisher(const BBOPublisher&) = delete;
+    BBOPublisher& operator=(const BBOPublisher&) = delete;
+
+    /**
+     * @brief Publish if the BBO differs from the last published value
+     * @return true if readers will observe a new version
+     */
+    ITCH_FORCE_INLINE bool publish(StockLocate locate, const BBO& bbo, Timestamp ts) noexcept {
+        SeqlockBBOSlot& slot = slots_[locate];
+        if (slot.matches(bbo)) {
+            return false;
+        }
+        slot.store(bbo, ts);
+        return true;
+    }
+
+    ITCH_FORCE_INLINE bool try_read(StockLocate locate, BBOSnapshot& out) const noexcept {
+        return slots_[locate].try_load(out);
+    }
+
+    /**
+     * @brief Spin until a consistent snapshot is obtained
+     */
+    ITCH_FORCE_INLINE BBOSnapshot read(StockLocate locate) const noexcept {
+        BBOSnapshot out;
+        while (!slots_[locate].try_load(out)) {
+            cpu_relax();
+        }
+        return out;
+    }
+
+    /**
+     * @brief Publish an empty book for every symbol (writer thread only)
+     */
+    void clear() noexcept {
+        const BBO empty{};
+        for (std::size_t i = 0; i < MAX_SYMBOLS; ++i) {
+            publish(static_cast<StockLocate>(i), empty, 0);
+        }
+    }
+
+private:
+    std::unique_ptr<SeqlockBBOSlot[]> slots_;
+};
+
+} // namespace itch
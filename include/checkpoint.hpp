@@ -0,0 +1,479 @@
+/**
+ * @file checkpoint.hpp
+ * @brief Binary checkpoint and restore of full feed handler state
+ *
+ * Serialises every live order (FIFO order per level), the symbol directory
+ * and the replay position so an intraday restart can rebuild all books in
+ * one sequential pass instead of replaying the day from byte zero.
+ *
+ * BackgroundCheckpointer takes periodic checkpoints without pausing the
+ * feed thread by forking and serialising the child's copy-on-write image.
+ *
+ * File layout (host-endian, all records naturally aligned):
+ *   CheckpointHeader
+ *   CheckpointSymbol  x symbol_count
+ *   repeated book_count times:
+ *     CheckpointBook
+ *     CheckpointOrder x CheckpointBook::order_count
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "order_book.hpp"
+#include "feed_handler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace itch {
+
+// =============================================================================
+// On-Disk Records
+// =============================================================================
+
+struct CheckpointHeader {
+    char          magic[8];         // "ITCHCKPT"
+    std::uint32_t version;
+    std::uint32_t book_count;
+    std::uint64_t sequence;         // Messages applied when the snapshot was taken
+    std::uint64_t offset;           // Raw ITCH byte offset to resume from
+    std::uint64_t symbol_count;
+    std::uint64_t order_count;
+
+    static constexpr char MAGIC[8] = {'I', 'T', 'C', 'H', 'C', 'K', 'P', 'T'};
+    static constexpr std::uint32_t VERSION = 1;
+};
+static_assert(sizeof(CheckpointHeader) == 48, "CheckpointHeader must be 48 bytes");
+
+struct CheckpointSymbol {
+    char          symbol[8];
+    StockLocate   stock_locate;
+    char          market_category;
+    char          financial_status;
+};
+static_assert(sizeof(CheckpointSymbol) == 12, "CheckpointSymbol must be 12 bytes");
+
+struct CheckpointBook {
+    StockLocate   stock_locate;
+    std::uint16_t reserved;
+    std::uint32_t order_count;
+};
+static_assert(sizeof(CheckpointBook) == 8, "CheckpointBook must be 8 bytes");
+
+struct CheckpointOrder {
+    OrderId       order_id;
+    Timestamp     timestamp;
+    std::uint32_t price;            // ITCH prices are 32-bit on the wire
+    Quantity      quantity;         // Remaining
+    Quantity      original_qty;
+    Side          side;
+    char          padding[3];
+};
+static_assert(sizeof(CheckpointOrder) == 32, "CheckpointOrder must be 32 bytes");
+
+/**
+ * @brief Summary returned by the writer and the loader
+ */
+struct CheckpointInfo {
+    ReplayPosition position;
+    std::uint64_t symbol_count = 0;
+    std::uint64_t order_count = 0;
+    std::uint32_t book_count = 0;
+    std::uint64_t file_bytes = 0;
+};
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+/**
+ * @brief Serialise books, directory and replay position to `path`
+ *
+ * Must run on the feed thread or while it is paused; see
+ * BackgroundCheckpointer for a non-blocking alternative.
+ */
+inline bool save_checkpoint(const FeedHandler& handler, const char* path,
+                            CheckpointInfo* info = nullptr) {
+    BufferedFileWriter out;
+    if (!out.open(path)) {
+        return false;
+    }
+
+    const OrderBookManager& books = handler.book_manager();
+    const SymbolDirectory& directory = handler.symbol_directory();
+
+    CheckpointHeader header{};
+    std::memcpy(header.magic, CheckpointHeader::MAGIC, sizeof(header.magic));
+    header.version = CheckpointHeader::VERSION;
+    header.sequence = handler.position().sequence;
+    header.offset = handler.position().offset;
+    header.symbol_count = directory.symbol_count();
+    books.for_each_book([&](const OrderBook& book) {
+        if (book.order_count() > 0) {
+            ++header.book_count;
+            header.order_count += book.order_count();
+        }
+    });
+    out.write_pod(header);
+
+    directory.for_each([&](StockLocate locate, const SymbolDirectory::SymbolInfo& sym) {
+        CheckpointSymbol rec{};
+        std::memcpy(rec.symbol, sym.symbol.data, 8);
+        rec.stock_locate = locate;
+        rec.market_category = sym.market_category;
+        rec.financial_status = sym.financial_status;
+        out.write_pod(rec);
+    });
+
+    books.for_each_book([&](const OrderBook& book) {
+        if (book.order_count() == 0) return;
+        CheckpointBook rec{};
+        rec.stock_locate = book.stock_locate();
+        rec.order_count = static_cast<std::uint32_t>(book.order_count());
+        out.write_pod(rec);
+
+        book.for_each_order([&](const Order& o) {
+            CheckpointOrder order{};
+            order.order_id = o.order_id;
+            order.timestamp = o.timestamp;
+            order.price = static_cast<std::uint32_t>(o.price);
+            order.quantity = o.quantity;
+            order.original_qty = o.original_qty;
+            order.side = o.side;
+            out.write_pod(order);
+        });
+    });
+
+    const std::uint64_t bytes = out.bytes_written();
+    if (!out.commit()) {
+        return false;
+    }
+    if (info) {
+        info->position = handler.position();
+        info->symbol_count = header.symbol_count;
+        info->order_count = header.order_count;
+        info->book_count = header.book_count;
+        info->file_bytes = bytes;
+    }
+    return true;
+}
+
+// =============================================================================
+// Loader
+// =============================================================================
+
+/**
+ * @brief Replace the handler's state with the checkpoint at `path`
+ *
+ * The order pool and each book's order index are sized from the file
+ * before any order is inserted, so the rebuild never grows structures
+ * incrementally and untouched index capacity is never allocated. Orders
+ * are re-added in file order, which reproduces the original time priority
+ * within every level. On success the handler's position() is the
+ * checkpoint's; resume with process_file(path, offset).
+ *
+ * The whole file is validated before the handler is touched: a file that
+ * fails returns false and leaves the handler's state as it was.
+ */
+inline bool load_checkpoint(FeedHandler& handler, const char* path,
+                            CheckpointInfo* info = nullptr) {
+    MemoryMappedFile file;
+    if (!file.open(path) || file.size() < sizeof(CheckpointHeader)) {
+        return false;
+    }
+
+    const char* cursor = file.data();
+
+    CheckpointHeader header;
+    std::memcpy(&header, cursor, sizeof(header));
+    cursor += sizeof(header);
+    if (std::memcmp(header.magic, CheckpointHeader::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CheckpointHeader::VERSION) {
+        return false;
+    }
+
+    // Bound each count by the file size first so the products cannot overflow
+    const std::uint64_t size = file.size();
+    if (header.symbol_count > size / sizeof(CheckpointSymbol) ||
+        header.book_count > size / sizeof(CheckpointBook) ||
+        header.order_count > size / sizeof(CheckpointOrder)) {
+        return false;
+    }
+    const std::uint64_t expected = sizeof(CheckpointHeader) +
+        header.symbol_count * sizeof(CheckpointSymbol) +
+        header.book_count * sizeof(CheckpointBook) +
+        header.order_count * sizeof(CheckpointOrder);
+    if (expected != size) {
+        return false;
+    }
+
+    // Validate every record before reset(). Stopping once the running order
+    // total exceeds the header's keeps the walk inside the file.
+    {
+        const char* p = cursor;
+        for (std::uint64_t i = 0; i < header.symbol_count; ++i) {
+            CheckpointSymbol rec;
+            std::memcpy(&rec, p, sizeof(rec));
+            p += sizeof(rec);
+            if (rec.stock_locate >= OrderBookManager::MAX_SYMBOLS) {
+                return false;
+            }
+        }
+        std::uint64_t orders = 0;
+        for (std::uint32_t b = 0; b < header.book_count; ++b) {
+            CheckpointBook rec;
+            std::memcpy(&rec, p, sizeof(rec));
+            p += sizeof(rec);
+            orders += rec.order_count;
+            if (rec.stock_locate >= OrderBookManager::MAX_SYMBOLS ||
+                orders > header.order_count) {
+                return false;
+            }
+            p += static_cast<std::size_t>(rec.order_count) * sizeof(CheckpointOrder);
+        }
+        if (orders != header.order_count) {
+            return false;
+        }
+    }
+
+    handler.reset();
+    OrderBookManager& books = handler.book_manager();
+    SymbolDirectory& directory = handler.symbol_directory();
+    directory.clear();
+
+    for (std::uint64_t i = 0; i < header.symbol_count; ++i) {
+        CheckpointSymbol rec;
+        std::memcpy(&rec, cursor, sizeof(rec));
+        cursor += sizeof(rec);
+        directory.add_symbol(rec.stock_locate, rec.symbol, rec.market_category,
+                             rec.financial_status);
+    }
+
+    ObjectPool<Order>& pool = books.order_pool();
+    pool.reserve(static_cast<std::size_t>(header.order_count));
+    Timestamp latest = 0;
+
+    for (std::uint32_t b = 0; b < header.book_count; ++b) {
+        CheckpointBook rec;
+        std::memcpy(&rec, cursor, sizeof(rec));
+        cursor += sizeof(rec);
+
+        OrderBook& book = books.get_book(rec.stock_locate, rec.order_count);
+
+        for (std::uint32_t i = 0; i < rec.order_count; ++i) {
+            CheckpointOrder o;
+            std::memcpy(&o, cursor, sizeof(o));
+            cursor += sizeof(o);
+            Order* order = book.add_order(o.order_id, o.side, static_cast<Price>(o.price),
+                                          o.quantity, o.timestamp, pool);
+            if (ITCH_LIKELY(order != nullptr)) {
+                order->original_qty = o.original_qty;
+            }
+            latest = std::max(latest, o.timestamp);
+        }
+    }
+
+    // reset() cleared the BBO slots and add_order() does not publish
+    handler.republish_bbo(latest);
+    handler.set_position({header.sequence, header.offset});
+
+    if (info) {
+        info->position = handler.position();
+        info->symbol_count = header.symbol_count;
+        info->order_count = header.order_count;
+        info->book_count = header.book_count;
+        info->file_bytes = file.size();
+    }
+    return true;
+}
+
+// =============================================================================
+// Background (Copy-on-Write) Checkpointing
+// =============================================================================
+
+/**
+ * @brief Periodic checkpoints taken from a forked child process
+ *
+ * poll() is called by the feed thread between messages or packets. When the
+ * interval has elapsed it forks: the child inherits a copy-on-write image of
+ * the books exactly as of position().sequence, writes it with
+ * save_checkpoint() and exits, while the parent returns immediately. The
+ * feed thread only pays for fork() itself (page-table copy) and for the
+ * copy-on-write faults on pages it modifies while the child is running.
+ *
+ * Files are named `<prefix>.<sequence>.ckpt`. At most one child runs at a
+ * time; a due checkpoint is skipped if the previous one is still writing.
+ * On Windows there is no fork(), so checkpoints are written synchronously.
+ */
+class BackgroundCheckpointer {
+public:
+    struct Stats {
+        std::uint64_t started = 0;
+        std::uint64_t completed = 0;
+        std::uint64_t failed = 0;
+        std::uint64_t skipped = 0;              // Due while a child was still running
+        std::uint64_t last_sequence = 0;        // Sequence of the last started checkpoint
+        std::uint64_t last_fork_ns = 0;         // Feed-thread stall for the last fork()
+        std::uint64_t max_fork_ns = 0;
+        std::uint64_t last_duration_ns = 0;     // Fork to reap of the last completed child
+        std::uint64_t last_bytes = 0;           // Size of the last completed file
+    };
+
+    BackgroundCheckpointer(std::string path_prefix, std::chrono::milliseconds interval)
+        : prefix_(std::move(path_prefix)), interval_(interval),
+          next_due_(std::chrono::steady_clock::now() + interval) {}
+
+    ~BackgroundCheckpointer() {
+        wait();
+    }
+
+    BackgroundCheckpointer(const BackgroundCheckpointer&) = delete;
+    BackgroundCheckpointer& operator=(const BackgroundCheckpointer&) = delete;
+
+    /**
+     * @brief Start a checkpoint if one is due (feed thread only)
+     * @return true if a checkpoint was started
+     */
+    bool poll(const FeedHandler& handler) {
+        const auto now = std::chrono::steady_clock::now();
+        // Rate-limit waitpid() so a running child costs the feed thread nothing
+        if (ITCH_UNLIKELY(child_running()) && now >= next_reap_) {
+            next_reap_ = now + std::chrono::milliseconds(1);
+            reap(false);
+        }
+        if (ITCH_LIKELY(now < next_due_)) {
+            return false;
+        }
+        next_due_ = now + interval_;
+        if (child_running()) {
+            ++stats_.skipped;
+            return false;
+        }
+        return start(handler);
+    }
+
+    /**
+     * @brief Start a checkpoint immediately unless one is already running
+     */
+    bool checkpoint_now(const FeedHandler& handler) {
+        if (child_running()) {
+            reap(false);
+            if (child_running()) return false;
+        }
+        return start(handler);
+    }
+
+    /**
+     * @brief Block until the running child (if any) has finished
+     */
+    void wait() {
+        if (child_running()) {
+            reap(true);
+        }
+    }
+
+    bool in_progress() const noexcept { return child_running(); }
+    const Stats& stats() const noexcept { return stats_; }
+    const std::string& last_path() const noexcept { return last_path_; }
+
+    std::string path_for(std::uint64_t sequence) const {
+        return prefix_ + "." + std::to_string(sequence) + ".ckpt";
+    }
+
+private:
+    std::string prefix_;
+    std::chrono::milliseconds interval_;
+    std::chrono::steady_clock::time_point next_due_;
+    std::chrono::steady_clock::time_point next_reap_;
+    std::chrono::steady_clock::time_point child_started_;
+    std::string last_path_;
+    Stats stats_;
+#ifndef _WIN32
+    pid_t child_ = -1;
+#endif
+
+    bool child_running() const noexcept {
+#ifndef _WIN32
+        return child_ > 0;
+#else
+        return false;
+#endif
+    }
+
+    static std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point from) {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - from).count());
+    }
+
+    bool start(const FeedHandler& handler) {
+        const std::uint64_t sequence = handler.position().sequence;
+        last_path_ = path_for(sequence);
+        stats_.last_sequence = sequence;
+        ++stats_.started;
+        child_started_ = std::chrono::steady_clock::now();
+
+#ifndef _WIN32
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            // Child: the address space is frozen at `sequence`
+            const bool ok = save_checkpoint(handler, last_path_.c_str());
+            ::_exit(ok ? 0 : 1);
+        }
+        stats_.last_fork_ns = elapsed_ns(child_started_);
+        stats_.max_fork_ns = std::max(stats_.max_fork_ns, stats_.last_fork_ns);
+        if (pid < 0) {
+            ++stats_.failed;
+            return false;
+        }
+        child_ = pid;
+        return true;
+#else
+        CheckpointInfo info;
+        const bool ok = save_checkpoint(handler, last_path_.c_str(), &info);
+        stats_.last_fork_ns = 0;
+        finish(ok, info.file_bytes);
+        return ok;
+#endif
+    }
+
+    void reap(bool block) {
+#ifndef _WIN32
+        int status = 0;
+        const pid_t r = ::waitpid(child_, &status, block ? 0 : WNOHANG);
+        if (r == 0) return; // Still running
+        child_ = -1;
+        const bool ok = r > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        std::uint64_t bytes = 0;
+        struct stat st;
+        if (ok && ::stat(last_path_.c_str(), &st) == 0) {
+            bytes = static_cast<std::uint64_t>(st.st_size);
+        }
+        finish(ok, bytes);
+#else
+        (void)block;
+#endif
+    }
+
+    void finish(bool ok, std::uint64_t bytes) {
+        if (ok) {
+            ++stats_.completed;
+            stats_.last_duration_ns = elapsed_ns(child_started_);
+            stats_.last_bytes = bytes;
+        } else {
+            ++stats_.failed;
+        }
+    }
+};
+
+} // namespace itch
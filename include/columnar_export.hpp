@@ -0,0 +1,553 @@
+/**
+ * @file columnar_export.hpp
+ * @brief Columnar per-message-type export of ITCH days, reader and scan kernels
+ *
+ * ColumnarExporter splits a day into one file per (message type, field):
+ * e.g. E.timestamp.col, E.locate.col, E.shares.col. Each file is a dense,
+ * host-endian array of one fixed-width field, so it can be mmapped and
+ * scanned directly, and a query over executions never touches the bytes
+ * of any other message type or field. A small text manifest records row
+ * counts and the columns present per type.
+ *
+ * Exported: every order and trade message (A, F, E, C, X, D, U, P, Q, B).
+ * Not exported: system, directory, trading status, reg SHO, participant,
+ * MWCB, IPO, LULD, NOII and RPII messages; the manifest's exported count
+ * against its message count shows how many were skipped.
+ *
+ * Export is a single streaming pass with one buffered writer per column, so
+ * memory use is constant regardless of day size.
+ *
+ * Column kernels (count / sum / filter / dot product, optionally restricted
+ * to one stock_locate) use AVX2 when compiled with it (GCC/Clang) and fall
+ * back to scalar loops otherwise.
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "message_types.hpp"
+#include "feed_handler.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#if defined(__AVX2__) && defined(ITCH_GCC_COMPATIBLE)
+#include <immintrin.h>
+#define ITCH_COLUMNAR_AVX2 1
+#endif
+
+namespace itch {
+
+// =============================================================================
+// Column Layout
+// =============================================================================
+
+enum class Column : std::uint8_t {
+    Timestamps = 0,     // std::uint64_t
+    Locates,            // std::uint16_t
+    Refs,               // std::uint64_t (original ref for 'U')
+    NewRefs,            // std::uint64_t
+    Sides,              // char 'B' / 'S'
+    Shares,             // std::uint32_t (executed / cancelled for E, C, X)
+    Prices,             // std::uint32_t (execution price for 'C')
+    Matches,            // std::uint64_t
+    CrossTypes,         // char (Q only)
+    Count
+};
+
+constexpr std::size_t COLUMN_COUNT = static_cast<std::size_t>(Column::Count);
+
+constexpr const char* column_name(Column c) noexcept {
+    constexpr const char* names[] = {
+        "timestamp", "locate", "ref", "new_ref", "side", "shares", "price", "match",
+        "cross_type"
+    };
+    return names[static_cast<std::size_t>(c)];
+}
+
+constexpr std::size_t column_width(Column c) noexcept {
+    constexpr std::size_t widths[] = {8, 2, 8, 8, 1, 4, 4, 8, 1};
+    return widths[static_cast<std::size_t>(c)];
+}
+
+constexpr std::uint32_t column_bit(Column c) noexcept {
+    return 1u << static_cast<unsigned>(c);
+}
+
+/// Message types that are exported, in manifest order
+constexpr std::array<char, 10> COLUMNAR_TYPES = {'A', 'F', 'E', 'C', 'X', 'D', 'U', 'P', 'Q', 'B'};
+
+constexpr int columnar_type_index(char type) noexcept {
+    switch (type) {
+        case 'A': return 0;
+        case 'F': return 1;
+        case 'E': return 2;
+        case 'C': return 3;
+        case 'X': return 4;
+        case 'D': return 5;
+        case 'U': return 6;
+        case 'P': return 7;
+        case 'Q': return 8;
+        case 'B': return 9;
+        default:  return -1;
+    }
+}
+
+/// Bitmask of the columns written for `type`
+constexpr std::uint32_t columnar_columns(char type) noexcept {
+    constexpr std::uint32_t header = column_bit(Column::Timestamps) | column_bit(Column::Locates);
+    constexpr std::uint32_t base = header | column_bit(Column::Refs);
+    switch (type) {
+        case 'A':
+        case 'F': return base | column_bit(Column::Sides) | column_bit(Column::Shares) |
+                         column_bit(Column::Prices);
+        case 'E': return base | column_bit(Column::Shares) | column_bit(Column::Matches);
+        case 'C': return base | column_bit(Column::Shares) | column_bit(Column::Prices) |
+                         column_bit(Column::Matches);
+        case 'X': return base | column_bit(Column::Shares);
+        case 'D': return base;
+        case 'U': return base | column_bit(Column::NewRefs) | column_bit(Column::Shares) |
+                         column_bit(Column::Prices);
+        case 'P': return base | column_bit(Column::Sides) | column_bit(Column::Shares) |
+                         column_bit(Column::Prices) | column_bit(Column::Matches);
+        case 'Q': return header | column_bit(Column::Shares) | column_bit(Column::Prices) |
+                         column_bit(Column::Matches) | column_bit(Column::CrossTypes);
+        case 'B': return header | column_bit(Column::Matches);
+        default:  return 0;
+    }
+}
+
+inline std::string column_file_name(char type, Column c) {
+    return std::string(1, type) + "." + column_name(c) + ".col";
+}
+
+/**
+ * @brief Summary returned by the exporter
+ */
+struct ColumnarExportInfo {
+    std::uint64_t messages = 0;         // Messages read
+    std::uint64_t exported = 0;         // Messages written to columns; the rest are skipped
+    std::uint64_t source_bytes = 0;
+    std::uint64_t file_bytes = 0;       // Total size of all column files
+};
+
+// =============================================================================
+// Exporter
+// =============================================================================
+
+class ColumnarExporter {
+public:
+    static constexpr std::size_t WRITER_BUFFER = 256 * 1024;
+    static constexpr const char* MANIFEST = "manifest.txt";
+    static constexpr int MANIFEST_VERSION = 2;
+
+    /**
+     * @brief Create `dir` if needed and open a writer for every column
+     */
+    bool open(const char* dir) {
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        dir_ = dir;
+        info_ = ColumnarExportInfo{};
+        rows_.fill(0);
+        for (char type : COLUMNAR_TYPES) {
+            const int t = columnar_type_index(type);
+            for (std::size_t c = 0; c < COLUMN_COUNT; ++c) {
+                auto& writer = writers_[static_cast<std::size_t>(t)][c];
+                writer.reset();
+                if (!(columnar_columns(type) & column_bit(static_cast<Column>(c)))) continue;
+                writer = std::make_unique<BufferedFileWriter>(WRITER_BUFFER);
+                const std::string path = dir_ + "/" + column_file_name(type, static_cast<Column>(c));
+                if (!writer->open(path.c_str())) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Append back-to-back raw ITCH messages
+     * @return Bytes consumed (stops at the first unparseable message)
+     */
+    std::size_t process(const char* data, std::size_t len) {
+        std::size_t offset = 0;
+        while (offset < len) {
+            const std::size_t size = get_message_size(data[offset]);
+            if (ITCH_UNLIKELY(size == 0 || len - offset < size)) break;
+            add(data + offset);
+            offset += size;
+        }
+        info_.source_bytes += offset;
+        return offset;
+    }
+
+    /// Append one whole raw ITCH message
+    void add(const char* msg) {
+        ++info_.messages;
+        const char type = msg[0];
+        const int t = columnar_type_index(type);
+        if (t < 0) return;
+
+        const StockLocate locate = endian::be16_to_host(*reinterpret_cast<const std::uint16_t*>(msg + 1));
+        const Timestamp ts = endian::be48_to_host(reinterpret_cast<const std::uint8_t*>(msg + 5));
+        put(t, Column::Timestamps, ts);
+        put(t, Column::Locates, locate);
+
+        switch (type) {
+            case 'A': {
+                const auto& m = *reinterpret_cast<const AddOrderMessage*>(msg);
+                put_order(t, m.order_ref_number, m.buy_sell_indicator, m.shares, m.price);
+                break;
+            }
+            case 'F': {
+                const auto& m = *reinterpret_cast<const AddOrderMPIDMessage*>(msg);
+                put_order(t, m.order_ref_number, m.buy_sell_indicator, m.shares, m.price);
+                break;
+            }
+            case 'E': {
+                const auto& m = *reinterpret_cast<const OrderExecutedMessage*>(msg);
+                put(t, Column::Refs, endian::be64_to_host(m.order_ref_number));
+                put(t, Column::Shares, endian::be32_to_host(m.executed_shares));
+                put(t, Column::Matches, endian::be64_to_host(m.match_number));
+                break;
+            }
+            case 'C': {
+                const auto& m = *reinterpret_cast<const OrderExecutedPriceMessage*>(msg);
+                put(t, Column::Refs, endian::be64_to_host(m.order_ref_number));
+                put(t, Column::Shares, endian::be32_to_host(m.executed_shares));
+                put(t, Column::Prices, endian::be32_to_host(m.execution_price));
+                put(t, Column::Matches, endian::be64_to_host(m.match_number));
+                break;
+            }
+            case 'X': {
+                const auto& m = *reinterpret_cast<const OrderCancelMessage*>(msg);
+                put(t, Column::Refs, endian::be64_to_host(m.order_ref_number));
+                put(t, Column::Shares, endian::be32_to_host(m.cancelled_shares));
+                break;
+            }
+            case 'D': {
+                const auto& m = *reinterpret_cast<const OrderDeleteMessage*>(msg);
+                put(t, Column::Refs, endian::be64_to_host(m.order_ref_number));
+                break;
+            }
+            case 'U': {
+                const auto& m = *reinterpret_cast<const OrderReplaceMessage*>(msg);
+                put(t, Column::Refs, endian::be64_to_host(m.original_order_ref_number));
+                put(t, Column::NewRefs, endian::be64_to_host(m.new_order_ref_number));
+                put(t, Column::Shares, endian::be32_to_host(m.shares));
+                put(t, Column::Prices, endian::be32_to_host(m.price));
+                break;
+            }
+            case 'P': {
+                const auto& m = *reinterpret_cast<const TradeMessage*>(msg);
+                put_order(t, m.order_ref_number, m.buy_sell_indicator, m.shares, m.price);
+                put(t, Column::Matches, endian::be64_to_host(m.match_number));
+                break;
+            }
+            case 'Q': {
+                // 64-bit on the wire; narrowed like the feed handler's trade path
+                const auto& m = *reinterpret_cast<const CrossTradeMessage*>(msg);
+                put(t, Column::Shares, static_cast<std::uint32_t>(endian::be64_to_host(m.shares)));
+                put(t, Column::Prices, endian::be32_to_host(m.cross_price));
+                put(t, Column::Matches, endian::be64_to_host(m.match_number));
+                put(t, Column::CrossTypes, m.cross_type);
+                break;
+            }
+            case 'B': {
+                const auto& m = *reinterpret_cast<const BrokenTradeMessage*>(msg);
+                put(t, Column::Matches, endian::be64_to_host(m.match_number));
+                break;
+            }
+            default:
+                break;
+        }
+        ++rows_[static_cast<std::size_t>(t)];
+        ++info_.exported;
+    }
+
+    /**
+     * @brief Commit every column file and write the manifest
+     */
+    bool finish(ColumnarExportInfo* info = nullptr) {
+        bool ok = true;
+        for (auto& type_writers : writers_) {
+            for (auto& writer : type_writers) {
+                if (!writer) continue;
+                info_.file_bytes += writer->bytes_written();
+                ok = writer->commit() && ok;
+                writer.reset();
+            }
+        }
+
+        std::ofstream manifest(dir_ + "/" + MANIFEST);
+        manifest << "itch-columnar " << MANIFEST_VERSION << "\n"
+                 << "messages " << info_.messages << "\n"
+                 << "exported " << info_.exported << "\n"
+                 << "source_bytes " << info_.source_bytes << "\n";
+        for (char type : COLUMNAR_TYPES) {
+            manifest << type << ' ' << rows_[static_cast<std::size_t>(columnar_type_index(type))];
+            for (std::size_t c = 0; c < COLUMN_COUNT; ++c) {
+                if (columnar_columns(type) & column_bit(static_cast<Column>(c))) {
+                    manifest << ' ' << column_name(static_cast<Column>(c));
+                }
+            }
+            manifest << '\n';
+        }
+        ok = ok && static_cast<bool>(manifest);
+        if (info) *info = info_;
+        return ok;
+    }
+
+private:
+    std::string dir_;
+    std::array<std::array<std::unique_ptr<BufferedFileWriter>, COLUMN_COUNT>,
+               COLUMNAR_TYPES.size()> writers_;
+    std::array<std::uint64_t, COLUMNAR_TYPES.size()> rows_{};
+    ColumnarExportInfo info_;
+
+    template<typename T>
+    ITCH_FORCE_INLINE void put(int t, Column c, T value) {
+        writers_[static_cast<std::size_t>(t)][static_cast<std::size_t>(c)]->write_pod(value);
+    }
+
+    ITCH_FORCE_INLINE void put_order(int t, std::uint64_t be_ref, char side,
+                                     std::uint32_t be_shares, std::uint32_t be_price) {
+        put(t, Column::Refs, endian::be64_to_host(be_ref));
+        put(t, Column::Sides, side);
+        put(t, Column::Shares, endian::be32_to_host(be_shares));
+        put(t, Column::Prices, endian::be32_to_host(be_price));
+    }
+};
+
+/**
+ * @brief Export a raw ITCH file to `dir` in one streaming pass
+ */
+inline bool export_columnar_file(const char* itch_path, const char* dir,
+                                 ColumnarExportInfo* info = nullptr) {
+    MemoryMappedFile file;
+    ColumnarExporter exporter;
+    if (!file.open(itch_path) || !exporter.open(dir)) {
+        return false;
+    }
+    exporter.process(file.data(), file.size());
+    return exporter.finish(info);
+}
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+class ColumnarDay {
+public:
+    /**
+     * @brief Read the manifest in `dir` and mmap every non-empty column
+     */
+    bool open(const char* dir) {
+        std::ifstream manifest(std::string(dir) + "/" + ColumnarExporter::MANIFEST);
+        std::string magic;
+        int version = 0;
+        if (!(manifest >> magic >> version) || magic != "itch-columnar" ||
+            version != ColumnarExporter::MANIFEST_VERSION) {
+            return false;
+        }
+        std::string key;
+        manifest >> key >> messages_ >> key >> exported_ >> key >> source_bytes_;
+        rows_.fill(0);
+
+        std::string line;
+        std::getline(manifest, line);
+        while (std::getline(manifest, line)) {
+            if (line.size() < 3) continue;
+            const int t = columnar_type_index(line[0]);
+            if (t < 0) return false;
+            rows_[static_cast<std::size_t>(t)] = std::strtoull(line.c_str() + 2, nullptr, 10);
+        }
+
+        for (char type : COLUMNAR_TYPES) {
+            const auto t = static_cast<std::size_t>(columnar_type_index(type));
+            for (std::size_t c = 0; c < COLUMN_COUNT; ++c) {
+                const Column col = static_cast<Column>(c);
+                files_[t][c].close();
+                if (rows_[t] == 0 || !(columnar_columns(type) & column_bit(col))) continue;
+                const std::string path = std::string(dir) + "/" + column_file_name(type, col);
+                if (!files_[t][c].open(path.c_str()) ||
+                    files_[t][c].size() != rows_[t] * column_width(col)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::size_t rows(char type) const noexcept {
+        const int t = columnar_type_index(type);
+        return t < 0 ? 0 : static_cast<std::size_t>(rows_[static_cast<std::size_t>(t)]);
+    }
+
+    std::uint64_t messages() const noexcept { return messages_; }
+    std::uint64_t exported() const noexcept { return exported_; }
+    std::uint64_t source_bytes() const noexcept { return source_bytes_; }
+
+    const std::uint64_t* timestamps(char type) const noexcept { return column<std::uint64_t>(type, Column::Timestamps); }
+    const std::uint16_t* locates(char type) const noexcept { return column<std::uint16_t>(type, Column::Locates); }
+    const std::uint64_t* refs(char type) const noexcept { return column<std::uint64_t>(type, Column::Refs); }
+    const std::uint64_t* new_refs(char type) const noexcept { return column<std::uint64_t>(type, Column::NewRefs); }
+    const char* sides(char type) const noexcept { return column<char>(type, Column::Sides); }
+    const std::uint32_t* shares(char type) const noexcept { return column<std::uint32_t>(type, Column::Shares); }
+    const std::uint32_t* prices(char type) const noexcept { return column<std::uint32_t>(type, Column::Prices); }
+    const std::uint64_t* matches(char type) const noexcept { return column<std::uint64_t>(type, Column::Matches); }
+    const char* cross_types(char type) const noexcept { return column<char>(type, Column::CrossTypes); }
+
+private:
+    std::array<std::array<MemoryMappedFile, COLUMN_COUNT>, COLUMNAR_TYPES.size()> files_;
+    std::array<std::uint64_t, COLUMNAR_TYPES.size()> rows_{};
+    std::uint64_t messages_ = 0;
+    std::uint64_t exported_ = 0;
+    std::uint64_t source_bytes_ = 0;
+
+    /// nullptr when the type has no rows or does not carry the column
+    template<typename T>
+    const T* column(char type, Column c) const noexcept {
+        const int t = columnar_type_index(type);
+        if (t < 0) return nullptr;
+        return reinterpret_cast<const T*>(
+            files_[static_cast<std::size_t>(t)][static_cast<std::size_t>(c)].data());
+    }
+};
+
+// =============================================================================
+// Column Kernels
+// =============================================================================
+
+namespace columnar {
+
+/**
+ * @brief [first, last) row range of a non-decreasing timestamp column within [from, to]
+ */
+inline std::pair<std::size_t, std::size_t> time_range(const std::uint64_t* ts, std::size_t n,
+                                                      Timestamp from, Timestamp to) noexcept {
+    const std::uint64_t* first = std::lower_bound(ts, ts + n, from);
+    const std::uint64_t* last = std::upper_bound(first, ts + n, to);
+    return {static_cast<std::size_t>(first - ts), static_cast<std::size_t>(last - ts)};
+}
+
+/// Rows where keys[i] == key
+inline std::size_t count_equal(const std::uint16_t* keys, std::size_t n, std::uint16_t key) noexcept {
+    std::size_t count = 0;
+    std::size_t i = 0;
+#if defined(ITCH_COLUMNAR_AVX2)
+    const __m256i k = _mm256_set1_epi16(static_cast<short>(key));
+    for (; i + 16 <= n; i += 16) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(v, k)));
+        count += static_cast<std::size_t>(__builtin_popcount(mask)) / 2;
+    }
+#endif
+    for (; i < n; ++i) count += keys[i] == key;
+    return count;
+}
+
+/// Sum of a 32-bit column
+inline std::uint64_t sum(const std::uint32_t* values, std::size_t n) noexcept {
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+#if defined(ITCH_COLUMNAR_AVX2)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; ++i) total += values[i];
+    return total;
+}
+
+/// Sum of values[i] over rows where keys[i] == key
+inline std::uint64_t sum_where_equal(const std::uint32_t* values, const std::uint16_t* keys,
+                                     std::size_t n, std::uint16_t key) noexcept {
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+#if defined(ITCH_COLUMNAR_AVX2)
+    const __m128i k = _mm_set1_epi16(static_cast<short>(key));
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 8 <= n; i += 8) {
+        const __m128i kv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+        const __m256i mask = _mm256_cvtepi16_epi32(_mm_cmpeq_epi16(kv, k));
+        const __m256i v = _mm256_and_si256(mask,
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; ++i) total += keys[i] == key ? values[i] : 0;
+    return total;
+}
+
+/// Sum of a[i] * b[i] over rows where keys[i] == key (e.g. notional = price * shares)
+inline std::uint64_t dot_where_equal(const std::uint32_t* a, const std::uint32_t* b,
+                                     const std::uint16_t* keys, std::size_t n,
+                                     std::uint16_t key) noexcept {
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+#if defined(ITCH_COLUMNAR_AVX2)
+    const __m128i k = _mm_set1_epi16(static_cast<short>(key));
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        const __m128i kv = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(keys + i));
+        const __m256i mask = _mm256_cvtepi16_epi64(_mm_cmpeq_epi16(kv, k));
+        const __m256i av = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        const __m256i bv = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        acc = _mm256_add_epi64(acc, _mm256_and_si256(mask, _mm256_mul_epu32(av, bv)));
+    }
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < n; ++i) {
+        total += keys[i] == key ? static_cast<std::uint64_t>(a[i]) * b[i] : 0;
+    }
+    return total;
+}
+
+/**
+ * @brief Write the row numbers where keys[i] == key to `out` (selection vector)
+ * @return Rows selected; `out` must have room for n entries
+ */
+inline std::size_t filter_equal(const std::uint16_t* keys, std::size_t n, std::uint16_t key,
+                                std::uint32_t* out) noexcept {
+    std::size_t count = 0;
+    std::size_t i = 0;
+#if defined(ITCH_COLUMNAR_AVX2)
+    const __m256i k = _mm256_set1_epi16(static_cast<short>(key));
+    for (; i + 16 <= n; i += 16) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(v, k)));
+        while (mask) {
+            const unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            out[count++] = static_cast<std::uint32_t>(i + bit / 2);
+            mask &= mask - 1;
+            mask &= mask - 1;       // Each 16-bit lane sets two mask bits
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (keys[i] == key) out[count++] = static_cast<std::uint32_t>(i);
+    }
+    return count;
+}
+
+} // namespace columnar
+
+} // namespace itch
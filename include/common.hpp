@@ -304,6 +304,46 @@ ITCH_FORCE_INLINE void prefetch_write(void* ptr) noexcept {
 #endif
 }
 
+// =============================================================================
+// Page Prefaulting
+// =============================================================================
+
+/**
+ * @brief Fault in every page of [ptr, ptr + bytes) without changing it
+ *
+ * One byte per page is read and written back through a volatile pointer, so
+ * lazily backed memory (calloc, fresh mmap, reserved vector capacity) gets
+ * its page-table entries and a private page before the hot path writes it.
+ * Live data in the range is left as is (single writer only).
+ */
+inline void prefault_pages(void* ptr, std::size_t bytes) noexcept {
+    constexpr std::size_t STRIDE = 4096;
+    volatile char* p = static_cast<volatile char*>(ptr);
+    for (std::size_t i = 0; i < bytes; i += STRIDE) {
+        p[i] = p[i];
+    }
+    if (bytes != 0) {
+        p[bytes - 1] = p[bytes - 1];
+    }
+}
+
+// =============================================================================
+// Spin-Wait Hint
+// =============================================================================
+
+/**
+ * @brief Tell the CPU we are in a spin loop (reduces power and SMT contention)
+ */
+ITCH_FORCE_INLINE void cpu_relax() noexcept {
+#if defined(ITCH_MSVC)
+    _mm_pause();
+#elif defined(ITCH_GCC_COMPATIBLE) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif defined(ITCH_GCC_COMPATIBLE) && defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
 // =============================================================================
 // Symbol Hash Function
 // =============================================================================
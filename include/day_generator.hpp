@@ -0,0 +1,797 @@
+/**
+ * @file day_generator.hpp
+ * @brief Synthetic full-day ITCH 5.0 session generator
+ *
+ * Produces a coherent trading day rather than an unrelated message mix:
+ * - start of messages, a stock directory and trading state for every symbol,
+ *   then the system-hours, market-hours and end-of-messages events
+ * - Zipf-distributed activity across thousands of symbols (Vose alias table
+ *   over activity ranks, ranks shuffled across locates)
+ * - order flow in which every execute, cancel, delete and replace refers to a
+ *   live order with enough shares left; most follow-ups hit one of the newest
+ *   orders of the symbol, giving short typical lifetimes with a long tail
+ * - a U-shaped intraday profile: thin pre-market, a burst after the 09:30
+ *   open that decays, and a build-up into the 16:00 close
+ * - NOII rounds ahead of the opening and closing crosses, the crosses, and
+ *   LULD halts that resume through a halt cross five minutes later
+ *
+ * Output is BinaryFILE framed (each message preceded by its 2-byte
+ * big-endian length, as in NASDAQ's historical files) or back-to-back raw
+ * ITCH for FeedHandler::process(). The sink receives the day in chunks of
+ * CHUNK_SIZE bytes, so multi-GB days never sit in memory.
+ *
+ * The same config and seed always produce the same bytes.
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "message_types.hpp"
+#include "feed_handler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace itch {
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+/**
+ * @brief Relative weights of the continuous order flow
+ *
+ * The defaults follow the shape of a NASDAQ day: adds and deletes dominate,
+ * replaces are the next largest, executions and hidden trades are rare.
+ */
+struct DayMix {
+    std::uint32_t add = 44;
+    std::uint32_t execute = 4;      // 'E', with a small share of 'C'
+    std::uint32_t cancel = 3;       // Partial cancels ('X')
+    std::uint32_t del = 40;
+    std::uint32_t replace = 8;
+    std::uint32_t trade = 1;        // Non-displayed executions ('P')
+};
+
+struct DayGeneratorConfig {
+    std::uint64_t seed = 42;
+    std::size_t symbols = 8000;             // Locates 1..symbols
+    double zipf_exponent = 1.1;             // Activity of the rank-k symbol ~ 1/k^s
+    std::uint64_t messages = 100000000;     // Continuous flow; session messages come on top
+    DayMix mix;
+    std::size_t halts = 4;                  // LULD halts between 10:00 and 15:00
+    double noii_fraction = 0.1;             // Most active symbols that publish NOII
+    double recent_fraction = 0.8;           // Follow-ups aimed at the 16 newest orders
+    std::size_t max_live_per_symbol = 2000; // Adds past this become deletes
+    bool binary_file = true;                // Length-prefixed (BinaryFILE) vs. raw
+};
+
+struct DayGeneratorStats {
+    std::uint64_t messages = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t live_orders = 0;          // Still resting at the end of the day
+    std::uint64_t by_type[128] = {};
+
+    std::uint64_t count(char type) const noexcept {
+        return by_type[static_cast<unsigned char>(type) & 127];
+    }
+};
+
+namespace detail {
+
+/// splitmix64: one multiply-xorshift round per draw, plenty for synthetic data
+class DayRng {
+public:
+    explicit DayRng(std::uint64_t seed = 0) noexcept : state_(seed) {}
+
+    std::uint64_t next() noexcept {
+        std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /// Uniform in [0, n) from 32 random bits (Lemire's multiply-shift)
+    static std::uint32_t bounded(std::uint32_t bits, std::uint32_t n) noexcept {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(bits) * n) >> 32);
+    }
+
+    std::uint32_t below(std::uint32_t n) noexcept {
+        return bounded(static_cast<std::uint32_t>(next() >> 32), n);
+    }
+
+    double uniform() noexcept {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+} // namespace detail
+
+// =============================================================================
+// Day Generator
+// =============================================================================
+
+class DayGenerator {
+public:
+    static constexpr std::size_t CHUNK_SIZE = 4u << 20;
+
+    explicit DayGenerator(const DayGeneratorConfig& config = DayGeneratorConfig{})
+        : config_(config) {
+        const std::size_t max_symbols = OrderBookManager::MAX_SYMBOLS - 1;
+        config_.symbols = std::max<std::size_t>(1, std::min(config_.symbols, max_symbols));
+        config_.halts = std::min(config_.halts, config_.symbols / 2);
+        config_.max_live_per_symbol = std::max<std::size_t>(1, config_.max_live_per_symbol);
+    }
+
+    DayGenerator(const DayGenerator&) = delete;
+    DayGenerator& operator=(const DayGenerator&) = delete;
+
+    /**
+     * @brief Generate the whole day, handing it to sink(const char*, std::size_t)
+     */
+    template<typename Sink>
+    const DayGeneratorStats& generate(Sink&& sink) {
+        using SinkType = std::remove_reference_t<Sink>;
+        sink_context_ = const_cast<void*>(static_cast<const void*>(std::addressof(sink)));
+        sink_ = [](void* context, const char* data, std::size_t len) {
+            (*static_cast<SinkType*>(context))(data, len);
+        };
+        run();
+        sink_ = nullptr;
+        sink_context_ = nullptr;
+        return stats_;
+    }
+
+    /**
+     * @brief Generate the day into `path` (written to a temporary, then renamed)
+     */
+    bool write_file(const char* path) {
+        BufferedFileWriter out;
+        if (!out.open(path)) {
+            return false;
+        }
+        generate([&](const char* data, std::size_t len) { out.write(data, len); });
+        return out.commit();
+    }
+
+    const DayGeneratorStats& stats() const noexcept { return stats_; }
+    const DayGeneratorConfig& config() const noexcept { return config_; }
+
+    /// Space-padded 8-byte ticker of a locate (valid after generate())
+    const char* symbol(StockLocate locate) const noexcept { return symbols_[locate].name; }
+
+private:
+    // Session clock, in seconds after midnight
+    static constexpr std::uint32_t PREAMBLE     = 3 * 3600;
+    static constexpr std::uint32_t SYSTEM_OPEN  = 4 * 3600;
+    static constexpr std::uint32_t PRE_OPEN     = 8 * 3600;
+    static constexpr std::uint32_t MARKET_OPEN  = 9 * 3600 + 30 * 60;
+    static constexpr std::uint32_t MARKET_CLOSE = 16 * 3600;
+    static constexpr std::uint32_t SYSTEM_CLOSE = 20 * 3600;
+    static constexpr std::uint32_t HALT_SECONDS = 300;
+    static constexpr Timestamp NS = 1000000000ull;
+
+    static constexpr Price TICK = 100;                 // $0.01
+    static constexpr std::size_t RECENT = 16;
+    static constexpr std::size_t ACTION_TABLE = 1024;
+
+    enum Action : std::uint8_t { ADD, EXECUTE, CANCEL, DELETE, REPLACE, TRADE };
+
+    enum EventKind : std::uint8_t {
+        SYSTEM_EVENT,   // arg: event code
+        NOII_ROUND,     // arg: cross type, for every NOII symbol
+        CROSS_ROUND,    // arg: cross type, for every symbol
+        HALT,
+        HALT_NOII,
+        HALT_RESUME,    // Halt cross, then back to trading
+    };
+
+    struct Event {
+        std::uint32_t second;
+        EventKind kind;
+        char arg;
+        StockLocate locate;
+    };
+
+    struct LiveOrder {
+        OrderId id;
+        std::uint32_t price;
+        Quantity shares;
+        Side side;
+    };
+
+    struct SymbolState {
+        std::vector<LiveOrder> live;
+        std::uint32_t mid = 0;
+        char name[8];
+    };
+
+    struct AliasSlot {
+        std::uint16_t threshold;    // Keep this locate if the low 16 bits are below
+        StockLocate alias;
+    };
+
+    // -------------------------------------------------------------------------
+    // Set-up
+    // -------------------------------------------------------------------------
+
+    void begin() {
+        rng_ = detail::DayRng(config_.seed);
+        stats_ = DayGeneratorStats{};
+        buffer_.resize(CHUNK_SIZE + 256);
+        pos_ = 0;
+        ts_ = 0;
+        next_order_id_ = 1;
+        next_match_ = 1;
+
+        const std::size_t n = config_.symbols;
+        symbols_.assign(n + 1, SymbolState{});
+        halted_.assign(n + 1, false);
+        halted_count_ = 0;
+        for (std::size_t locate = 1; locate <= n; ++locate) {
+            SymbolState& s = symbols_[locate];
+            std::memset(s.name, ' ', sizeof(s.name));
+            std::size_t v = locate - 1;
+            for (int i = 3; i >= 0; --i) {
+                s.name[i] = static_cast<char>('A' + v % 26);
+                v /= 26;
+            }
+            // Log-uniform reference price between $2 and $500, on a cent
+            const double dollars = std::exp(std::log(2.0) + rng_.uniform() * std::log(250.0));
+            s.mid = static_cast<std::uint32_t>(std::max(2.0, std::round(dollars * 100.0))) * 100u;
+            s.live.reserve(64);
+        }
+
+        // Activity rank -> locate, shuffled so hot names are spread out
+        std::vector<StockLocate> by_rank(n);
+        for (std::size_t i = 0; i < n; ++i) by_rank[i] = static_cast<StockLocate>(i + 1);
+        for (std::size_t i = n; i > 1; --i) {
+            std::swap(by_rank[i - 1], by_rank[rng_.below(static_cast<std::uint32_t>(i))]);
+        }
+        build_alias_table(by_rank);
+
+        const std::size_t noii = std::min(n, static_cast<std::size_t>(
+            std::ceil(static_cast<double>(n) * std::max(0.0, config_.noii_fraction))));
+        noii_symbols_.assign(by_rank.begin(), by_rank.begin() + static_cast<std::ptrdiff_t>(noii));
+
+        build_action_table();
+        build_schedule();
+        build_volume_profile();
+    }
+
+    /// Vose's alias method over Zipf weights: one draw, one compare per pick
+    void build_alias_table(const std::vector<StockLocate>& by_rank) {
+        const std::size_t n = by_rank.size();
+        std::vector<double> scaled(n);      // Indexed by locate - 1
+        double total = 0;
+        for (std::size_t k = 0; k < n; ++k) {
+            const double weight = 1.0 / std::pow(static_cast<double>(k + 1), config_.zipf_exponent);
+            scaled[by_rank[k] - 1u] = weight;
+            total += weight;
+        }
+        std::vector<std::size_t> small, large;
+        for (std::size_t i = 0; i < n; ++i) {
+            scaled[i] *= static_cast<double>(n) / total;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+        alias_.assign(n, AliasSlot{0xFFFF, 0});
+        while (!small.empty() && !large.empty()) {
+            const std::size_t lo = small.back(); small.pop_back();
+            const std::size_t hi = large.back();
+            alias_[lo].threshold = static_cast<std::uint16_t>(scaled[lo] * 65535.0);
+            alias_[lo].alias = static_cast<StockLocate>(hi + 1);
+            scaled[hi] -= 1.0 - scaled[lo];
+            if (scaled[hi] < 1.0) {
+                large.pop_back();
+                small.push_back(hi);
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if (alias_[i].threshold == 0xFFFF) alias_[i].alias = static_cast<StockLocate>(i + 1);
+        }
+    }
+
+    void build_action_table() {
+        const DayMix& m = config_.mix;
+        const std::uint32_t weights[] = {m.add, m.execute, m.cancel, m.del, m.replace, m.trade};
+        std::uint64_t total = 0;
+        for (const std::uint32_t w : weights) total += w;
+        if (total == 0) {
+            std::fill(actions_, actions_ + ACTION_TABLE, ADD);
+            return;
+        }
+        std::size_t slot = 0;
+        std::uint64_t cumulative = 0;
+        for (std::size_t a = 0; a < 6; ++a) {
+            cumulative += weights[a];
+            const std::size_t end = static_cast<std::size_t>(cumulative * ACTION_TABLE / total);
+            for (; slot < end; ++slot) actions_[slot] = static_cast<Action>(a);
+        }
+    }
+
+    void build_schedule() {
+        events_.clear();
+        events_.push_back({SYSTEM_OPEN, SYSTEM_EVENT, SystemEventMessage::EVENT_START_SYSTEM_HOURS, 0});
+
+        // NOII every 10 s from five minutes before each cross, every second for the last two (open) / five (close)
+        for (std::uint32_t t = MARKET_OPEN - 300; t < MARKET_OPEN; t += t < MARKET_OPEN - 120 ? 10 : 1) {
+            events_.push_back({t, NOII_ROUND, 'O', 0});
+        }
+        events_.push_back({MARKET_OPEN, SYSTEM_EVENT, SystemEventMessage::EVENT_START_MARKET_HOURS, 0});
+        events_.push_back({MARKET_OPEN, CROSS_ROUND, 'O', 0});
+        for (std::uint32_t t = MARKET_CLOSE - 600; t < MARKET_CLOSE; t += t < MARKET_CLOSE - 300 ? 10 : 1) {
+            events_.push_back({t, NOII_ROUND, 'C', 0});
+        }
+        events_.push_back({MARKET_CLOSE, CROSS_ROUND, 'C', 0});
+        events_.push_back({MARKET_CLOSE, SYSTEM_EVENT, SystemEventMessage::EVENT_END_MARKET_HOURS, 0});
+        events_.push_back({SYSTEM_CLOSE, SYSTEM_EVENT, SystemEventMessage::EVENT_END_SYSTEM_HOURS, 0});
+
+        // LULD halts on distinct symbols between 10:00 and 15:00
+        std::vector<StockLocate> halted;
+        while (halted.size() < config_.halts) {
+            const StockLocate locate = static_cast<StockLocate>(
+                1 + rng_.below(static_cast<std::uint32_t>(config_.symbols)));
+            if (std::find(halted.begin(), halted.end(), locate) != halted.end()) continue;
+            halted.push_back(locate);
+            const std::uint32_t t = 10 * 3600 + rng_.below(5 * 3600);
+            events_.push_back({t, HALT, 'H', locate});
+            for (std::uint32_t k = 5; k > 0; --k) {
+                events_.push_back({t + HALT_SECONDS - k, HALT_NOII, 'H', locate});
+            }
+            events_.push_back({t + HALT_SECONDS, HALT_RESUME, 'H', locate});
+        }
+        std::stable_sort(events_.begin(), events_.end(),
+                         [](const Event& a, const Event& b) { return a.second < b.second; });
+    }
+
+    /// Relative flow per second: thin pre/post-market, a U over regular hours
+    static double activity(std::uint32_t t) {
+        if (t < PRE_OPEN) return 0.02;
+        if (t < MARKET_OPEN) return 0.08;
+        if (t >= MARKET_CLOSE) {
+            return 0.01 + 0.1 * std::exp(-static_cast<double>(t - MARKET_CLOSE) / 600.0);
+        }
+        const double since_open = static_cast<double>(t - MARKET_OPEN);
+        const double to_close = static_cast<double>(MARKET_CLOSE - t);
+        return 1.0 + 5.0 * std::exp(-since_open / 900.0) + 3.0 * std::exp(-to_close / 1200.0);
+    }
+
+    /// Split config_.messages over the seconds of the session in proportion to activity()
+    void build_volume_profile() {
+        const std::size_t seconds = SYSTEM_CLOSE - SYSTEM_OPEN;
+        std::vector<double> weight(seconds);
+        double total = 0;
+        for (std::size_t i = 0; i < seconds; ++i) {
+            weight[i] = activity(static_cast<std::uint32_t>(SYSTEM_OPEN + i));
+            total += weight[i];
+        }
+        volume_.assign(seconds, 0);
+        double cumulative = 0;
+        std::uint64_t assigned = 0;
+        for (std::size_t i = 0; i < seconds; ++i) {
+            cumulative += weight[i];
+            const std::uint64_t upto = i + 1 == seconds ? config_.messages
+                : static_cast<std::uint64_t>(cumulative / total * static_cast<double>(config_.messages));
+            volume_[i] = static_cast<std::uint32_t>(upto - assigned);
+            assigned = upto;
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Day
+    // -------------------------------------------------------------------------
+
+    void run() {
+        begin();
+
+        // Start of day: directory and trading state for every symbol
+        ts_ = PREAMBLE * NS;
+        system_event(SystemEventMessage::EVENT_START_OF_MESSAGES);
+        for (std::size_t locate = 1; locate < symbols_.size(); ++locate) {
+            stock_directory(static_cast<StockLocate>(locate));
+            tick();
+            trading_action(static_cast<StockLocate>(locate), StockTradingActionMessage::STATE_TRADING, "    ");
+            tick();
+        }
+
+        std::size_t next_event = 0;
+        for (std::uint32_t t = SYSTEM_OPEN; t < SYSTEM_CLOSE; ++t) {
+            const Timestamp second = t * NS;
+            ts_ = std::max(ts_ + 1, second);
+            while (next_event < events_.size() && events_[next_event].second == t) {
+                dispatch(events_[next_event++]);
+            }
+            const std::uint32_t n = volume_[t - SYSTEM_OPEN];
+            const Timestamp step = NS / (n + 1);
+            for (std::uint32_t k = 1; k <= n; ++k) {
+                ts_ = std::max(ts_ + 1, second + k * step);
+                flow();
+            }
+        }
+        ts_ = std::max(ts_ + 1, SYSTEM_CLOSE * NS);
+        while (next_event < events_.size()) dispatch(events_[next_event++]);
+        ts_ = std::max(ts_ + 1, (SYSTEM_CLOSE + 300) * NS);
+        system_event(SystemEventMessage::EVENT_END_OF_MESSAGES);
+        flush();
+
+        for (const SymbolState& s : symbols_) stats_.live_orders += s.live.size();
+    }
+
+    void dispatch(const Event& e) {
+        switch (e.kind) {
+            case SYSTEM_EVENT:
+                system_event(e.arg);
+                break;
+            case NOII_ROUND:
+                for (const StockLocate locate : noii_symbols_) {
+                    noii(locate, e.arg);
+                    tick();
+                }
+                break;
+            case CROSS_ROUND:
+                for (std::size_t locate = 1; locate < symbols_.size(); ++locate) {
+                    cross(static_cast<StockLocate>(locate), e.arg);
+                    tick();
+                }
+                break;
+            case HALT:
+                halted_[e.locate] = true;
+                ++halted_count_;
+                trading_action(e.locate, StockTradingActionMessage::STATE_HALTED, "LUDP");
+                break;
+            case HALT_NOII:
+                noii(e.locate, e.arg);
+                break;
+            case HALT_RESUME:
+                cross(e.locate, e.arg);
+                tick();
+                trading_action(e.locate, StockTradingActionMessage::STATE_TRADING, "LUDP");
+                halted_[e.locate] = false;
+                --halted_count_;
+                break;
+        }
+        tick();
+    }
+
+    void tick() noexcept { ++ts_; }
+
+    StockLocate draw_symbol() noexcept {
+        const std::uint64_t r = rng_.next();
+        const std::uint32_t index = detail::DayRng::bounded(
+            static_cast<std::uint32_t>(r >> 32), static_cast<std::uint32_t>(alias_.size()));
+        const AliasSlot slot = alias_[index];
+        return (r & 0xFFFF) < slot.threshold ? static_cast<StockLocate>(index + 1) : slot.alias;
+    }
+
+    /// Mostly one of the newest orders, otherwise any live order
+    std::size_t pick_order(const SymbolState& s, std::uint64_t r) const noexcept {
+        const std::size_t n = s.live.size();
+        const std::uint32_t recent = static_cast<std::uint32_t>(config_.recent_fraction * 65536.0);
+        if (n > RECENT && (r & 0xFFFF) < recent) {
+            return n - 1 - ((r >> 16) & (RECENT - 1));
+        }
+        return detail::DayRng::bounded(static_cast<std::uint32_t>(r >> 32), static_cast<std::uint32_t>(n));
+    }
+
+    static void remove_order(SymbolState& s, std::size_t index) noexcept {
+        s.live[index] = s.live.back();
+        s.live.pop_back();
+    }
+
+    /// Price `levels` ticks behind the touch on `side`, skewed towards the inside
+    static std::uint32_t passive_price(const SymbolState& s, Side side, std::uint64_t r) noexcept {
+        const std::uint32_t levels = 1 + static_cast<std::uint32_t>(((r & 0xFF) * ((r >> 8) & 0xFF)) >> 12);
+        const std::uint32_t offset = levels * static_cast<std::uint32_t>(TICK);
+        if (side == Side::Sell) return s.mid + offset;
+        return s.mid > offset + TICK ? s.mid - offset : static_cast<std::uint32_t>(TICK);
+    }
+
+    static Quantity order_shares(std::uint32_t bits) noexcept {
+        if ((bits & 7) == 0) return 1 + detail::DayRng::bounded(bits, 99);  // Odd lot
+        return 100 * (1 + detail::DayRng::bounded(bits, 10));
+    }
+
+    void flow() {
+        StockLocate locate = draw_symbol();
+        if (ITCH_UNLIKELY(halted_count_ != 0)) {
+            while (halted_[locate]) locate = draw_symbol();
+        }
+        SymbolState& s = symbols_[locate];
+        const std::uint64_t r = rng_.next();
+        const std::uint64_t r2 = rng_.next();
+        Action action = actions_[r & (ACTION_TABLE - 1)];
+        if (s.live.empty() && action != TRADE) {
+            action = ADD;
+        } else if (action == ADD && s.live.size() >= config_.max_live_per_symbol) {
+            action = DELETE;
+        }
+
+        switch (action) {
+            case ADD: {
+                // Filled in place: building a temporary and copying it in stalls store forwarding
+                s.live.emplace_back();
+                LiveOrder& order = s.live.back();
+                order.side = (r >> 10) & 1 ? Side::Buy : Side::Sell;
+                order.id = next_order_id_++;
+                order.price = passive_price(s, order.side, r2);
+                order.shares = order_shares(static_cast<std::uint32_t>(r2 >> 32));
+                if (((r >> 11) & 31) == 0) {
+                    add_order_mpid(locate, s, order, MPIDS[(r >> 16) & 7]);
+                } else {
+                    add_order(locate, s, order);
+                }
+                break;
+            }
+            case EXECUTE: {
+                const std::size_t index = pick_order(s, r2);
+                LiveOrder& order = s.live[index];
+                Quantity shares = order.shares;
+                if (order.shares > 100 && ((r >> 10) & 3) == 0) {
+                    shares = 1 + detail::DayRng::bounded(static_cast<std::uint32_t>(r >> 32), order.shares - 1);
+                }
+                if (((r >> 12) & 15) == 0) {
+                    order_executed_price(locate, order, shares, (r >> 16) & 1 ? 'Y' : 'N');
+                } else {
+                    order_executed(locate, order, shares);
+                }
+                // Executions walk the reference price away from the side that was hit
+                if (((r >> 17) & 3) == 0) {
+                    if (order.side == Side::Buy) {
+                        if (s.mid > 20 * TICK) s.mid -= static_cast<std::uint32_t>(TICK);
+                    } else {
+                        s.mid += static_cast<std::uint32_t>(TICK);
+                    }
+                }
+                order.shares -= shares;
+                if (order.shares == 0) remove_order(s, index);
+                break;
+            }
+            case CANCEL: {
+                const std::size_t index = pick_order(s, r2);
+                LiveOrder& order = s.live[index];
+                if (order.shares < 2) {
+                    order_delete(locate, order);
+                    remove_order(s, index);
+                    break;
+                }
+                const Quantity shares = 1 + detail::DayRng::bounded(static_cast<std::uint32_t>(r >> 32), order.shares - 1);
+                order_cancel(locate, order, shares);
+                order.shares -= shares;
+                break;
+            }
+            case DELETE: {
+                const std::size_t index = pick_order(s, r2);
+                order_delete(locate, s.live[index]);
+                remove_order(s, index);
+                break;
+            }
+            case REPLACE: {
+                const std::size_t index = pick_order(s, r2);
+                LiveOrder order = s.live[index];
+                const OrderId old_id = order.id;
+                order.id = next_order_id_++;
+                const std::uint64_t r3 = rng_.next();
+                order.price = passive_price(s, order.side, r3);
+                order.shares = order_shares(static_cast<std::uint32_t>(r3 >> 32));
+                order_replace(locate, old_id, order);
+                // The replacement is a fresh order: move it to the recent end
+                s.live[index] = s.live.back();
+                s.live.back() = order;
+                break;
+            }
+            case TRADE:
+                trade(locate, s, (r >> 10) & 1 ? Side::Buy : Side::Sell,
+                      order_shares(static_cast<std::uint32_t>(r2 >> 32)));
+                break;
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Encoding
+    // -------------------------------------------------------------------------
+
+    static constexpr const char* MPIDS[8] = {"NSDQ", "GSCO", "MSCO", "UBSS", "CDRG", "VIRT", "JPMS", "SUSQ"};
+
+    template<typename Msg>
+    Msg& emit(char type, StockLocate locate) noexcept {
+        static_assert(sizeof(Msg) < 256, "Message too large for the buffer slack");
+        char* p = buffer_.data() + pos_;
+        if (config_.binary_file) {
+            const std::uint16_t length = endian::be16_to_host(static_cast<std::uint16_t>(sizeof(Msg)));
+            std::memcpy(p, &length, sizeof(length));
+            p += sizeof(length);
+            pos_ += sizeof(length);
+        }
+        pos_ += sizeof(Msg);
+        ++stats_.messages;
+        ++stats_.by_type[static_cast<unsigned char>(type) & 127];
+
+        Msg& msg = *reinterpret_cast<Msg*>(p);
+        msg.message_type = type;
+        msg.stock_locate = endian::be16_to_host(locate);
+        msg.tracking_number = 0;
+        const std::uint64_t ts = endian::be64_to_host(ts_ << 16);
+        std::memcpy(msg.timestamp, &ts, sizeof(msg.timestamp));
+        return msg;
+    }
+
+    /// Hand a full chunk to the sink; called after every message
+    void commit_message() {
+        if (ITCH_UNLIKELY(pos_ >= CHUNK_SIZE)) flush();
+    }
+
+    void flush() {
+        if (pos_ == 0) return;
+        stats_.bytes += pos_;
+        sink_(sink_context_, buffer_.data(), pos_);
+        pos_ = 0;
+    }
+
+    void system_event(char code) {
+        emit<SystemEventMessage>('S', 0).event_code = code;
+        commit_message();
+    }
+
+    void stock_directory(StockLocate locate) {
+        auto& msg = emit<StockDirectoryMessage>('R', locate);
+        std::memcpy(msg.stock, symbols_[locate].name, sizeof(msg.stock));
+        msg.market_category = 'Q';
+        msg.financial_status = 'N';
+        msg.round_lot_size = endian::be32_to_host(100u);
+        msg.round_lots_only = 'N';
+        msg.issue_classification = 'C';
+        msg.issue_subtype[0] = 'Z';
+        msg.issue_subtype[1] = ' ';
+        msg.authenticity = 'P';
+        msg.short_sale_threshold = 'N';
+        msg.ipo_flag = ' ';
+        msg.luld_ref_price_tier = locate % 4 == 0 ? '1' : '2';
+        msg.etp_flag = 'N';
+        msg.etp_leverage_factor = 0;
+        msg.inverse_indicator = 'N';
+        commit_message();
+    }
+
+    void trading_action(StockLocate locate, char state, const char* reason) {
+        auto& msg = emit<StockTradingActionMessage>('H', locate);
+        std::memcpy(msg.stock, symbols_[locate].name, sizeof(msg.stock));
+        msg.trading_state = state;
+        msg.reserved = ' ';
+        std::memcpy(msg.reason, reason, sizeof(msg.reason));
+        commit_message();
+    }
+
+    void add_order(StockLocate locate, const SymbolState& s, const LiveOrder& order) {
+        auto& msg = emit<AddOrderMessage>('A', locate);
+        msg.order_ref_number = endian::be64_to_host(order.id);
+        msg.buy_sell_indicator = static_cast<char>(order.side);
+        msg.shares = endian::be32_to_host(order.shares);
+        std::memcpy(msg.stock, s.name, sizeof(msg.stock));
+        msg.price = endian::be32_to_host(order.price);
+        commit_message();
+    }
+
+    void add_order_mpid(StockLocate locate, const SymbolState& s, const LiveOrder& order, const char* mpid) {
+        auto& msg = emit<AddOrderMPIDMessage>('F', locate);
+        msg.order_ref_number = endian::be64_to_host(order.id);
+        msg.buy_sell_indicator = static_cast<char>(order.side);
+        msg.shares = endian::be32_to_host(order.shares);
+        std::memcpy(msg.stock, s.name, sizeof(msg.stock));
+        msg.price = endian::be32_to_host(order.price);
+        std::memcpy(msg.attribution, mpid, sizeof(msg.attribution));
+        commit_message();
+    }
+
+    void order_executed(StockLocate locate, const LiveOrder& order, Quantity shares) {
+        auto& msg = emit<OrderExecutedMessage>('E', locate);
+        msg.order_ref_number = endian::be64_to_host(order.id);
+        msg.executed_shares = endian::be32_to_host(shares);
+        msg.match_number = endian::be64_to_host(next_match_++);
+        commit_message();
+    }
+
+    void order_executed_price(StockLocate locate, const LiveOrder& order, Quantity shares, char printable) {
+        auto& msg = emit<OrderExecutedPriceMessage>('C', locate);
+        msg.order_ref_number = endian::be64_to_host(order.id);
+        msg.executed_shares = endian::be32_to_host(shares);
+        msg.match_number = endian::be64_to_host(next_match_++);
+        msg.printable = printable;
+        msg.execution_price = endian::be32_to_host(order.price);
+        commit_message();
+    }
+
+    void order_cancel(StockLocate locate, const LiveOrder& order, Quantity shares) {
+        auto& msg = emit<OrderCancelMessage>('X', locate);
+        msg.order_ref_number = endian::be64_to_host(order.id);
+        msg.cancelled_shares = endian::be32_to_host(shares);
+        commit_message();
+    }
+
+    void order_delete(StockLocate locate, const LiveOrder& order) {
+        emit<OrderDeleteMessage>('D', locate).order_ref_number = endian::be64_to_host(order.id);
+        commit_message();
+    }
+
+    void order_replace(StockLocate locate, OrderId old_id, const LiveOrder& order) {
+        auto& msg = emit<OrderReplaceMessage>('U', locate);
+        msg.original_order_ref_number = endian::be64_to_host(old_id);
+        msg.new_order_ref_number = endian::be64_to_host(order.id);
+        msg.shares = endian::be32_to_host(order.shares);
+        msg.price = endian::be32_to_host(order.price);
+        commit_message();
+    }
+
+    void trade(StockLocate locate, const SymbolState& s, Side side, Quantity shares) {
+        auto& msg = emit<TradeMessage>('P', locate);
+        msg.order_ref_number = 0;
+        msg.buy_sell_indicator = static_cast<char>(side);
+        msg.shares = endian::be32_to_host(shares);
+        std::memcpy(msg.stock, s.name, sizeof(msg.stock));
+        msg.price = endian::be32_to_host(s.mid);
+        msg.match_number = endian::be64_to_host(next_match_++);
+        commit_message();
+    }
+
+    void noii(StockLocate locate, char cross_type) {
+        const SymbolState& s = symbols_[locate];
+        const std::uint64_t r = rng_.next();
+        const std::uint64_t paired = 100 * (1 + detail::DayRng::bounded(static_cast<std::uint32_t>(r >> 32), 5000));
+        const std::uint64_t imbalance = 100 * detail::DayRng::bounded(static_cast<std::uint32_t>(r), 1000);
+        const char direction = imbalance == 0 ? 'N' : ((r >> 20) & 1 ? 'B' : 'S');
+        const std::uint32_t skew = static_cast<std::uint32_t>(TICK) * static_cast<std::uint32_t>((r >> 21) & 3);
+
+        auto& msg = emit<NOIIMessage>('I', locate);
+        msg.paired_shares = endian::be64_to_host(paired);
+        msg.imbalance_shares = endian::be64_to_host(imbalance);
+        msg.imbalance_direction = direction;
+        std::memcpy(msg.stock, s.name, sizeof(msg.stock));
+        msg.far_price = endian::be32_to_host(direction == 'S' && s.mid > skew ? s.mid - skew : s.mid + skew);
+        msg.near_price = endian::be32_to_host(s.mid);
+        msg.current_ref_price = endian::be32_to_host(s.mid);
+        msg.cross_type = cross_type;
+        msg.price_variation_indicator = ' ';
+        commit_message();
+    }
+
+    void cross(StockLocate locate, char cross_type) {
+        const SymbolState& s = symbols_[locate];
+        auto& msg = emit<CrossTradeMessage>('Q', locate);
+        msg.shares = endian::be64_to_host(std::uint64_t{100} * rng_.below(20000));
+        std::memcpy(msg.stock, s.name, sizeof(msg.stock));
+        msg.cross_price = endian::be32_to_host(s.mid);
+        msg.match_number = endian::be64_to_host(next_match_++);
+        msg.cross_type = cross_type;
+        commit_message();
+    }
+
+    DayGeneratorConfig config_;
+    DayGeneratorStats stats_;
+    detail::DayRng rng_;
+
+    std::vector<SymbolState> symbols_;          // Indexed by locate; [0] unused
+    std::vector<AliasSlot> alias_;              // Indexed by locate - 1
+    std::vector<bool> halted_;
+    std::size_t halted_count_ = 0;
+    std::vector<StockLocate> noii_symbols_;
+    std::vector<Event> events_;
+    std::vector<std::uint32_t> volume_;         // Flow messages per second from SYSTEM_OPEN
+    Action actions_[ACTION_TABLE] = {};
+
+    std::vector<char> buffer_;
+    std::size_t pos_ = 0;
+    Timestamp ts_ = 0;
+    OrderId next_order_id_ = 1;
+    std::uint64_t next_match_ = 1;
+
+    void (*sink_)(void*, const char*, std::size_t) = nullptr;
+    void* sink_context_ = nullptr;
+};
+
+} // namespace itch
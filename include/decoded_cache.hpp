@@ -0,0 +1,406 @@
+/**
+ * @file decoded_cache.hpp
+ * @brief Pre-decoded, host-endian, fixed-stride replay cache
+ *
+ * Repeated backtests over the same day pay for big-endian decoding, 48-bit
+ * timestamp assembly and variable-size stepping on every run. The converter
+ * does that once and writes every order-affecting message (A, F, E, C, X,
+ * D, U) as a 32-byte host-endian record; replay then mmaps the cache and
+ * feeds the OrderBookManager directly with a fixed stride.
+ *
+ * A replace needs two order references, so 'U' occupies two consecutive
+ * slots: the record itself and an extension record holding the new
+ * reference. Every other message occupies exactly one slot.
+ *
+ * Non-book messages (directory, trades, system events, ...) are kept as raw
+ * ITCH bytes in a side stream that FeedHandler::process() can consume. Each
+ * side message also has an entry in the side index: the number of record
+ * slots that precede it in the source, so replay() can interleave the two
+ * streams in their original order.
+ *
+ * File layout (host-endian):
+ *   DecodedCacheHeader
+ *   DecodedRecord x record_count
+ *   side index    (std::uint64_t x side_messages)
+ *   side stream   (side_bytes of raw ITCH messages)
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "message_types.hpp"
+#include "order_book.hpp"
+#include "feed_handler.hpp"
+
+#include <cstring>
+
+namespace itch {
+
+// =============================================================================
+// On-Disk Records
+// =============================================================================
+
+struct DecodedCacheHeader {
+    char          magic[8];         // "ITCHDEC\0"
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t record_count;     // Slots, including replace extensions
+    std::uint64_t book_messages;    // Order-affecting messages converted
+    std::uint64_t side_messages;
+    std::uint64_t side_bytes;
+    std::uint64_t source_bytes;     // Bytes of the raw ITCH input consumed
+    std::uint64_t reserved;
+
+    static constexpr char MAGIC[8] = {'I', 'T', 'C', 'H', 'D', 'E', 'C', '\0'};
+    static constexpr std::uint32_t VERSION = 2;
+};
+static_assert(sizeof(DecodedCacheHeader) == 64, "DecodedCacheHeader must be 64 bytes");
+
+struct DecodedRecord {
+    Timestamp     timestamp;
+    OrderId       order_ref;        // Extension slot: new order reference
+    std::uint32_t price;            // A/F/U: order price, C: execution price
+    Quantity      shares;           // A/F/U: size, E/C: executed, X: cancelled
+    StockLocate   stock_locate;
+    char          type;             // ITCH message type or EXTENSION
+    Side          side;             // A/F only
+    std::uint32_t reserved;
+
+    static constexpr char EXTENSION = '+';
+};
+static_assert(sizeof(DecodedRecord) == 32, "DecodedRecord must be 32 bytes");
+
+/**
+ * @brief Summary returned by the converter
+ */
+struct DecodedCacheInfo {
+    std::uint64_t record_count = 0;
+    std::uint64_t book_messages = 0;
+    std::uint64_t side_messages = 0;
+    std::uint64_t side_bytes = 0;
+    std::uint64_t source_bytes = 0;
+    std::uint64_t file_bytes = 0;
+};
+
+// =============================================================================
+// Converter
+// =============================================================================
+
+namespace detail {
+
+inline bool is_book_message(char type) noexcept {
+    switch (type) {
+        case 'A': case 'F': case 'E': case 'C': case 'X': case 'D': case 'U':
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Decodes one order-affecting message into `out`; returns slots written
+inline std::size_t decode_book_message(const char* data, DecodedRecord* out) noexcept {
+    DecodedRecord& r = out[0];
+    r = DecodedRecord{};
+    r.type = data[0];
+    r.stock_locate = endian::be16_to_host(*reinterpret_cast<const std::uint16_t*>(data + 1));
+    r.timestamp = endian::be48_to_host(reinterpret_cast<const std::uint8_t*>(data + 5));
+
+    switch (r.type) {
+        case 'A': {
+            const auto& m = *reinterpret_cast<const AddOrderMessage*>(data);
+            r.order_ref = endian::be64_to_host(m.order_ref_number);
+            r.side = char_to_side(m.buy_sell_indicator);
+            r.shares = endian::be32_to_host(m.shares);
+            r.price = endian::be32_to_host(m.price);
+            return 1;
+        }
+        case 'F': {
+            const auto& m = *reinterpret_cast<const AddOrderMPIDMessage*>(data);
+            r.order_ref = endian::be64_to_host(m.order_ref_number);
+            r.side = char_to_side(m.buy_sell_indicator);
+            r.shares = endian::be32_to_host(m.shares);
+            r.price = endian::be32_to_host(m.price);
+            return 1;
+        }
+        case 'E': {
+            const auto& m = *reinterpret_cast<const OrderExecutedMessage*>(data);
+            r.order_ref = endian::be64_to_host(m.order_ref_number);
+            r.shares = endian::be32_to_host(m.executed_shares);
+            return 1;
+        }
+        case 'C': {
+            const auto& m = *reinterpret_cast<const OrderExecutedPriceMessage*>(data);
+            r.order_ref = endian::be64_to_host(m.order_ref_number);
+            r.shares = endian::be32_to_host(m.executed_shares);
+            r.price = endian::be32_to_host(m.execution_price);
+            return 1;
+        }
+        case 'X': {
+            const auto& m = *reinterpret_cast<const OrderCancelMessage*>(data);
+            r.order_ref = endian::be64_to_host(m.order_ref_number);
+            r.shares = endian::be32_to_host(m.cancelled_shares);
+            return 1;
+        }
+        case 'D': {
+            const auto& m = *reinterpret_cast<const OrderDeleteMessage*>(data);
+            r.order_ref = endian::be64_to_host(m.order_ref_number);
+            return 1;
+        }
+        case 'U': {
+            const auto& m = *reinterpret_cast<const OrderReplaceMessage*>(data);
+            r.order_ref = endian::be64_to_host(m.original_order_ref_number);
+            r.shares = endian::be32_to_host(m.shares);
+            r.price = endian::be32_to_host(m.price);
+            DecodedRecord& ext = out[1];
+            ext = DecodedRecord{};
+            ext.type = DecodedRecord::EXTENSION;
+            ext.stock_locate = r.stock_locate;
+            ext.timestamp = r.timestamp;
+            ext.order_ref = endian::be64_to_host(m.new_order_ref_number);
+            return 2;
+        }
+        default:
+            return 0;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Convert back-to-back raw ITCH messages into a decoded cache at `path`
+ *
+ * Stops at the first unparseable message, like TemplateParser::parse().
+ * Each section is written in its own pass over `data`, so nothing but the
+ * writer's buffer is held in memory.
+ */
+inline bool write_decoded_cache(const char* data, std::size_t len, const char* path,
+                                DecodedCacheInfo* info = nullptr) {
+    // Pass 1: count slots and side bytes
+    DecodedCacheHeader header{};
+    std::memcpy(header.magic, DecodedCacheHeader::MAGIC, sizeof(header.magic));
+    header.version = DecodedCacheHeader::VERSION;
+    header.record_size = sizeof(DecodedRecord);
+
+    std::size_t offset = 0;
+    while (offset < len) {
+        const std::size_t size = get_message_size(data[offset]);
+        if (size == 0 || len - offset < size) break;
+        if (detail::is_book_message(data[offset])) {
+            ++header.book_messages;
+            header.record_count += data[offset] == 'U' ? 2 : 1;
+        } else {
+            ++header.side_messages;
+            header.side_bytes += size;
+        }
+        offset += size;
+    }
+    header.source_bytes = offset;
+
+    BufferedFileWriter out;
+    if (!out.open(path)) {
+        return false;
+    }
+    out.write_pod(header);
+
+    // Pass 2: decode records straight into the writer's buffer
+    DecodedRecord slots[2];
+    for (offset = 0; offset < header.source_bytes; offset += get_message_size(data[offset])) {
+        if (!detail::is_book_message(data[offset])) continue;
+        const std::size_t n = detail::decode_book_message(data + offset, slots);
+        out.write(slots, n * sizeof(DecodedRecord));
+    }
+
+    // Pass 3: side index, then pass 4: the side messages themselves
+    std::uint64_t slot = 0;
+    for (offset = 0; offset < header.source_bytes; offset += get_message_size(data[offset])) {
+        if (detail::is_book_message(data[offset])) {
+            slot += data[offset] == 'U' ? 2 : 1;
+        } else {
+            out.write_pod(slot);
+        }
+    }
+    for (offset = 0; offset < header.source_bytes; ) {
+        const std::size_t size = get_message_size(data[offset]);
+        if (!detail::is_book_message(data[offset])) {
+            out.write(data + offset, size);
+        }
+        offset += size;
+    }
+
+    const std::uint64_t bytes = out.bytes_written();
+    if (!out.commit()) {
+        return false;
+    }
+    if (info) {
+        info->record_count = header.record_count;
+        info->book_messages = header.book_messages;
+        info->side_messages = header.side_messages;
+        info->side_bytes = header.side_bytes;
+        info->source_bytes = header.source_bytes;
+        info->file_bytes = bytes;
+    }
+    return true;
+}
+
+inline bool write_decoded_cache_file(const char* itch_path, const char* cache_path,
+                                     DecodedCacheInfo* info = nullptr) {
+    MemoryMappedFile file;
+    if (!file.open(itch_path)) {
+        return false;
+    }
+    return write_decoded_cache(file.data(), file.size(), cache_path, info);
+}
+
+// =============================================================================
+// Cache Reader / Replay
+// =============================================================================
+
+class DecodedCache {
+public:
+    bool open(const char* path) {
+        if (!file_.open(path) || file_.size() < sizeof(DecodedCacheHeader)) {
+            return false;
+        }
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        if (std::memcmp(header_.magic, DecodedCacheHeader::MAGIC, sizeof(header_.magic)) != 0 ||
+            header_.version != DecodedCacheHeader::VERSION ||
+            header_.record_size != sizeof(DecodedRecord)) {
+            return false;
+        }
+        const std::uint64_t size = file_.size();
+        if (header_.record_count > size / sizeof(DecodedRecord) ||
+            header_.side_messages > size / sizeof(std::uint64_t) ||
+            header_.side_bytes > size) {
+            return false;
+        }
+        const std::uint64_t expected = sizeof(DecodedCacheHeader) +
+            header_.record_count * sizeof(DecodedRecord) +
+            header_.side_messages * sizeof(std::uint64_t) + header_.side_bytes;
+        return expected == size;
+    }
+
+    const DecodedRecord* records() const noexcept {
+        return reinterpret_cast<const DecodedRecord*>(file_.data() + sizeof(DecodedCacheHeader));
+    }
+    std::size_t record_count() const noexcept { return static_cast<std::size_t>(header_.record_count); }
+
+    /// Record slots preceding each side message in the source, one per side message
+    const std::uint64_t* side_index() const noexcept {
+        return reinterpret_cast<const std::uint64_t*>(
+            file_.data() + sizeof(DecodedCacheHeader) + header_.record_count * sizeof(DecodedRecord));
+    }
+    std::size_t side_message_count() const noexcept {
+        return static_cast<std::size_t>(header_.side_messages);
+    }
+
+    /// Raw ITCH bytes of every non-book message, in file order
+    const char* side_stream() const noexcept {
+        return reinterpret_cast<const char*>(side_index() + header_.side_messages);
+    }
+    std::size_t side_size() const noexcept { return static_cast<std::size_t>(header_.side_bytes); }
+
+    const DecodedCacheHeader& header() const noexcept { return header_; }
+
+    /**
+     * @brief Apply every book record to `books`
+     *
+     * Books are opened on first use, so this may allocate. A malformed record
+     * (locate out of range, replace without its extension slot) ends the
+     * replay early.
+     * @return Order-affecting messages applied; header().book_messages
+     *         unless the cache is malformed
+     */
+    std::size_t replay(OrderBookManager& books) const {
+        ObjectPool<Order>& pool = books.order_pool();
+        const DecodedRecord* r = records();
+        const DecodedRecord* const end = r + record_count();
+        std::size_t applied = 0;
+        while (r < end) {
+            const std::size_t slots = apply(books, pool, r, end);
+            if (ITCH_UNLIKELY(slots == 0)) break;
+            r += slots;
+            ++applied;
+        }
+        return applied;
+    }
+
+    /**
+     * @brief Apply every book record to `books` and hand each side message to
+     *        `on_side(const char* msg, std::size_t size)` at its source position
+     *
+     * E.g. feed the side messages to FeedHandler::process() while `books` is
+     * that handler's book_manager(). Malformed records end the replay as
+     * in replay(books); side messages after that point are not delivered.
+     * @return Order-affecting messages applied
+     */
+    template<typename SideFn>
+    std::size_t replay(OrderBookManager& books, SideFn&& on_side) const {
+        ObjectPool<Order>& pool = books.order_pool();
+        const DecodedRecord* const begin = records();
+        const DecodedRecord* const end = begin + record_count();
+        const std::uint64_t* index = side_index();
+        const std::uint64_t* const index_end = index + side_message_count();
+        const char* side = side_stream();
+        const char* const side_end = side + side_size();
+        std::size_t applied = 0;
+        for (const DecodedRecord* r = begin; ; ++applied) {
+            const auto slot = static_cast<std::uint64_t>(r - begin);
+            for (; index < index_end && *index <= slot; ++index) {
+                const std::size_t size = side < side_end ? get_message_size(*side) : 0;
+                if (size == 0 || static_cast<std::size_t>(side_end - side) < size) {
+                    index = index_end;      // Side stream disagrees with its index
+                    break;
+                }
+                on_side(side, size);
+                side += size;
+            }
+            if (r == end) break;
+            const std::size_t slots = apply(books, pool, r, end);
+            if (ITCH_UNLIKELY(slots == 0)) break;
+            r += slots;
+        }
+        return applied;
+    }
+
+private:
+    MemoryMappedFile file_;
+    DecodedCacheHeader header_{};
+
+    /// Applies the record at `r`; returns the slots it occupies, 0 if malformed
+    static ITCH_FORCE_INLINE std::size_t apply(OrderBookManager& books, ObjectPool<Order>& pool,
+                                               const DecodedRecord* r, const DecodedRecord* end) {
+        if (ITCH_UNLIKELY(r->stock_locate >= OrderBookManager::MAX_SYMBOLS)) {
+            return 0;
+        }
+        OrderBook& book = books.get_book(r->stock_locate);
+        switch (r->type) {
+            case 'A':
+            case 'F':
+                book.add_order(r->order_ref, r->side, static_cast<Price>(r->price),
+                               r->shares, r->timestamp, pool);
+                break;
+            case 'E':
+            case 'C':
+                book.execute_order(r->order_ref, r->shares, pool);
+                break;
+            case 'X':
+                book.cancel_order(r->order_ref, r->shares, pool);
+                break;
+            case 'D':
+                book.delete_order(r->order_ref, pool);
+                break;
+            case 'U':
+                if (ITCH_UNLIKELY(end - r < 2 || r[1].type != DecodedRecord::EXTENSION)) {
+                    return 0;
+                }
+                book.replace_order(r->order_ref, r[1].order_ref, r->shares,
+                                   static_cast<Price>(r->price), r->timestamp, pool);
+                return 2;
+            default:
+                break;
+        }
+        return 1;
+    }
+};
+
+} // namespace itch
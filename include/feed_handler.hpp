@@ -8,9 +8,13 @@
  * Features:
  * - Symbol filtering
  * - Event callbacks for trades, BBO updates, depth changes
+ * - Incremental top-N depth delta feed (preallocated, no per-message allocation)
+ * - Seqlock BBO snapshots readable from other threads
+ * - Inline per-symbol OHLCV / VWAP trade bars
  * - Performance metrics (latency, throughput)
  * - Memory-mapped file support for replay
- * - Cache Warming (HFT Pattern)
+ * - Cache warming: prefaulting plus a rolled-back synthetic message mix,
+ *   before the session and during idle periods
  * - Template-based Dispatch (Zero virtual calls)
  */
 
@@ -20,6 +24,9 @@
 #include "message_types.hpp"
 #include "itch_parser.hpp"
 #include "order_book.hpp"
+#include "bbo_snapshot.hpp"
+#include "bar_engine.hpp"
+#include "warmup.hpp"
 
 #include <functional>
 #include <fstream>
@@ -29,6 +36,8 @@
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <cstdio>
+#include <string>
 
 #ifdef _WIN32
 #ifndef NOMINMAX
@@ -349,6 +358,109 @@ private:
 #endif
 };
 
+// =============================================================================
+// Buffered File Writer
+// =============================================================================
+
+/**
+ * @brief Append-only binary writer with a large user-space buffer
+ * 
+ * Output goes to `<path>.tmp` and is renamed over `path` by commit(), so a
+ * crash mid-write never leaves a truncated file under the final name.
+ */
+class BufferedFileWriter {
+public:
+    explicit BufferedFileWriter(std::size_t buffer_size = 1 << 20) {
+        buffer_.reserve(buffer_size);
+    }
+    
+    ~BufferedFileWriter() {
+        if (file_) {
+            std::fclose(file_);
+            std::remove(tmp_path_.c_str());
+        }
+    }
+    
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+    
+    bool open(const char* path) {
+        path_ = path;
+        tmp_path_ = path_ + ".tmp";
+        file_ = std::fopen(tmp_path_.c_str(), "wb");
+        ok_ = file_ != nullptr;
+        written_ = 0;
+        return ok_;
+    }
+    
+    void write(const void* data, std::size_t len) {
+        if (buffer_.size() + len > buffer_.capacity()) {
+            flush();
+            if (len > buffer_.capacity()) {
+                ok_ = ok_ && std::fwrite(data, 1, len, file_) == len;
+                written_ += len;
+                return;
+            }
+        }
+        const char* bytes = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + len);
+        written_ += len;
+    }
+    
+    template<typename T>
+    void write_pod(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "write_pod requires a POD type");
+        write(&value, sizeof(T));
+    }
+    
+    /**
+     * @brief Flush, close and atomically move the file into place
+     */
+    bool commit() {
+        if (!file_) return false;
+        flush();
+        ok_ = (std::fclose(file_) == 0) && ok_;
+        file_ = nullptr;
+        if (!ok_) {
+            std::remove(tmp_path_.c_str());
+            return false;
+        }
+        return std::rename(tmp_path_.c_str(), path_.c_str()) == 0;
+    }
+    
+    std::uint64_t bytes_written() const noexcept { return written_; }
+
+private:
+    std::FILE* file_ = nullptr;
+    std::string path_;
+    std::string tmp_path_;
+    std::vector<char> buffer_;
+    std::uint64_t written_ = 0;
+    bool ok_ = false;
+    
+    void flush() {
+        if (!buffer_.empty()) {
+            ok_ = ok_ && std::fwrite(buffer_.data(), 1, buffer_.size(), file_) == buffer_.size();
+            buffer_.clear();
+        }
+    }
+};
+
+// =============================================================================
+// Replay Position
+// =============================================================================
+
+/**
+ * @brief How far into the stream the handler has applied messages
+ * 
+ * sequence counts messages dispatched; offset counts raw ITCH bytes consumed
+ * through process()/process_file(), i.e. the file offset to resume from.
+ */
+struct ReplayPosition {
+    std::uint64_t sequence = 0;
+    std::uint64_t offset = 0;
+};
+
 // =============================================================================
 // ITCH 5.0 Feed Handler
 // =============================================================================
@@ -388,38 +500,178 @@ public:
         use_filter_ = false;
     }
     
-    // Cache Warming (from HFT Paper)
-    void warmup() {
-        // Touch order pool to fault pages
-        std::vector<Order*> temp_orders;
-        temp_orders.reserve(10000);
-        for(int i=0; i<10000; ++i) {
-            temp_orders.push_back(book_manager_.order_pool().acquire());
+    /**
+     * @brief Maintain market-by-price deltas for the top `levels` of every book
+     * 
+     * Deltas accumulate in depth_deltas() until the consumer drains them with
+     * depth_deltas().clear(), typically after each process() call.
+     */
+    void enable_depth_feed(std::size_t levels, std::size_t buffer_capacity = 65536) {
+        depth_deltas_.reserve(buffer_capacity);
+        book_manager_.set_depth_feed(&depth_deltas_, levels);
+    }
+    
+    void disable_depth_feed() noexcept {
+        book_manager_.set_depth_feed(nullptr, 0);
+        depth_deltas_.clear();
+    }
+    
+    /**
+     * @brief Cache the top `levels` of every book so depth queries up to that
+     * size are a copy of a flat array instead of a std::map walk
+     */
+    void enable_depth_cache(std::size_t levels) {
+        book_manager_.set_depth_cache(levels);
+    }
+    
+    /**
+     * @brief Size the order pool and every book's order index for the expected
+     * session peak (see OrderBookManager::presize)
+     */
+    void presize(std::size_t peak_live_orders, std::size_t peak_orders_per_book) {
+        book_manager_.presize(peak_live_orders, peak_orders_per_book);
+    }
+    
+    DepthDeltaBuffer& depth_deltas() noexcept { return depth_deltas_; }
+    const DepthDeltaBuffer& depth_deltas() const noexcept { return depth_deltas_; }
+    
+    /**
+     * @brief Publish every BBO change into per-symbol seqlock slots
+     * 
+     * Other threads read through bbo_publisher()->read(locate). Call before
+     * handing the publisher to readers; it stays valid for the handler's lifetime.
+     */
+    void enable_bbo_publishing() {
+        if (!bbo_publisher_) {
+            bbo_publisher_ = std::make_unique<BBOPublisher>();
+        }
+    }
+    
+    const BBOPublisher* bbo_publisher() const noexcept { return bbo_publisher_.get(); }
+    
+    /**
+     * @brief Publish the current BBO of every book, stamped with `ts`
+     * 
+     * For books rebuilt outside the message path (e.g. load_checkpoint),
+     * which does not publish on its own.
+     */
+    void republish_bbo(Timestamp ts) noexcept {
+        if (!bbo_publisher_) return;
+        book_manager_.for_each_book([&](const OrderBook& book) {
+            publish_bbo(book.stock_locate(), book, ts);
+        });
+    }
+    
+    /**
+     * @brief Build per-symbol trade bars for each interval inline with the feed
+     * 
+     * Bars are fed by printable executions (E, C with printable 'Y', P, Q)
+     * and corrected by broken trades; read them through bar_engine().
+     * Call before handing the engine to readers.
+     */
+    void enable_bars(const std::vector<std::uint64_t>& intervals_ns,
+                     std::size_t trade_log = BarEngine::DEFAULT_TRADE_LOG) {
+        if (!bar_engine_) {
+            bar_engine_ = std::make_unique<BarEngine>(intervals_ns, trade_log);
         }
-        for(auto* o : temp_orders) {
-            o->price = 1; // write access
-            book_manager_.order_pool().release(o);
+    }
+    
+    const BarEngine* bar_engine() const noexcept { return bar_engine_.get(); }
+    
+    /// Passes of the synthetic mix warmup() makes over every book
+    static constexpr std::size_t WARMUP_ROUNDS = 4;
+    /// Books each idle_warmup() call warms
+    static constexpr std::size_t IDLE_WARMUP_BOOKS = 1;
+    
+    /**
+     * @brief Warm the whole feed path before the session
+     *
+     * Prefaults every page of the order pool and of each hint-sized book's
+     * order index (see OrderBookManager::prefault), then runs WarmupBatch's synthetic mix `rounds` times for every
+     * subscribed book (the symbol filter's locates when one is set, opening
+     * their books; otherwise every open book) through the parser, the books,
+     * the BBO / bar / depth paths and the event handler, and rolls it all
+     * back (see warm_books()). Call after the directory or warm_start() has
+     * opened the books; it is also safe mid-session.
+     */
+    void warmup(std::size_t rounds = WARMUP_ROUNDS) {
+        if (use_filter_) {
+            for (const StockLocate locate : symbol_filter_) {
+                if (locate < OrderBookManager::MAX_SYMBOLS) book_manager_.open_book(locate);
+            }
+        }
+        book_manager_.prefault();
+        refresh_warm_locates();
+        for (std::size_t r = 0; r < rounds; ++r) {
+            warm_books(warm_locates_.data(), warm_locates_.size());
         }
-        // Pre-initialize basic books
-        book_manager_.get_book(1);
+    }
+    
+    /**
+     * @brief Keep the feed path warm through a quiet spell
+     *
+     * Call from the feed loop whenever a poll finds no data. Each call runs the
+     * synthetic mix for the next IDLE_WARMUP_BOOKS subscribed books (round
+     * robin) and rolls it back, so code, predictors and the busiest book lines
+     * are not evicted by whatever else the core runs while the feed is idle.
+     * One book costs about as much as its 21 messages would.
+     * @return books warmed by this call
+     */
+    std::size_t idle_warmup() {
+        if (warm_books_seen_ != book_manager_.active_book_count()) {
+            refresh_warm_locates();
+        }
+        if (warm_locates_.empty()) return 0;
+        if (warm_cursor_ >= warm_locates_.size()) warm_cursor_ = 0;
+        const std::size_t count = std::min(IDLE_WARMUP_BOOKS, warm_locates_.size() - warm_cursor_);
+        warm_books(warm_locates_.data() + warm_cursor_, count);
+        warm_cursor_ += count;
+        return count;
     }
     
     std::size_t process(const char* data, std::size_t len) {
-        return parser_.parse(data, len);
+        const std::uint64_t parsed_before = parser_.stats().messages_parsed;
+        const std::size_t consumed = parser_.parse(data, len);
+        position_.sequence += parser_.stats().messages_parsed - parsed_before;
+        position_.offset += consumed;
+        return consumed;
     }
     
     std::size_t process_moldudp64(const char* data, std::size_t len) {
-        return parser_.parse_moldudp64(data, len);
+        const std::uint64_t parsed_before = parser_.stats().messages_parsed;
+        const std::size_t parsed = parser_.parse_moldudp64(data, len);
+        position_.sequence += parser_.stats().messages_parsed - parsed_before;
+        return parsed;
+    }
+    
+    /**
+     * @brief Process a BinaryFILE-framed stream (2-byte length before every message)
+     * @return Bytes consumed, framing included, so position().offset stays a file offset
+     */
+    std::size_t process_binaryfile(const char* data, std::size_t len) {
+        const std::uint64_t parsed_before = parser_.stats().messages_parsed;
+        const std::size_t consumed = parser_.parse_binaryfile(data, len);
+        position_.sequence += parser_.stats().messages_parsed - parsed_before;
+        position_.offset += consumed;
+        return consumed;
     }
     
-    std::size_t process_file(const char* path) {
+    /**
+     * @brief Replay a raw ITCH file, optionally starting at a byte offset
+     * Pass position().offset after load_checkpoint() to resume a restored handler.
+     */
+    std::size_t process_file(const char* path, std::uint64_t start_offset = 0) {
         MemoryMappedFile file;
-        if (!file.open(path)) {
+        if (!file.open(path) || start_offset > file.size()) {
             return 0;
         }
-        return process(file.data(), file.size());
+        const std::size_t start = static_cast<std::size_t>(start_offset);
+        return process(file.data() + start, file.size() - start);
     }
     
+    const ReplayPosition& position() const noexcept { return position_; }
+    void set_position(const ReplayPosition& position) noexcept { position_ = position; }
+    
     OrderBookManager& book_manager() noexcept { return book_manager_; }
     const OrderBookManager& book_manager() const noexcept { return book_manager_; }
     
@@ -430,7 +682,11 @@ public:
     const ParserStats& parser_stats() const noexcept { return parser_.stats(); }
     
     void reset() {
+        position_ = ReplayPosition{};
         book_manager_.clear();
+        depth_deltas_.clear();
+        if (bbo_publisher_) bbo_publisher_->clear();
+        if (bar_engine_) bar_engine_->clear();
         parser_.reset_stats();
         metrics_.reset();
     }
@@ -444,6 +700,11 @@ public:
         (void)ts;
         StockLocate locate = endian::be16_to_host(msg.stock_locate);
         symbol_directory_.add_symbol(locate, msg.stock, msg.market_category, msg.financial_status);
+        // Allocate the book now, ahead of the session, rather than on its first order
+        if (locate < OrderBookManager::MAX_SYMBOLS &&
+            (!use_filter_ || symbol_filter_.count(locate) != 0)) {
+            book_manager_.open_book(locate);
+        }
         if (event_handler_) {
             Symbol sym;
             std::memcpy(sym.data, msg.stock, 8);
@@ -477,6 +738,7 @@ public:
         Side side = char_to_side(msg.buy_sell_indicator);
         
         book.add_order(order_id, side, price, quantity, ts, book_manager_.order_pool());
+        publish_bbo(locate, book, ts);
         
         if (collect_metrics_) {
             std::uint64_t end_cycles = timing::rdtscp();
@@ -508,6 +770,7 @@ public:
         Side side = char_to_side(msg.buy_sell_indicator);
         
         book.add_order(order_id, side, price, quantity, ts, book_manager_.order_pool());
+        publish_bbo(locate, book, ts);
         
         ++metrics_.orders_added;
         ++metrics_.messages_processed;
@@ -537,8 +800,10 @@ public:
             if (event_handler_) {
                 event_handler_->on_trade({locate, order->price, exec_shares, order_id, endian::be64_to_host(msg.match_number), order->side, ts});
             }
-            book.execute_order(order_id, exec_shares, book_manager_.order_pool());
+            record_trade(locate, order->price, exec_shares, msg.match_number, ts);
+            book.execute_order(order, exec_shares, book_manager_.order_pool());
         }
+        publish_bbo(locate, book, ts);
         
         ++metrics_.orders_executed;
         ++metrics_.trades;
@@ -570,8 +835,10 @@ public:
             if (event_handler_) {
                 event_handler_->on_trade({locate, exec_price, exec_shares, order_id, endian::be64_to_host(msg.match_number), order->side, ts});
             }
-            book.execute_order(order_id, exec_shares, book_manager_.order_pool());
+            if (msg.printable == 'Y') record_trade(locate, exec_price, exec_shares, msg.match_number, ts);
+            book.execute_order(order, exec_shares, book_manager_.order_pool());
         }
+        publish_bbo(locate, book, ts);
         
         ++metrics_.orders_executed;
         ++metrics_.trades;
@@ -598,6 +865,7 @@ public:
          Quantity cancel_shares = endian::be32_to_host(msg.cancelled_shares);
          
          book.cancel_order(order_id, cancel_shares, book_manager_.order_pool());
+         publish_bbo(locate, book, ts);
          
          ++metrics_.orders_cancelled;
          ++metrics_.messages_processed;
@@ -622,6 +890,7 @@ public:
         OrderId order_id = endian::be64_to_host(msg.order_ref_number);
         
         book.delete_order(order_id, book_manager_.order_pool());
+        publish_bbo(locate, book, ts);
         
         ++metrics_.orders_deleted;
         ++metrics_.messages_processed;
@@ -649,6 +918,7 @@ public:
         Price new_price = static_cast<Price>(endian::be32_to_host(msg.price));
         
         book.replace_order(old_order_id, new_order_id, new_shares, new_price, ts, book_manager_.order_pool());
+        publish_bbo(locate, book, ts);
         
         ++metrics_.orders_replaced;
         ++metrics_.messages_processed;
@@ -669,6 +939,7 @@ public:
         if (event_handler_) {
             event_handler_->on_trade({locate, static_cast<Price>(endian::be32_to_host(msg.price)), endian::be32_to_host(msg.shares), endian::be64_to_host(msg.order_ref_number), endian::be64_to_host(msg.match_number), char_to_side(msg.buy_sell_indicator), ts});
         }
+        record_trade(locate, static_cast<Price>(endian::be32_to_host(msg.price)), endian::be32_to_host(msg.shares), msg.match_number, ts);
         ++metrics_.trades;
         ++metrics_.messages_processed;
     }
@@ -680,6 +951,7 @@ public:
         if (event_handler_) {
             event_handler_->on_trade({locate, static_cast<Price>(endian::be32_to_host(msg.cross_price)), static_cast<Quantity>(endian::be64_to_host(msg.shares)), 0, endian::be64_to_host(msg.match_number), Side::Buy, ts});
         }
+        record_trade(locate, static_cast<Price>(endian::be32_to_host(msg.cross_price)), static_cast<Quantity>(endian::be64_to_host(msg.shares)), msg.match_number, ts);
          ++metrics_.trades;
         ++metrics_.messages_processed;
     }
@@ -690,7 +962,10 @@ public:
     void on_noii(const NOIIMessage&, Timestamp) {
          ++metrics_.messages_processed;
     }
-    void on_broken_trade(const BrokenTradeMessage&, Timestamp) {
+    void on_broken_trade(const BrokenTradeMessage& msg, Timestamp) {
+        if (bar_engine_) {
+            bar_engine_->on_broken_trade(endian::be16_to_host(msg.stock_locate), endian::be64_to_host(msg.match_number));
+        }
          ++metrics_.messages_processed;
     }
     void on_parse_error(const char*, std::size_t, const char*) {
@@ -703,10 +978,95 @@ private:
     SymbolDirectory symbol_directory_;
     FeedMetrics metrics_;
     FeedEventHandler* event_handler_ = nullptr;
+    DepthDeltaBuffer depth_deltas_;
+    std::unique_ptr<BBOPublisher> bbo_publisher_;
+    std::unique_ptr<BarEngine> bar_engine_;
+    ReplayPosition position_;
     
     std::set<StockLocate> symbol_filter_;
     bool use_filter_ = false;
     bool collect_metrics_ = false;
+    
+    // Warm-up state: books to warm, the idle cursor, and scratch sinks that
+    // stand in for the real ones while a synthetic batch runs
+    WarmupBatch warm_batch_;
+    std::vector<StockLocate> warm_locates_;
+    std::size_t warm_books_seen_ = 0;
+    std::size_t warm_cursor_ = 0;
+    FeedEventHandler warm_events_;
+    std::unique_ptr<BBOPublisher> warm_bbo_;
+    std::unique_ptr<BarEngine> warm_bars_;
+    
+    void refresh_warm_locates() {
+        warm_locates_.clear();
+        book_manager_.for_each_book([&](const OrderBook& book) {
+            if (!use_filter_ || symbol_filter_.count(book.stock_locate()) != 0) {
+                warm_locates_.push_back(book.stock_locate());
+            }
+        });
+        warm_books_seen_ = book_manager_.active_book_count();
+    }
+    
+    /**
+     * @brief Run one WarmupBatch per locate and undo every effect
+     *
+     * Readers and callbacks must never see synthetic data, so the event
+     * handler, BBO publisher and bar engine are swapped for scratch instances
+     * (same code paths, discarded output) for the duration. The batch itself
+     * leaves each book with exactly its previous orders and levels; what it
+     * did move is restored: book and pool high-water marks, depth deltas,
+     * metrics and parser stats. The replay position is never advanced.
+     */
+    void warm_books(const StockLocate* locates, std::size_t count) {
+        if (bbo_publisher_ && !warm_bbo_) {
+            warm_bbo_ = std::make_unique<BBOPublisher>();
+        }
+        if (bar_engine_ && !warm_bars_) {
+            std::vector<std::uint64_t> intervals;
+            for (std::size_t i = 0; i < bar_engine_->interval_count(); ++i) {
+                intervals.push_back(bar_engine_->interval_ns(i));
+            }
+            warm_bars_ = std::make_unique<BarEngine>(intervals, 1024);
+        }
+        FeedEventHandler* const events = event_handler_;
+        if (events) event_handler_ = &warm_events_;
+        bbo_publisher_.swap(warm_bbo_);
+        bar_engine_.swap(warm_bars_);
+        
+        const std::size_t deltas = depth_deltas_.size();
+        const bool deltas_overflowed = depth_deltas_.overflowed();
+        const FeedMetrics metrics = metrics_;
+        const ParserStats stats = parser_.stats();
+        const std::size_t pool_peak = book_manager_.order_pool().peak_in_use();
+        
+        for (std::size_t i = 0; i < count; ++i) {
+            OrderBook& book = book_manager_.get_book(locates[i]);
+            const BookPeaks peaks = book.peaks();
+            warm_batch_.build(locates[i], book.bbo());
+            parser_.parse(warm_batch_.data(), warm_batch_.size());
+            book.restore_peaks(peaks);
+        }
+        
+        book_manager_.order_pool().restore_peak(pool_peak);
+        parser_.restore_stats(stats);
+        metrics_ = metrics;
+        depth_deltas_.rewind(deltas, deltas_overflowed);
+        bar_engine_.swap(warm_bars_);
+        bbo_publisher_.swap(warm_bbo_);
+        event_handler_ = events;
+    }
+    
+    ITCH_FORCE_INLINE void publish_bbo(StockLocate locate, const OrderBook& book, Timestamp ts) noexcept {
+        if (bbo_publisher_) bbo_publisher_->publish(locate, book.bbo(), ts);
+    }
+    
+    /// match_number stays big-endian until the bar engine actually needs it
+    ITCH_FORCE_INLINE void record_trade(StockLocate locate, Price price, Quantity shares,
+                                        std::uint64_t match_be, Timestamp ts) noexcept {
+        if (bar_engine_ && shares != 0) {
+            bar_engine_->on_trade(locate, price, shares, endian::be64_to_host(match_be), ts);
+        }
+    }
 };
 
 } // namespace itch
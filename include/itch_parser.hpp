@@ -175,6 +175,21 @@ public:
          return messages_parsed;
     }
 
+    /**
+     * @brief Parse a BinaryFILE stream (each message preceded by its 2-byte big-endian length)
+     * @return Bytes consumed; stops at a truncated or unparseable message like parse()
+     */
+    std::size_t parse_binaryfile(const char* data, std::size_t len) noexcept {
+        std::size_t offset = 0;
+        while (len - offset >= 2) {
+            const std::uint16_t msg_len = endian::be16_to_host(*reinterpret_cast<const std::uint16_t*>(data + offset));
+            if (len - offset - 2 < msg_len) break;
+            if (parse_message(data + offset + 2, msg_len) == 0) break;
+            offset += 2 + static_cast<std::size_t>(msg_len);
+        }
+        return offset;
+    }
+
     const ParserStats& stats() const noexcept { return stats_; }
     void reset_stats() noexcept { stats_.reset(); }
 
@@ -226,7 +241,7 @@ private:
 template<typename Handler>
 class TemplateParser {
 public:
-    TemplateParser(Handler* handler) : handler_(handler) {}
+    TemplateParser(Handler* handler = nullptr) : handler_(handler) {}
 
     ITCH_FORCE_INLINE std::size_t parse_message(const char* data, std::size_t max_len) noexcept {
         if (ITCH_UNLIKELY(max_len == 0)) return 0;
@@ -240,6 +255,9 @@ public:
         
         dispatch(msg_type, data, ts);
         
+        ++stats_.messages_parsed;
+        stats_.bytes_processed += msg_size;
+        
         return msg_size;
     }
     
@@ -273,9 +291,27 @@ public:
          return messages_parsed;
     }
 
+    /**
+     * @brief Parse a BinaryFILE stream (each message preceded by its 2-byte big-endian length)
+     * @return Bytes consumed; stops at a truncated or unparseable message like parse()
+     */
+    std::size_t parse_binaryfile(const char* data, std::size_t len) noexcept {
+        std::size_t offset = 0;
+        while (len - offset >= 2) {
+            const std::uint16_t msg_len = endian::be16_to_host(*reinterpret_cast<const std::uint16_t*>(data + offset));
+            if (len - offset - 2 < msg_len) break;
+            if (parse_message(data + offset + 2, msg_len) == 0) break;
+            offset += 2 + static_cast<std::size_t>(msg_len);
+        }
+        return offset;
+    }
+
     const ParserStats& stats() const noexcept { return stats_; }
 
     void reset_stats() noexcept { stats_.reset(); }
+    
+    /// Put back stats saved by the caller (e.g. after a rolled-back warm-up)
+    void restore_stats(const ParserStats& stats) noexcept { stats_ = stats; }
 
 private:
     Handler* handler_;
@@ -4,28 +4,37 @@
  * 
  * Features:
  * - Price-time priority order book
- * - O(1) order lookup by ID (Linear Probing Hash Map)
+ * - O(1) order lookup by ID (Linear Probing Hash Map, or SIMD group probing)
  * - Cache-friendly price level operations (Flat Sorted Vector)
  * - Object pool for minimal heap allocations
  * - Cache-aligned Order struct
  * - Multi-symbol support with efficient symbol lookup
  * - BBO (Best Bid/Offer) caching
- * - Market depth snapshots
+ * - Market depth snapshots (allocation-free, optionally from a cached top N)
+ * - Incremental market-by-price depth deltas (top N levels)
  */
 
 #pragma once
 
 #include "common.hpp"
 #include "message_types.hpp"
+#include "swiss_order_map.hpp"
+#include "paged_order_map.hpp"
 #include <map>
 #include <vector>
 #include <array>
 #include <memory>
 #include <cstring>
+#include <cstdlib>
 #include <algorithm>
 #include <limits>
 #include <cassert>
 #include <optional>
+#include <type_traits>
+#include <utility>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 namespace itch {
 
@@ -38,6 +47,21 @@ namespace itch {
  * 
  * Pre-allocates a fixed number of orders to avoid heap allocation
  * during hot path processing.
+ *
+ * Growth modes:
+ * - default:     acquire() allocates the next block inline when the free
+ *                list runs dry
+ * - background:  enable_background_refill(); a helper thread allocates and
+ *                prefaults the next block once available() drops below a low
+ *                watermark and parks it in a single-slot handoff, together
+ *                with a free list big enough to take back every object.
+ *                acquire() adopts both when the free list runs dry, so
+ *                release() never grows the free list on the feed thread;
+ *                it only allocates inline (counted in inline_blocks()) if
+ *                the helper is late.
+ * - hard cap:    set_hard_capacity(); everything is allocated up front and
+ *                acquire() returns nullptr (counted in exhausted()) instead
+ *                of growing.
  */
 template<typename T, std::size_t BlockSize = 4096>
 class ObjectPool {
@@ -47,6 +71,7 @@ public:
     }
     
     ~ObjectPool() {
+        stop_refill_thread();
         for (auto* block : blocks_) {
             delete[] block;
         }
@@ -57,14 +82,17 @@ public:
     ObjectPool& operator=(const ObjectPool&) = delete;
     
     /**
-     * @brief Acquire an object from the pool
+     * @brief Acquire an object from the pool (nullptr only in hard-cap mode)
      */
     T* acquire() noexcept {
-        if (ITCH_UNLIKELY(free_list_.empty())) {
-            allocate_block();
+        if (ITCH_UNLIKELY(free_list_.size() <= low_watermark_)) {
+            T* obj = acquire_slow();
+            if (obj) note_acquired();
+            return obj;
         }
         T* obj = free_list_.back();
         free_list_.pop_back();
+        note_acquired();
         return obj;
     }
     
@@ -73,6 +101,7 @@ public:
      */
     void release(T* obj) noexcept {
         free_list_.push_back(obj);
+        --in_use_;
     }
     
     /**
@@ -83,21 +112,219 @@ public:
     }
     
     std::size_t available() const noexcept { 
-        return free_list_.size(); 
+        return free_list_.size() + static_cast<std::size_t>(bump_end_ - bump_);
+    }
+    
+    /// Objects the free list holds without reallocating
+    std::size_t free_list_capacity() const noexcept { return free_list_.capacity(); }
+    
+    /// Blocks allocated on the acquiring thread in background mode (helper late)
+    std::size_t inline_blocks() const noexcept { return inline_blocks_; }
+    
+    /// acquire() calls refused in hard-cap mode
+    std::size_t exhausted() const noexcept { return exhausted_; }
+    
+    /// Most objects out at once since construction or reset_peak()
+    std::size_t peak_in_use() const noexcept { return peak_in_use_; }
+    void reset_peak() noexcept { peak_in_use_ = in_use_; }
+    
+    /// Put back a peak saved by the caller (e.g. after a rolled-back warm-up)
+    void restore_peak(std::size_t peak) noexcept { peak_in_use_ = std::max(peak, in_use_); }
+    
+    /**
+     * @brief Fault in every block and the free list's capacity
+     */
+    void prefault() noexcept {
+        for (T* block : blocks_) {
+            prefault_pages(block, BlockSize * sizeof(T));
+        }
+        prefault_pages(free_list_.data(), free_list_.capacity() * sizeof(T*));
+    }
+    
+    /**
+     * @brief Grow the pool up front so at least `count` objects are available
+     */
+    void reserve(std::size_t count) {
+        while (available() < count) {
+            allocate_block();
+        }
+    }
+    
+    /**
+     * @brief Move block allocation to a helper thread (see class comment)
+     *
+     * Call before the feed starts; the watermark should leave the helper a
+     * few hundred microseconds of adds to deliver the next block in.
+     */
+    void enable_background_refill(std::size_t low_watermark = BlockSize / 2) {
+        if (refill_thread_.joinable() || hard_capacity_) return;
+        low_watermark_ = low_watermark;
+        refill_stop_.store(false, std::memory_order_relaxed);
+        refill_thread_ = std::thread([this] { refill_loop(); });
+    }
+    
+    /**
+     * @brief Preallocate (and prefault) so `count` objects are available,
+     * then never grow
+     */
+    void set_hard_capacity(std::size_t count) {
+        stop_refill_thread();
+        while (available() < count) {
+            allocate_block(true);
+        }
+        hard_capacity_ = true;
+        low_watermark_ = 0;
     }
+    
+    bool background_refill() const noexcept { return refill_thread_.joinable(); }
+    bool hard_capacity() const noexcept { return hard_capacity_; }
 
 private:
+    static constexpr auto REFILL_POLL = std::chrono::microseconds(20);
+
     std::vector<T*> blocks_;
     std::vector<T*> free_list_;
     
-    void allocate_block() {
-        T* block = new T[BlockSize];
+    // Untouched tail of a block adopted from the helper (background mode):
+    // handed out directly instead of pushing BlockSize pointers on adoption
+    T* bump_ = nullptr;
+    T* bump_end_ = nullptr;
+    
+    std::size_t low_watermark_ = 0;     // acquire() takes the slow path at or below this
+    bool hard_capacity_ = false;
+    bool refill_pending_ = false;       // Request issued, block not yet adopted
+    std::size_t inline_blocks_ = 0;
+    std::size_t exhausted_ = 0;
+    std::size_t in_use_ = 0;
+    std::size_t peak_in_use_ = 0;
+    
+    /// What the helper hands over: a block, and an empty free list with
+    /// room for every object once that block is adopted
+    struct Refill {
+        T* block = nullptr;
+        std::vector<T*> free_list;
+    };
+    
+    std::thread refill_thread_;
+    std::atomic<Refill*> handoff_{nullptr};     // Single-slot exchange: helper -> acquirer
+    std::atomic<Refill*> retired_{nullptr};     // Acquirer -> helper: replaced free list to free
+    std::atomic<std::size_t> refill_capacity_{0};
+    std::atomic<bool> refill_requested_{false};
+    std::atomic<bool> refill_stop_{false};
+    
+    void note_acquired() noexcept {
+        if (++in_use_ > peak_in_use_) peak_in_use_ = in_use_;
+    }
+    
+    void allocate_block(bool prefault = false) {
+        T* block = prefault ? new T[BlockSize]() : new T[BlockSize];
         blocks_.push_back(block);
         free_list_.reserve(free_list_.size() + BlockSize);
         for (std::size_t i = 0; i < BlockSize; ++i) {
             free_list_.push_back(&block[i]);
         }
     }
+    
+    ITCH_NOINLINE T* acquire_slow() noexcept {
+        if (!refill_thread_.joinable()) {
+            if (free_list_.empty()) {
+                if (hard_capacity_) {
+                    ++exhausted_;
+                    return nullptr;
+                }
+                allocate_block();
+            }
+            T* obj = free_list_.back();
+            free_list_.pop_back();
+            return obj;
+        }
+        
+        if (!refill_pending_ && available() <= low_watermark_) {
+            refill_pending_ = true;
+            refill_capacity_.store((blocks_.size() + 1) * BlockSize, std::memory_order_relaxed);
+            refill_requested_.store(true, std::memory_order_release);
+        }
+        if (!free_list_.empty()) {
+            T* obj = free_list_.back();
+            free_list_.pop_back();
+            return obj;
+        }
+        if (bump_ == bump_end_) {
+            T* block;
+            if (Refill* refill = handoff_.exchange(nullptr, std::memory_order_acquire)) {
+                refill_pending_ = false;
+                block = refill->block;
+                adopt_free_list(*refill);
+                // The helper frees the old free list; if it has not collected
+                // the previous one yet, that one goes inline (rare)
+                delete retired_.exchange(refill, std::memory_order_acq_rel);
+            } else {
+                block = new T[BlockSize];
+                ++inline_blocks_;
+            }
+            blocks_.push_back(block);
+            // Only when the helper's free list fell short (late helper, or
+            // inline blocks since the request); grow geometrically
+            const std::size_t needed = blocks_.size() * BlockSize;
+            if (ITCH_UNLIKELY(free_list_.capacity() < needed)) {
+                free_list_.reserve(std::max(needed, free_list_.capacity() * 2));
+            }
+            bump_ = block;
+            bump_end_ = block + BlockSize;
+        }
+        return bump_++;
+    }
+    
+    /// Swap in the helper's larger free list; ours is empty or nearly so here
+    void adopt_free_list(Refill& refill) noexcept {
+        if (refill.free_list.capacity() > free_list_.capacity()) {
+            refill.free_list.assign(free_list_.begin(), free_list_.end());
+            free_list_.swap(refill.free_list);
+        }
+        refill.block = nullptr;
+    }
+    
+    void refill_loop() {
+        while (!refill_stop_.load(std::memory_order_acquire)) {
+            if (Refill* retired = retired_.exchange(nullptr, std::memory_order_acquire)) {
+                delete retired;
+            }
+            if (refill_requested_.load(std::memory_order_acquire) &&
+                handoff_.load(std::memory_order_relaxed) == nullptr) {
+                // Value-initialising writes every byte, so the pages are
+                // faulted in here rather than on the acquiring thread
+                auto* refill = new Refill;
+                refill->block = new T[BlockSize]();
+                refill->free_list.reserve(refill_capacity_.load(std::memory_order_relaxed));
+                prefault_pages(refill->free_list.data(),
+                               refill->free_list.capacity() * sizeof(T*));
+                refill_requested_.store(false, std::memory_order_relaxed);
+                handoff_.store(refill, std::memory_order_release);
+            } else {
+                std::this_thread::sleep_for(REFILL_POLL);
+            }
+        }
+    }
+    
+    void stop_refill_thread() {
+        if (!refill_thread_.joinable()) return;
+        refill_stop_.store(true, std::memory_order_release);
+        refill_thread_.join();
+        if (Refill* refill = handoff_.exchange(nullptr, std::memory_order_acquire)) {
+            delete[] refill->block;
+            delete refill;
+        }
+        delete retired_.exchange(nullptr, std::memory_order_acquire);
+        refill_requested_.store(false, std::memory_order_relaxed);
+        refill_pending_ = false;
+        low_watermark_ = 0;
+        // The inline slow path only draws from the free list
+        free_list_.reserve(free_list_.size() + static_cast<std::size_t>(bump_end_ - bump_));
+        for (; bump_ != bump_end_; ++bump_) {
+            free_list_.push_back(bump_);
+        }
+        bump_ = bump_end_ = nullptr;
+    }
 };
 
 // =============================================================================
@@ -107,56 +334,196 @@ private:
 struct Order; // Forward declaration
 
 /**
- * @brief High-performance linear probing hash map for OrderId -> Order*
+ * @brief High-performance linear probing hash map for OrderId -> V
+ *
+ * V is the book's order handle: Order* (OrderMap) or a CompactOrderHandle;
+ * a value-initialised V is the null handle.
  * 
  * Avoids the linked-list overhead of std::unordered_map.
  * Fixed Load Factor ~0.5-0.7 for speed.
+ *
+ * Growth is incremental: crossing 50% load allocates the doubled table
+ * (calloc, so pages are zeroed lazily by the OS) and every later mutation
+ * copies the next MIGRATE_STEP old buckets into it. The old table is never
+ * reshuffled while it drains, so a lookup that misses the new table probes
+ * it as usual and trusts only buckets at or past the copy cursor; an order
+ * extracted from there keeps its bucket (probe chains stay intact) with a
+ * null order. Orders stored in the map must therefore be non-null. Small
+ * tables (< INCREMENTAL_MIN) still rehash in one go, as does reserve().
  */
-class OrderMap {
+template<typename V>
+class BasicOrderMap {
 public:
-    explicit OrderMap(std::size_t initial_capacity = 100000) {
+    static constexpr std::size_t MIGRATE_STEP = 16;
+    static constexpr std::size_t INCREMENTAL_MIN = 4096;
+
+    explicit BasicOrderMap(std::size_t initial_capacity = 100000) {
         resize(initial_capacity);
     }
 
-    Order* find(OrderId id) const noexcept {
-        std::size_t idx = hash(id) & mask_;
-        while (entries_[idx].id != 0) {
-            if (entries_[idx].id == id) {
-                return entries_[idx].order;
-            }
-            idx = (idx + 1) & mask_;
+    V find(OrderId id) const noexcept {
+        if (V order = find_in(entries_.get(), mask_, id)) {
+            return order;
         }
-        return nullptr;
+        if (ITCH_UNLIKELY(old_entries_ != nullptr)) {
+            const Entry* e = find_unmigrated(id);
+            return e ? e->order : V{};
+        }
+        return V{};
     }
 
-    void put(OrderId id, Order* order) noexcept {
-        if (ITCH_UNLIKELY(load_ * 2 >= capacity_)) {
-            resize(capacity_ * 2);
-        }
-        
+    void put(OrderId id, V order) noexcept {
+        prepare_insert();
+        place(entries_.get(), mask_, id, order);
+        load_++;
+    }
+
+    /**
+     * @brief put() that refuses an id already present (the probe visits it anyway)
+     */
+    bool insert(OrderId id, V order) noexcept {
+        prepare_insert();
         std::size_t idx = hash(id) & mask_;
         while (entries_[idx].id != 0) {
+            if (entries_[idx].id == id) {
+                return false;
+            }
             idx = (idx + 1) & mask_;
         }
+        if (ITCH_UNLIKELY(old_entries_ != nullptr)) {
+            const Entry* e = find_unmigrated(id);
+            if (e && e->order) {
+                return false;
+            }
+        }
         entries_[idx] = {id, order};
         load_++;
+        return true;
     }
 
     void remove(OrderId id) noexcept {
-        std::size_t idx = hash(id) & mask_;
-        while (entries_[idx].id != 0) {
-            if (entries_[idx].id == id) {
+        extract(id);
+    }
+    
+    /**
+     * @brief Remove `id` and return its order in a single probe sequence
+     */
+    V extract(OrderId id) noexcept {
+        V order = extract_from(entries_.get(), mask_, id);
+        if (ITCH_UNLIKELY(old_entries_ != nullptr)) {
+            if (!order) {
+                if (Entry* e = find_unmigrated(id)) {
+                    order = e->order;
+                    e->order = V{};
+                }
+            }
+            migrate(MIGRATE_STEP);
+        }
+        if (order) {
+            load_--;
+        }
+        return order;
+    }
+    
+    void clear() noexcept {
+        old_entries_.reset();
+        std::memset(static_cast<void*>(entries_.get()), 0, capacity_ * sizeof(Entry));
+        load_ = 0;
+    }
+    
+    /**
+     * @brief Presize so `count` entries fit without crossing the resize threshold
+     *
+     * Rehashes synchronously; call it before the session (e.g. from an
+     * expected-peak hint) to keep growth off the feed path entirely.
+     */
+    void reserve(std::size_t count) {
+        if (count * 2 >= capacity_) {
+            resize(count * 2 + 1);
+        } else if (old_entries_) {
+            migrate(old_capacity_);
+        }
+    }
+    
+    std::size_t size() const noexcept { return load_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    /**
+     * @brief Fault in the table's calloc'd pages ahead of the session
+     */
+    void prefault() noexcept {
+        prefault_pages(entries_.get(), capacity_ * sizeof(Entry));
+    }
+
+    /// True while an incremental resize is still draining the old table
+    bool resizing() const noexcept { return old_entries_ != nullptr; }
+
+private:
+    struct Entry {
+        OrderId id;
+        V order;
+    };
+
+    struct FreeDeleter {
+        void operator()(Entry* p) const noexcept { std::free(p); }
+    };
+    using EntryArray = std::unique_ptr<Entry[], FreeDeleter>;
+    
+    EntryArray entries_;
+    std::size_t capacity_ = 0;
+    std::size_t mask_ = 0;
+    std::size_t load_ = 0;          // Entries in both tables
+
+    // Table being drained by an incremental resize (null otherwise)
+    EntryArray old_entries_;
+    std::size_t old_capacity_ = 0;
+    std::size_t old_mask_ = 0;
+    std::size_t migrate_pos_ = 0;   // Old buckets below this are copied
+
+    static std::size_t hash(OrderId id) noexcept {
+        return static_cast<std::size_t>(id);
+    }
+
+    static EntryArray allocate(std::size_t cap) noexcept {
+        // All-zero bytes is an empty Entry; large callocs come straight from
+        // fresh mmap pages, so nothing is written up front.
+        return EntryArray(static_cast<Entry*>(std::calloc(cap, sizeof(Entry))));
+    }
+
+    static V find_in(const Entry* entries, std::size_t mask, OrderId id) noexcept {
+        std::size_t idx = hash(id) & mask;
+        while (entries[idx].id != 0) {
+            if (entries[idx].id == id) {
+                return entries[idx].order;
+            }
+            idx = (idx + 1) & mask;
+        }
+        return V{};
+    }
+
+    static void place(Entry* entries, std::size_t mask, OrderId id, V order) noexcept {
+        std::size_t idx = hash(id) & mask;
+        while (entries[idx].id != 0) {
+            idx = (idx + 1) & mask;
+        }
+        entries[idx] = {id, order};
+    }
+
+    static V extract_from(Entry* entries, std::size_t mask, OrderId id) noexcept {
+        std::size_t idx = hash(id) & mask;
+        while (entries[idx].id != 0) {
+            if (entries[idx].id == id) {
+                V order = entries[idx].order;
                 // Determine if we need to shift subsequent elements back
                 // Simple deletion without tombstones requires backshifting
-                entries_[idx].id = 0;
-                load_--;
+                entries[idx].id = 0;
                 
                 // Backshift (rehash) subsequent items in the cluster
                 std::size_t curr = idx;
-                std::size_t next = (curr + 1) & mask_;
+                std::size_t next = (curr + 1) & mask;
                 
-                while (entries_[next].id != 0) {
-                    std::size_t desired = hash(entries_[next].id) & mask_;
+                while (entries[next].id != 0) {
+                    std::size_t desired = hash(entries[next].id) & mask;
                     // If desired is between curr and next (cyclically), it stays.
                     // If strictly outside (curr, next], it belongs at curr (or earlier).
                     // Logic: we want to move 'next' to 'curr' if 'next' is NOT in its ideal position
@@ -168,36 +535,77 @@ public:
                         // Element is validly placed
                     } else {
                         // Move element back
-                        entries_[curr] = entries_[next];
-                        entries_[next].id = 0;
+                        entries[curr] = entries[next];
+                        entries[next].id = 0;
                         curr = next;
                     }
-                    next = (next + 1) & mask_;
+                    next = (next + 1) & mask;
                 }
-                return;
+                return order;
             }
-            idx = (idx + 1) & mask_;
+            idx = (idx + 1) & mask;
         }
+        return V{};
     }
-    
-    void clear() noexcept {
-        std::fill(entries_.begin(), entries_.end(), Entry{0, nullptr});
-        load_ = 0;
+
+    void prepare_insert() noexcept {
+        if (ITCH_UNLIKELY(old_entries_ != nullptr)) {
+            migrate(MIGRATE_STEP);
+        }
+        if (ITCH_UNLIKELY(load_ * 2 >= capacity_)) {
+            if (capacity_ < INCREMENTAL_MIN) {
+                resize(capacity_ * 2);
+            } else {
+                begin_resize();
+            }
+        }
     }
 
-private:
-    struct Entry {
-        OrderId id;
-        Order* order;
-    };
-    
-    std::vector<Entry> entries_;
-    std::size_t capacity_ = 0;
-    std::size_t mask_ = 0;
-    std::size_t load_ = 0;
+    /**
+     * @brief Old-table entry for `id` that has not been copied yet, or nullptr
+     */
+    Entry* find_unmigrated(OrderId id) const noexcept {
+        Entry* old = old_entries_.get();
+        std::size_t idx = hash(id) & old_mask_;
+        while (old[idx].id != 0) {
+            if (old[idx].id == id) {
+                return idx >= migrate_pos_ ? &old[idx] : nullptr;
+            }
+            idx = (idx + 1) & old_mask_;
+        }
+        return nullptr;
+    }
 
-    static std::size_t hash(OrderId id) noexcept {
-        return static_cast<std::size_t>(id);
+    void begin_resize() noexcept {
+        if (old_entries_) {
+            migrate(old_capacity_);     // Previous resize outpaced; finish it first
+        }
+        old_entries_ = std::move(entries_);
+        old_capacity_ = capacity_;
+        old_mask_ = mask_;
+        migrate_pos_ = 0;
+
+        capacity_ *= 2;
+        mask_ = capacity_ - 1;
+        entries_ = allocate(capacity_);
+    }
+
+    /**
+     * @brief Copy the next `budget` old buckets into the new table
+     */
+    void migrate(std::size_t budget) noexcept {
+        const Entry* old = old_entries_.get();
+        const std::size_t end = std::min(old_capacity_, migrate_pos_ + budget);
+        for (; migrate_pos_ < end; ++migrate_pos_) {
+            const Entry& e = old[migrate_pos_];
+            if (e.id != 0 && e.order) {
+                place(entries_.get(), mask_, e.id, e.order);
+            }
+        }
+        if (migrate_pos_ == old_capacity_) {
+            old_entries_.reset();
+            old_capacity_ = 0;
+        }
     }
 
     void resize(std::size_t new_cap) {
@@ -205,30 +613,60 @@ private:
         std::size_t cap = 1;
         while (cap < new_cap) cap <<= 1;
         
-        std::vector<Entry> old_entries = std::move(entries_);
-        entries_.resize(cap, {0, nullptr});
+        EntryArray previous = std::move(entries_);
+        const std::size_t previous_capacity = capacity_;
+        entries_ = allocate(cap);
         capacity_ = cap;
         mask_ = cap - 1;
-        load_ = 0;
 
-        for (const auto& e : old_entries) {
-            if (e.id != 0) {
-                // Re-insert
-                std::size_t idx = hash(e.id) & mask_;
-                while (entries_[idx].id != 0) {
-                    idx = (idx + 1) & mask_;
-                }
-                entries_[idx] = e;
-                load_++;
+        for (std::size_t i = 0; i < previous_capacity; ++i) {
+            if (previous[i].id != 0) {
+                place(entries_.get(), mask_, previous[i].id, previous[i].order);
+            }
+        }
+        for (std::size_t i = migrate_pos_; old_entries_ && i < old_capacity_; ++i) {
+            if (old_entries_[i].id != 0 && old_entries_[i].order) {
+                place(entries_.get(), mask_, old_entries_[i].id, old_entries_[i].order);
             }
         }
+        old_entries_.reset();
+        old_capacity_ = 0;
     }
 };
 
+/**
+ * @brief Order-id index used by OrderBook
+ *
+ * OrderMap by default; define ITCH_SWISS_ORDER_INDEX or ITCH_PAGED_ORDER_INDEX
+ * (CMake options of the same names) to build every book on SwissOrderMap or
+ * PagedOrderMap instead. BasicOrderIndex<V> is the same choice for other
+ * order handles (see CompactOrderLayout).
+ */
+using OrderMap = BasicOrderMap<Order*>;
+
+#if defined(ITCH_SWISS_ORDER_INDEX)
+template<typename V>
+using BasicOrderIndex = BasicSwissOrderMap<V>;
+#elif defined(ITCH_PAGED_ORDER_INDEX)
+template<typename V>
+using BasicOrderIndex = BasicPagedOrderMap<V>;
+#else
+template<typename V>
+using BasicOrderIndex = BasicOrderMap<V>;
+#endif
+
+using OrderIndex = BasicOrderIndex<Order*>;
+
 // =============================================================================
 // Order Structure
 // =============================================================================
 
+template<typename Layout> class BasicPriceLevel;
+struct WideOrderLayout;
+struct CompactOrderLayout;
+
+using PriceLevel = BasicPriceLevel<WideOrderLayout>;
+
 /**
  * @brief Order in the book (cache-line aligned for performance)
  */
@@ -243,6 +681,7 @@ struct ITCH_CACHE_ALIGNED Order {
     Timestamp       timestamp;      // 8 bytes
     Order*          next;           // 8 bytes
     Order*          prev;           // 8 bytes
+    PriceLevel*     level;          // 8 bytes (set by PriceLevel::add_order)
     
     Order() noexcept = default;
     
@@ -256,69 +695,235 @@ struct ITCH_CACHE_ALIGNED Order {
         timestamp = 0;
         next = nullptr;
         prev = nullptr;
+        level = nullptr;
     }
 };
 
 static_assert(sizeof(Order) == 64, "Order must be cache-line aligned (64 bytes)");
 
+// =============================================================================
+// Compact Order Layout (hot/cold split)
+// =============================================================================
+
+/**
+ * @brief Index of an order in a CompactOrderStore (0 = null)
+ *
+ * A distinct type rather than a bare uint32_t so book overloads taking an
+ * OrderId or a handle never collide.
+ */
+struct CompactOrderHandle {
+    std::uint32_t index = 0;
+
+    explicit operator bool() const noexcept { return index != 0; }
+    bool operator==(CompactOrderHandle other) const noexcept { return index == other.index; }
+    bool operator!=(CompactOrderHandle other) const noexcept { return index != other.index; }
+};
+
+/**
+ * @brief Fields touched by execute/cancel/delete and level list walks
+ */
+struct CompactOrder {
+    BasicPriceLevel<CompactOrderLayout>* level;     // 8 bytes
+    Quantity            quantity;                   // 4 bytes
+    CompactOrderHandle  next;                       // 4 bytes
+    CompactOrderHandle  prev;                       // 4 bytes
+    Side                side;                       // 1 byte
+};
+
+/**
+ * @brief Fields only read on add/replace and by snapshots (parallel array)
+ *
+ * The price also lives on the level; this copy serves for_each_order().
+ */
+struct CompactOrderCold {
+    OrderId         order_id;       // 8 bytes
+    Price           price;          // 8 bytes
+    Timestamp       timestamp;      // 8 bytes
+    Quantity        original_qty;   // 4 bytes
+    StockLocate     stock_locate;   // 2 bytes
+};
+
+static_assert(sizeof(CompactOrder) == 24, "CompactOrder must stay within 24 bytes");
+static_assert(sizeof(CompactOrderCold) == 32, "CompactOrderCold must be 32 bytes");
+
+/**
+ * @brief Order storage for the compact layout: parallel hot and cold arrays
+ *
+ * A handle indexes both arrays, so an order costs 24 hot + 32 cold bytes and
+ * a level walk streams through 24-byte records instead of 64-byte lines.
+ * Released slots are recycled LIFO. The arrays grow by doubling (handles are
+ * indices, so nothing dangles); reserve() keeps that off the feed path.
+ */
+class CompactOrderStore {
+public:
+    explicit CompactOrderStore(std::size_t initial_capacity = 4096) {
+        reserve(initial_capacity);
+    }
+
+    CompactOrderHandle acquire() {
+        if (ITCH_LIKELY(!free_list_.empty())) {
+            const CompactOrderHandle h = free_list_.back();
+            free_list_.pop_back();
+            note_acquired();
+            return h;
+        }
+        if (ITCH_UNLIKELY(hot_.size() >= std::numeric_limits<std::uint32_t>::max())) {
+            return CompactOrderHandle{};
+        }
+        const CompactOrderHandle h{static_cast<std::uint32_t>(hot_.size())};
+        hot_.emplace_back();
+        cold_.emplace_back();
+        note_acquired();
+        return h;
+    }
+
+    void release(CompactOrderHandle h) {
+        free_list_.push_back(h);
+        --in_use_;
+    }
+
+    /**
+     * @brief Make room for `count` orders without growing either array
+     */
+    void reserve(std::size_t count) {
+        hot_.reserve(count + 1);
+        cold_.reserve(count + 1);
+        free_list_.reserve(count);
+    }
+
+    CompactOrder& hot(CompactOrderHandle h) noexcept { return hot_[h.index]; }
+    const CompactOrder& hot(CompactOrderHandle h) const noexcept { return hot_[h.index]; }
+    CompactOrderCold& cold(CompactOrderHandle h) noexcept { return cold_[h.index]; }
+    const CompactOrderCold& cold(CompactOrderHandle h) const noexcept { return cold_[h.index]; }
+
+    std::size_t available() const noexcept {
+        return free_list_.size() + (hot_.capacity() - hot_.size());
+    }
+    std::size_t capacity() const noexcept { return hot_.capacity() - 1; }
+
+    /// Most orders out at once since construction or reset_peak()
+    std::size_t peak_in_use() const noexcept { return peak_in_use_; }
+    void reset_peak() noexcept { peak_in_use_ = in_use_; }
+    void restore_peak(std::size_t peak) noexcept { peak_in_use_ = std::max(peak, in_use_); }
+
+    /**
+     * @brief Fault in the reserved capacity of both arrays and the free list
+     */
+    void prefault() noexcept {
+        prefault_pages(hot_.data(), hot_.capacity() * sizeof(CompactOrder));
+        prefault_pages(cold_.data(), cold_.capacity() * sizeof(CompactOrderCold));
+        prefault_pages(free_list_.data(), free_list_.capacity() * sizeof(CompactOrderHandle));
+    }
+
+private:
+    std::vector<CompactOrder> hot_{1};          // Slot 0 backs the null handle
+    std::vector<CompactOrderCold> cold_{1};
+    std::vector<CompactOrderHandle> free_list_;
+    std::size_t in_use_ = 0;
+    std::size_t peak_in_use_ = 0;
+
+    void note_acquired() noexcept {
+        if (++in_use_ > peak_in_use_) peak_in_use_ = in_use_;
+    }
+};
+
+/**
+ * @brief Order layouts for BasicPriceLevel / BasicOrderBook
+ *
+ * A layout names the order handle, the hot record (quantity, side, next, prev,
+ * level), the cold record (order_id, price, original_qty, stock_locate,
+ * timestamp) and the store that owns them. hot()/cold() map a handle to its
+ * records; the store pointer may be null for layouts that do not need it.
+ */
+struct WideOrderLayout {
+    using Handle = Order*;
+    using Hot = Order;
+    using Cold = Order;
+    using Store = ObjectPool<Order>;
+
+    static Order& hot(const Store*, Order* order) noexcept { return *order; }
+    static Order& cold(const Store*, Order* order) noexcept { return *order; }
+};
+
+struct CompactOrderLayout {
+    using Handle = CompactOrderHandle;
+    using Hot = CompactOrder;
+    using Cold = CompactOrderCold;
+    using Store = CompactOrderStore;
+
+    static Hot& hot(Store* store, Handle h) noexcept { return store->hot(h); }
+    static const Hot& hot(const Store* store, Handle h) noexcept { return store->hot(h); }
+    static Cold& cold(Store* store, Handle h) noexcept { return store->cold(h); }
+    static const Cold& cold(const Store* store, Handle h) noexcept { return store->cold(h); }
+};
+
 // =============================================================================
 // Price Level
 // =============================================================================
 
 /**
  * @brief Price level containing all orders at a specific price
- * 
- * Maintains a doubly-linked list of orders.
+ *
+ * Maintains a doubly-linked list of orders. `store` resolves handles and is
+ * only needed by layouts whose handles are not pointers.
  */
-class PriceLevel {
+template<typename Layout>
+class BasicPriceLevel {
 public:
-    PriceLevel() noexcept = default;
+    using Handle = typename Layout::Handle;
+    using Store = typename Layout::Store;
+    
+    BasicPriceLevel() noexcept = default;
     
-    explicit PriceLevel(Price price) noexcept 
+    explicit BasicPriceLevel(Price price) noexcept
         : price_(price) {}
     
-    void add_order(Order* order) noexcept {
-        order->prev = tail_;
-        order->next = nullptr;
-        
+    void add_order(Handle order, Store* store = nullptr) noexcept {
+        auto& o = Layout::hot(store, order);
+        o.prev = tail_;
+        o.next = Handle{};
+        o.level = this;
+    
         if (tail_) {
-            tail_->next = order;
+            Layout::hot(store, tail_).next = order;
         } else {
             head_ = order;
         }
         tail_ = order;
-        
-        total_quantity_ += order->quantity;
+    
+        total_quantity_ += o.quantity;
         ++order_count_;
     }
     
-    void remove_order(Order* order) noexcept {
-        total_quantity_ -= order->quantity;
+    void remove_order(Handle order, Store* store = nullptr) noexcept {
+        auto& o = Layout::hot(store, order);
+        total_quantity_ -= o.quantity;
         --order_count_;
-        
-        if (order->prev) {
-            order->prev->next = order->next;
+    
+        if (o.prev) {
+            Layout::hot(store, o.prev).next = o.next;
         } else {
-            head_ = order->next;
+            head_ = o.next;
         }
-        
-        if (order->next) {
-            order->next->prev = order->prev;
+    
+        if (o.next) {
+            Layout::hot(store, o.next).prev = o.prev;
         } else {
-            tail_ = order->prev;
+            tail_ = o.prev;
         }
-        
-        order->next = nullptr;
-        order->prev = nullptr;
+    
+        o.next = Handle{};
+        o.prev = Handle{};
     }
     
-    void reduce_quantity(Order* order, Quantity delta) noexcept {
-        assert(order->quantity >= delta);
-        order->quantity -= delta;
+    void reduce_quantity(Handle order, Quantity delta, Store* store = nullptr) noexcept {
+        auto& o = Layout::hot(store, order);
+        assert(o.quantity >= delta);
+        o.quantity -= delta;
         total_quantity_ -= delta;
-        
-        if (order->quantity == 0) {
-            remove_order(order);
+    
+        if (o.quantity == 0) {
+            remove_order(order, store);
         }
     }
     
@@ -326,16 +931,18 @@ public:
     Quantity total_quantity() const noexcept { return total_quantity_; }
     std::size_t order_count() const noexcept { return order_count_; }
     bool empty() const noexcept { return order_count_ == 0; }
-    Order* front() const noexcept { return head_; }
-    Order* back() const noexcept { return tail_; }
+    Handle front() const noexcept { return head_; }
+    Handle back() const noexcept { return tail_; }
 
 private:
     Price price_ = 0;
-    Order* head_ = nullptr;
-    Order* tail_ = nullptr;
+    Handle head_ = Handle{};
+    Handle tail_ = Handle{};
     Quantity total_quantity_ = 0;
     std::size_t order_count_ = 0;
 };
+    
+using CompactPriceLevel = BasicPriceLevel<CompactOrderLayout>;
 
 // =============================================================================
 // Best Bid/Offer (BBO)
@@ -368,220 +975,724 @@ struct DepthLevel {
 };
 
 // =============================================================================
-// Order Book (Single Symbol)
+// Market-By-Price Depth Deltas
 // =============================================================================
 
 /**
- * @brief Full depth order book for a single symbol
- * 
- * Optimized:
- * - Uses std::vector<PriceLevel> w/ std::lower_bound for Price Levels (cache locality)
- * - Uses custom OrderMap (Linear Probing) for Orders
+ * @brief Level update action (market-by-price semantics)
+ *
+ * New inserts a level at `level` and shifts deeper levels down; Delete removes
+ * the level at `level` and shifts deeper levels up. A consumer that applies
+ * deltas in order to an N-entry array per side reproduces bid_depth(N) /
+ * ask_depth(N) exactly.
  */
-class OrderBook {
-public:
-    OrderBook() noexcept = default;
-    
-    explicit OrderBook(StockLocate stock_locate) noexcept 
+enum class DepthAction : std::uint8_t {
+    New = 0,
+    Change = 1,
+    Delete = 2
+};
+
+struct DepthDelta {
+    Price           price;          // 8 bytes
+    Quantity        quantity;       // 4 bytes (new total at level, 0 on Delete)
+    std::uint32_t   order_count;    // 4 bytes
+    StockLocate     stock_locate;   // 2 bytes
+    std::uint16_t   level;          // 2 bytes (0 = best)
+    Side            side;           // 1 byte
+    DepthAction     action;         // 1 byte
+    char            padding[2];     // Padding
+};
+
+static_assert(sizeof(DepthDelta) == 24, "DepthDelta must be 24 bytes");
+
+/**
+ * @brief Preallocated output buffer for depth deltas
+ *
+ * Storage is sized once via reserve(); push() never allocates. If the consumer
+ * does not drain the buffer in time, further deltas are dropped and
+ * overflowed() is set so the consumer knows to resync from a depth snapshot.
+ */
+class DepthDeltaBuffer {
+public:
+    DepthDeltaBuffer() = default;
+    
+    explicit DepthDeltaBuffer(std::size_t capacity) {
+        reserve(capacity);
+    }
+    
+    void reserve(std::size_t capacity) {
+        deltas_.resize(capacity);
+        clear();
+    }
+    
+    ITCH_FORCE_INLINE void push(const DepthDelta& delta) noexcept {
+        if (ITCH_UNLIKELY(size_ == deltas_.size())) {
+            overflowed_ = true;
+            return;
+        }
+        deltas_[size_++] = delta;
+    }
+    
+    void clear() noexcept {
+        size_ = 0;
+        overflowed_ = false;
+    }
+    
+    /**
+     * @brief Drop every delta pushed after size() was `size` and put back
+     * the overflow flag observed then
+     */
+    void rewind(std::size_t size, bool overflowed) noexcept {
+        size_ = size;
+        overflowed_ = overflowed;
+    }
+    
+    const DepthDelta* begin() const noexcept { return deltas_.data(); }
+    const DepthDelta* end() const noexcept { return deltas_.data() + size_; }
+    const DepthDelta& operator[](std::size_t i) const noexcept { return deltas_[i]; }
+    
+    std::size_t size() const noexcept { return size_; }
+    std::size_t capacity() const noexcept { return deltas_.size(); }
+    bool empty() const noexcept { return size_ == 0; }
+    bool overflowed() const noexcept { return overflowed_; }
+
+private:
+    std::vector<DepthDelta> deltas_;
+    std::size_t size_ = 0;
+    bool overflowed_ = false;
+};
+
+// =============================================================================
+// Order Book (Single Symbol)
+// =============================================================================
+
+/**
+ * @brief High-water marks of one book since it was created or last cleared
+ *
+ * The end-of-day sizing profile (sizing_profile.hpp) is built from these.
+ * The price range is only meaningful once a level has been created.
+ */
+struct BookPeaks {
+    std::size_t orders = 0;
+    std::size_t bid_levels = 0;
+    std::size_t ask_levels = 0;
+    Price min_price = std::numeric_limits<Price>::max();
+    Price max_price = std::numeric_limits<Price>::min();
+};
+
+/**
+ * @brief Full depth order book for a single symbol
+ * 
+ * Optimized:
+ * - Uses std::vector<PriceLevel> w/ std::lower_bound for Price Levels (cache locality)
+ * - Uses OrderIndex (OrderMap, SwissOrderMap or PagedOrderMap) for Orders
+ *
+ * Layout picks the order representation: OrderBook stores 64-byte Order
+ * objects from an ObjectPool, CompactOrderBook splits them into hot and cold
+ * arrays in a CompactOrderStore. Every call that touches orders takes the
+ * store (`pool`) the book's orders live in.
+ */
+template<typename Layout>
+class BasicOrderBook {
+public:
+    using Handle = typename Layout::Handle;
+    using Hot = typename Layout::Hot;
+    using Cold = typename Layout::Cold;
+    using Store = typename Layout::Store;
+    using Level = BasicPriceLevel<Layout>;
+    
+    /// clear() removes keys one by one below 1/RATIO index occupancy
+    static constexpr std::size_t CLEAR_BY_KEY_RATIO = 8;
+    
+    explicit BasicOrderBook(StockLocate stock_locate) noexcept 
         : stock_locate_(stock_locate) {
     }
     
-    Order* add_order(OrderId order_id, Side side, Price price, 
+    BasicOrderBook(StockLocate stock_locate, std::size_t order_capacity)
+        : stock_locate_(stock_locate), orders_(order_capacity) {
+    }
+    
+    Handle add_order(OrderId order_id, Side side, Price price,
                      Quantity quantity, Timestamp timestamp,
-                     ObjectPool<Order>& pool) noexcept {
-        if (ITCH_UNLIKELY(orders_.find(order_id) != nullptr)) {
-            return nullptr;
+                     Store& pool) noexcept {
+        if (ITCH_UNLIKELY(orders_.find(order_id))) {
+            return Handle{};
         }
-        
-        Order* order = pool.acquire();
-        order->order_id = order_id;
-        order->price = price;
-        order->quantity = quantity;
-        order->original_qty = quantity;
-        order->stock_locate = stock_locate_;
-        order->side = side;
-        order->timestamp = timestamp;
-        order->next = nullptr;
-        order->prev = nullptr;
-        
+    
+        Handle order = pool.acquire();
+        if (ITCH_UNLIKELY(!order)) {
+            return Handle{};    // Hard-capacity pool exhausted
+        }
+        Cold& c = cold(pool, order);
+        c.order_id = order_id;
+        c.price = price;
+        c.original_qty = quantity;
+        c.stock_locate = stock_locate_;
+        c.timestamp = timestamp;
+        Hot& o = hot(pool, order);
+        o.quantity = quantity;
+        o.side = side;
+        o.next = Handle{};
+        o.prev = Handle{};
+    
         orders_.put(order_id, order);
-        
+    
         if (is_buy(side)) {
             auto it = bids_.find(price);
-            if (it == bids_.end()) {
-                it = bids_.emplace(price, PriceLevel(price)).first;
+            const bool new_level = (it == bids_.end());
+            if (new_level) {
+                it = bids_.emplace(price, Level(price)).first;
+                note_new_level(Side::Buy, price);
             }
-            it->second.add_order(order);
+            it->second.add_order(order, &pool);
+            if (depth_window_) publish_level_update(Side::Buy, bids_, it, new_level);
             update_best_bid();
         } else {
             auto it = asks_.find(price);
-            if (it == asks_.end()) {
-                it = asks_.emplace(price, PriceLevel(price)).first;
+            const bool new_level = (it == asks_.end());
+            if (new_level) {
+                it = asks_.emplace(price, Level(price)).first;
+                note_new_level(Side::Sell, price);
             }
-            it->second.add_order(order);
+            it->second.add_order(order, &pool);
+            if (depth_window_) publish_level_update(Side::Sell, asks_, it, new_level);
             update_best_ask();
         }
-        
-        ++order_count_;
+    
+        if (++order_count_ > peaks_.orders) peaks_.orders = order_count_;
         return order;
     }
     
     Quantity execute_order(OrderId order_id, Quantity quantity,
-                          ObjectPool<Order>& pool) noexcept {
-        Order* order = orders_.find(order_id);
-        if (ITCH_UNLIKELY(order == nullptr)) {
+                          Store& pool) noexcept {
+        Handle order = orders_.find(order_id);
+        if (ITCH_UNLIKELY(!order)) {
             return 0;
         }
-        
-        const Quantity exec_qty = std::min(quantity, order->quantity);
-        const Side side = order->side;
-        const Price price = order->price;
-        
-        if (is_buy(side)) {
-            auto it = bids_.find(price);
-            if (it != bids_.end()) {
-                it->second.reduce_quantity(order, exec_qty);
-                if (it->second.empty()) {
-                    bids_.erase(it);
-                }
-            }
-            update_best_bid();
-        } else {
-            auto it = asks_.find(price);
-            if (it != asks_.end()) {
-                it->second.reduce_quantity(order, exec_qty);
-                if (it->second.empty()) {
-                    asks_.erase(it);
-                }
-            }
-            update_best_ask();
-        }
-        
-        if (order->quantity == 0) {
-            orders_.remove(order_id);
+        return execute_order(order, quantity, pool);
+    }
+    
+    /**
+     * @brief Execute against an order already obtained from get_order()
+     *
+     * The level is reached through the order's level pointer, so the only
+     * further index or level-map work is removing what the execution empties.
+     * Only hot fields are touched unless the order fills.
+     */
+    Quantity execute_order(Handle order, Quantity quantity,
+                           Store& pool) noexcept {
+        Hot& o = hot(pool, order);
+        const Quantity exec_qty = std::min(quantity, o.quantity);
+        Level& level = *o.level;
+        level.reduce_quantity(order, exec_qty, &pool);
+        level_reduced(o.side, level);
+    
+        if (o.quantity == 0) {
+            orders_.remove(cold(pool, order).order_id);
             pool.release(order);
             --order_count_;
         }
-        
+    
         return exec_qty;
     }
     
     Quantity cancel_order(OrderId order_id, Quantity quantity,
-                          ObjectPool<Order>& pool) noexcept {
+                          Store& pool) noexcept {
         return execute_order(order_id, quantity, pool);
     }
     
-    bool delete_order(OrderId order_id, ObjectPool<Order>& pool) noexcept {
-        Order* order = orders_.find(order_id);
-        if (ITCH_UNLIKELY(order == nullptr)) {
+    Quantity cancel_order(Handle order, Quantity quantity,
+                          Store& pool) noexcept {
+        return execute_order(order, quantity, pool);
+    }
+    
+    bool delete_order(OrderId order_id, Store& pool) noexcept {
+        Handle order = orders_.extract(order_id);
+        if (ITCH_UNLIKELY(!order)) {
             return false;
         }
-        
-        const Side side = order->side;
-        const Price price = order->price;
-        
-        if (is_buy(side)) {
-            auto it = bids_.find(price);
-            if (it != bids_.end()) {
-                it->second.remove_order(order);
-                if (it->second.empty()) {
-                    bids_.erase(it);
-                }
-            }
+        release_order(order, pool);
+        return true;
+    }
+    
+    /**
+     * @brief Delete an order already obtained from get_order()
+     */
+    void delete_order(Handle order, Store& pool) noexcept {
+        orders_.remove(cold(pool, order).order_id);
+        release_order(order, pool);
+    }
+    
+    /**
+     * @brief Replace in place: the order is reused and rekeyed, and it
+     * loses time priority (moves to the tail of its new level)
+     *
+     * An unchanged price requeues the order within its level without touching
+     * the level map. If `new_order_id` is already live the old order is
+     * deleted and a null handle returned, as a delete followed by a rejected add.
+     */
+    Handle replace_order(OrderId old_order_id, OrderId new_order_id,
+                         Quantity new_quantity, Price new_price,
+                         Timestamp timestamp, Store& pool) noexcept {
+        Handle order = orders_.extract(old_order_id);
+        if (ITCH_UNLIKELY(!order)) {
+             return Handle{};
+        }
+        const bool rekeyed = orders_.insert(new_order_id, order);
+    
+        if (is_buy(hot(pool, order).side)) {
+            requeue_order(Side::Buy, bids_, order, new_price, new_quantity, rekeyed, pool);
             update_best_bid();
         } else {
-            auto it = asks_.find(price);
-            if (it != asks_.end()) {
-                it->second.remove_order(order);
-                if (it->second.empty()) {
-                    asks_.erase(it);
-                }
-            }
+            requeue_order(Side::Sell, asks_, order, new_price, new_quantity, rekeyed, pool);
             update_best_ask();
         }
-        
-        orders_.remove(order_id);
-        pool.release(order);
-        --order_count_;
-        return true;
-    }
     
-    Order* replace_order(OrderId old_order_id, OrderId new_order_id,
-                        Quantity new_quantity, Price new_price,
-                        Timestamp timestamp, ObjectPool<Order>& pool) noexcept {
-        Order* old_order = orders_.find(old_order_id);
-        if (ITCH_UNLIKELY(old_order == nullptr)) {
-             return nullptr;
+        if (ITCH_UNLIKELY(!rekeyed)) {
+            pool.release(order);
+            --order_count_;
+            return Handle{};
         }
-        const Side side = old_order->side;
-        
-        delete_order(old_order_id, pool);
-        return add_order(new_order_id, side, new_price, new_quantity, timestamp, pool);
+        Cold& c = cold(pool, order);
+        c.order_id = new_order_id;
+        c.original_qty = new_quantity;
+        c.timestamp = timestamp;
+        return order;
     }
     
-    Order* get_order(OrderId order_id) const noexcept {
+    Handle get_order(OrderId order_id) const noexcept {
         return orders_.find(order_id);
     }
     
     const BBO& bbo() const noexcept { return bbo_; }
     
     std::vector<DepthLevel> bid_depth(std::size_t max_levels = 10) const {
-        std::vector<DepthLevel> depth;
-        depth.reserve(max_levels);
-        std::size_t count = 0;
-        for (auto it = bids_.begin(); it != bids_.end() && count < max_levels; ++it, ++count) {
-            depth.push_back({it->second.price(), it->second.total_quantity(), it->second.order_count()});
-        }
+        std::vector<DepthLevel> depth(std::min(max_levels, bids_.size()));
+        bid_depth(depth.data(), depth.size());
         return depth;
     }
     
     std::vector<DepthLevel> ask_depth(std::size_t max_levels = 10) const {
-        std::vector<DepthLevel> depth;
-        depth.reserve(max_levels);
-        std::size_t count = 0;
-        for (auto it = asks_.begin(); it != asks_.end() && count < max_levels; ++it, ++count) {
-            depth.push_back({it->second.price(), it->second.total_quantity(), it->second.order_count()});
-        }
+        std::vector<DepthLevel> depth(std::min(max_levels, asks_.size()));
+        ask_depth(depth.data(), depth.size());
         return depth;
     }
     
+    /**
+     * @brief Copy up to `max_levels` best-first bid levels into `out`, no allocation
+     * @return Levels written. A memcpy when the depth cache covers `max_levels`.
+     */
+    std::size_t bid_depth(DepthLevel* out, std::size_t max_levels) const noexcept {
+        if (max_levels <= depth_cache_levels_) {
+            return copy_cached(0, out, max_levels);
+        }
+        return copy_levels(bids_, out, max_levels);
+    }
+    
+    std::size_t ask_depth(DepthLevel* out, std::size_t max_levels) const noexcept {
+        if (max_levels <= depth_cache_levels_) {
+            return copy_cached(1, out, max_levels);
+        }
+        return copy_levels(asks_, out, max_levels);
+    }
+    
+    template<std::size_t N>
+    std::size_t bid_depth(std::array<DepthLevel, N>& out) const noexcept {
+        return bid_depth(out.data(), N);
+    }
+    
+    template<std::size_t N>
+    std::size_t ask_depth(std::array<DepthLevel, N>& out) const noexcept {
+        return ask_depth(out.data(), N);
+    }
+    
+    /**
+     * @brief Maintain the top `levels` of each side in flat arrays, updated in
+     * place on every level change inside the window. Pass 0 to disable.
+     */
+    void set_depth_cache(std::size_t levels) {
+        depth_cache_levels_ = levels;
+        depth_cache_.assign(levels * 2, DepthLevel{});
+        depth_cache_size_[0] = copy_levels(bids_, depth_cache_.data(), levels);
+        depth_cache_size_[1] = copy_levels(asks_, depth_cache_.data() + levels, levels);
+        depth_window_ = std::max(depth_feed_levels_, depth_cache_levels_);
+    }
+    
+    std::size_t depth_cache_levels() const noexcept { return depth_cache_levels_; }
+    
+    /**
+     * @brief Emit level deltas for the top `levels` levels into `buffer`
+     * Pass nullptr to disable. Existing levels are not replayed; consumers
+     * should seed from bid_depth/ask_depth when subscribing mid-stream.
+     */
+    void set_depth_feed(DepthDeltaBuffer* buffer, std::size_t levels) noexcept {
+        depth_feed_ = (buffer && levels > 0) ? buffer : nullptr;
+        depth_feed_levels_ = depth_feed_ ? levels : 0;
+        depth_window_ = std::max(depth_feed_levels_, depth_cache_levels_);
+    }
+    
+    /**
+     * @brief Visit every live order: bids best-first, then asks best-first,
+     * each level in FIFO (time priority) order
+     */
+    template<typename F>
+    void for_each_order(F&& fn) const {
+        static_assert(std::is_same_v<Layout, WideOrderLayout>,
+                      "Pass the order store: for_each_order(store, fn)");
+        for (const auto& pair : bids_) {
+            for (const Order* o = pair.second.front(); o; o = o->next) fn(*o);
+        }
+        for (const auto& pair : asks_) {
+            for (const Order* o = pair.second.front(); o; o = o->next) fn(*o);
+        }
+    }
+    
+    /**
+     * @brief for_each_order() for any layout: fn(hot, cold) per live order
+     */
+    template<typename F>
+    void for_each_order(const Store& pool, F&& fn) const {
+        for (const auto& pair : bids_) visit_level(pool, pair.second, fn);
+        for (const auto& pair : asks_) visit_level(pool, pair.second, fn);
+    }
+    
+    /**
+     * @brief Presize the order index for `count` live orders
+     */
+    void reserve_orders(std::size_t count) {
+        orders_.reserve(count);
+    }
+    
+    /// Fault in every page the order index has reserved
+    void prefault_orders() noexcept {
+        orders_.prefault();
+    }
+    
+    /// Slot capacity of the order index (its load limit is backend-specific)
+    std::size_t order_capacity() const noexcept { return orders_.capacity(); }
+    
+    /// High-water marks since the book was created or last cleared
+    const BookPeaks& peaks() const noexcept { return peaks_; }
+    
+    /// Put back marks saved by the caller (e.g. after a rolled-back warm-up)
+    void restore_peaks(const BookPeaks& peaks) noexcept { peaks_ = peaks; }
+    
     std::size_t order_count() const noexcept { return order_count_; }
     std::size_t bid_level_count() const noexcept { return bids_.size(); }
     std::size_t ask_level_count() const noexcept { return asks_.size(); }
     StockLocate stock_locate() const noexcept { return stock_locate_; }
     
-    void clear(ObjectPool<Order>& pool) noexcept {
-         for (auto& pair : bids_) {
-             Order* curr = pair.second.front();
-             while (curr) {
-                 Order* next = curr->next;
-                 pool.release(curr);
-                 curr = next;
-             }
-         }
-         for (auto& pair : asks_) {
-             Order* curr = pair.second.front();
-             while (curr) {
-                 Order* next = curr->next;
-                 pool.release(curr);
-                 curr = next;
-             }
-         }
+    /**
+     * @brief Release every order and empty the book
+     *
+     * When the index holds few orders for its capacity (the usual end-of-day
+     * state) their keys are removed one by one while the levels are walked,
+     * so only the buckets actually used are touched; a well-filled index is
+     * wiped in one pass instead.
+     */
+    void clear(Store& pool) noexcept {
+         const bool by_key = orders_.size() * CLEAR_BY_KEY_RATIO < orders_.capacity();
+         release_all(bids_, pool, by_key);
+         release_all(asks_, pool, by_key);
          
          bids_.clear();
          asks_.clear();
-         orders_.clear();
+         if (!by_key) orders_.clear();
          bbo_ = BBO{};
          order_count_ = 0;
+         peaks_ = BookPeaks{};
+         depth_cache_size_[0] = depth_cache_size_[1] = 0;
     }
 
 private:
     StockLocate stock_locate_ = 0;
-    std::map<Price, PriceLevel, std::greater<Price>> bids_; // Highest bid first
-    std::map<Price, PriceLevel, std::less<Price>> asks_;    // Lowest ask first
-    OrderMap orders_;
+    std::map<Price, Level, std::greater<Price>> bids_;  // Highest bid first
+    std::map<Price, Level, std::less<Price>> asks_;     // Lowest ask first
+    BasicOrderIndex<Handle> orders_;
     BBO bbo_;
     std::size_t order_count_ = 0;
+    BookPeaks peaks_;
+    DepthDeltaBuffer* depth_feed_ = nullptr;
+    std::size_t depth_feed_levels_ = 0;
+    std::vector<DepthLevel> depth_cache_;       // Bids [0, N), asks [N, 2N)
+    std::size_t depth_cache_levels_ = 0;
+    std::size_t depth_cache_size_[2] = {0, 0};
+    std::size_t depth_window_ = 0;              // max(feed levels, cache levels)
+    
+    static Hot& hot(Store& pool, Handle order) noexcept {
+        return Layout::hot(&pool, order);
+    }
+    
+    void note_new_level(Side side, Price price) noexcept {
+        if (is_buy(side)) {
+            peaks_.bid_levels = std::max(peaks_.bid_levels, bids_.size());
+        } else {
+            peaks_.ask_levels = std::max(peaks_.ask_levels, asks_.size());
+        }
+        peaks_.min_price = std::min(peaks_.min_price, price);
+        peaks_.max_price = std::max(peaks_.max_price, price);
+    }
+    
+    static Cold& cold(Store& pool, Handle order) noexcept {
+        return Layout::cold(&pool, order);
+    }
+    
+    /// Return every order on one side to the pool, dropping their keys if `by_key`
+    template<typename Levels>
+    void release_all(Levels& levels, Store& pool, bool by_key) noexcept {
+        for (auto& pair : levels) {
+            Handle curr = pair.second.front();
+            while (curr) {
+                Handle next = hot(pool, curr).next;
+                if (by_key) orders_.remove(cold(pool, curr).order_id);
+                pool.release(curr);
+                curr = next;
+            }
+        }
+    }
+    
+    template<typename F>
+    static void visit_level(const Store& pool, const Level& level, F& fn) {
+        for (Handle o = level.front(); o; o = Layout::hot(&pool, o).next) {
+            fn(Layout::hot(&pool, o), Layout::cold(&pool, o));
+        }
+    }
+    
+    static DepthLevel to_depth_level(const Level& level) noexcept {
+        return {level.price(), level.total_quantity(), level.order_count()};
+    }
+    
+    template<typename Levels>
+    static std::size_t copy_levels(const Levels& levels, DepthLevel* out,
+                                   std::size_t max_levels) noexcept {
+        std::size_t count = 0;
+        for (auto it = levels.begin(); it != levels.end() && count < max_levels; ++it) {
+            out[count++] = to_depth_level(it->second);
+        }
+        return count;
+    }
+    
+    std::size_t copy_cached(std::size_t side, DepthLevel* out, std::size_t max_levels) const noexcept {
+        const std::size_t count = std::min(max_levels, depth_cache_size_[side]);
+        std::memcpy(out, depth_cache_.data() + side * depth_cache_levels_, count * sizeof(DepthLevel));
+        return count;
+    }
+    
+    /**
+     * @brief Position of the level at `price` counted from the best level, capped at the tracked depth
+     * 
+     * When the cache is at least as deep as the feed the position is a search of
+     * the flat cache; otherwise walks at most depth_window_ nodes, never the full side.
+     */
+    template<typename Levels>
+    std::size_t level_index(Side side, const Levels& levels, Price price) const noexcept {
+        if (depth_cache_levels_ >= depth_feed_levels_) {
+            return cached_index(side, price);
+        }
+        std::size_t idx = 0;
+        for (auto cur = levels.begin(); cur != levels.end() && cur->first != price &&
+                                        idx < depth_window_; ++cur) {
+            ++idx;
+        }
+        return idx;
+    }
+    
+    /**
+     * @brief Levels in the cache priced better than `price`, or depth_window_
+     * when `price` falls below a full cache. Valid before the cache is updated.
+     */
+    std::size_t cached_index(Side side, Price price) const noexcept {
+        const std::size_t s = is_buy(side) ? 0 : 1;
+        const DepthLevel* first = depth_cache_.data() + s * depth_cache_levels_;
+        const DepthLevel* last = first + depth_cache_size_[s];
+        const DepthLevel* pos = is_buy(side)
+            ? std::lower_bound(first, last, price,
+                  [](const DepthLevel& l, Price p) { return l.price > p; })
+            : std::lower_bound(first, last, price,
+                  [](const DepthLevel& l, Price p) { return l.price < p; });
+        const std::size_t idx = static_cast<std::size_t>(pos - first);
+        return (pos == last && depth_cache_size_[s] == depth_cache_levels_) ? depth_window_ : idx;
+    }
+    
+    /// The level `shift` nodes past `next`, or nullptr past the end of the side
+    template<typename Levels>
+    static const Level* level_after(const Levels& levels, typename Levels::iterator next,
+                                         std::size_t shift) noexcept {
+        for (std::size_t i = 0; i < shift && next != levels.end(); ++i) {
+            ++next;
+        }
+        return next != levels.end() ? &next->second : nullptr;
+    }
+    
+    DepthLevel* cache_side(Side side) noexcept {
+        return depth_cache_.data() + (is_buy(side) ? 0 : depth_cache_levels_);
+    }
+    
+    std::size_t& cache_size(Side side) noexcept {
+        return depth_cache_size_[is_buy(side) ? 0 : 1];
+    }
+    
+    void cache_insert(Side side, std::size_t idx, const Level& level) noexcept {
+        DepthLevel* cache = cache_side(side);
+        std::size_t& size = cache_size(side);
+        const std::size_t kept = std::min(size, depth_cache_levels_ - 1);
+        std::memmove(cache + idx + 1, cache + idx, (kept - idx) * sizeof(DepthLevel));
+        cache[idx] = to_depth_level(level);
+        size = kept + 1;
+    }
+    
+    /// Called after the level is erased from `levels`
+    template<typename Levels>
+    void cache_erase(Side side, std::size_t idx, const Levels& levels) noexcept {
+        DepthLevel* cache = cache_side(side);
+        std::size_t& size = cache_size(side);
+        // A full cache refills from the level just past its old last entry
+        const auto refill = size == depth_cache_levels_
+            ? levels.upper_bound(cache[size - 1].price) : levels.end();
+        std::memmove(cache + idx, cache + idx + 1, (size - idx - 1) * sizeof(DepthLevel));
+        --size;
+        if (refill != levels.end()) cache[size++] = to_depth_level(refill->second);
+    }
+    
+    void push_delta(Side side, DepthAction action, std::size_t idx,
+                    const Level& level) noexcept {
+        DepthDelta delta;
+        delta.price = level.price();
+        delta.quantity = action == DepthAction::Delete ? 0 : level.total_quantity();
+        delta.order_count = action == DepthAction::Delete
+            ? 0 : static_cast<std::uint32_t>(level.order_count());
+        delta.stock_locate = stock_locate_;
+        delta.level = static_cast<std::uint16_t>(idx);
+        delta.side = side;
+        delta.action = action;
+        depth_feed_->push(delta);
+    }
+    
+    template<typename Levels>
+    void publish_level_update(Side side, const Levels& levels,
+                              typename Levels::const_iterator it, bool new_level) noexcept {
+        if (!new_level) {
+            publish_level_change(side, levels, it->second);
+            return;
+        }
+        const std::size_t idx = level_index(side, levels, it->first);
+        if (idx < depth_cache_levels_) {
+            cache_insert(side, idx, it->second);
+        }
+        if (!depth_feed_ || idx >= depth_feed_levels_) return;
+
+        // The insert pushes the previous last visible level out of the window
+        if (levels.size() > depth_feed_levels_) {
+            auto dropped = std::next(it, static_cast<std::ptrdiff_t>(depth_feed_levels_ - idx));
+            push_delta(side, DepthAction::Delete, depth_feed_levels_ - 1, dropped->second);
+        }
+        push_delta(side, DepthAction::New, idx, it->second);
+    }
+    
+    /// Unlink `order` (already out of the index) from its level and return it to the pool
+    void release_order(Handle order, Store& pool) noexcept {
+        Hot& o = hot(pool, order);
+        Level& level = *o.level;
+        level.remove_order(order, &pool);
+        level_reduced(o.side, level);
+        pool.release(order);
+        --order_count_;
+    }
+    
+    /// Follow-up after `level` lost quantity or orders: depth hooks, erase if empty, BBO
+    void level_reduced(Side side, const Level& level) noexcept {
+        if (is_buy(side)) {
+            shrink_level(Side::Buy, bids_, level);
+            update_best_bid();
+        } else {
+            shrink_level(Side::Sell, asks_, level);
+            update_best_ask();
+        }
+    }
+    
+    template<typename Levels>
+    void shrink_level(Side side, Levels& levels, const Level& level) noexcept {
+        if (level.empty()) {
+            erase_level(side, levels, levels.find(level.price()));
+        } else if (depth_window_) {
+            publish_level_change(side, levels, level);
+        }
+    }
+    
+    /**
+     * @brief Move `order` to the tail of the level at `new_price` with `new_quantity`,
+     * or just unlink it when `keep` is false
+     */
+    template<typename Levels>
+    void requeue_order(Side side, Levels& levels, Handle order, Price new_price,
+                       Quantity new_quantity, bool keep, Store& pool) noexcept {
+        Hot& o = hot(pool, order);
+        Level& level = *o.level;
+        level.remove_order(order, &pool);
+        
+        if (keep && new_price == level.price()) {
+            o.quantity = new_quantity;
+            level.add_order(order, &pool);
+            if (depth_window_) publish_level_change(side, levels, level);
+            return;
+        }
+        
+        shrink_level(side, levels, level);
+        if (!keep) {
+            return;
+        }
+        
+        cold(pool, order).price = new_price;
+        o.quantity = new_quantity;
+        auto dest = levels.find(new_price);
+        const bool new_level = (dest == levels.end());
+        if (new_level) {
+            dest = levels.emplace(new_price, Level(new_price)).first;
+            note_new_level(side, new_price);
+        }
+        dest->second.add_order(order, &pool);
+        if (depth_window_) publish_level_update(side, levels, dest, new_level);
+    }
+    
+    template<typename Levels>
+    void publish_level_change(Side side, const Levels& levels, const Level& level) noexcept {
+        const std::size_t idx = level_index(side, levels, level.price());
+        if (idx < depth_cache_levels_) {
+            cache_side(side)[idx] = to_depth_level(level);
+        }
+        if (depth_feed_ && idx < depth_feed_levels_) {
+            push_delta(side, DepthAction::Change, idx, level);
+        }
+    }
+    
+    template<typename Levels>
+    void erase_level(Side side, Levels& levels, typename Levels::iterator it) noexcept {
+        if (!depth_window_) {
+            levels.erase(it);
+            return;
+        }
+        
+        const Price price = it->first;
+        const std::size_t idx = level_index(side, levels, price);
+        auto next = levels.erase(it);
+        if (idx < depth_cache_levels_) {
+            cache_erase(side, idx, levels);
+        }
+        if (!depth_feed_ || idx >= depth_feed_levels_) return;
+        
+        DepthDelta delta{};
+        delta.price = price;
+        delta.stock_locate = stock_locate_;
+        delta.level = static_cast<std::uint16_t>(idx);
+        delta.side = side;
+        delta.action = DepthAction::Delete;
+        depth_feed_->push(delta);
+        
+        // The first level beyond the window slides into the last visible slot
+        if (const Level* slid = level_after(levels, next, depth_feed_levels_ - 1 - idx)) {
+            push_delta(side, DepthAction::New, depth_feed_levels_ - 1, *slid);
+        }
+    }
     
     void update_best_bid() noexcept {
         if (bids_.empty()) {
@@ -606,51 +1717,228 @@ private:
     }
 };
 
+using OrderBook = BasicOrderBook<WideOrderLayout>;
+using CompactOrderBook = BasicOrderBook<CompactOrderLayout>;
+
 // =============================================================================
 // Order Book Manager (Multiple Symbols)
 // =============================================================================
 
-class OrderBookManager {
+/**
+ * @brief Books for every stock locate plus the order store they share
+ *
+ * Storage is sparse: the manager starts with an empty pointer slot per locate
+ * and allocates a book when its locate is first opened, either by the stock
+ * directory (open_book(), ahead of the session) or by the first order that
+ * names it. A presence bitset of the opened locates backs has_book() and lets
+ * clear(), total_order_count() and the iteration APIs visit only those books,
+ * in locate order. Every locate below MAX_SYMBOLS, 0 included, is a real one.
+ */
+template<typename Layout>
+class BasicOrderBookManager {
 public:
+    using Book = BasicOrderBook<Layout>;
+    using Store = typename Layout::Store;
+    
     static constexpr std::size_t MAX_SYMBOLS = 8192;
     
-    OrderBookManager() {
-        books_.resize(MAX_SYMBOLS);
+    /// Index capacity of books opened without a sizing hint. A whole
+    /// directory is opened up front, so this stays a few KiB per book; hot
+    /// names rehash up to BasicOrderMap::INCREMENTAL_MIN and grow
+    /// incrementally beyond it
+    static constexpr std::size_t UNSIZED_BOOK_CAPACITY = 256;
+    
+    BasicOrderBookManager() : books_(MAX_SYMBOLS) {}
+    
+    /**
+     * @brief Book for `stock_locate`, opened on first use
+     */
+    Book& get_book(StockLocate stock_locate) {
+        assert(stock_locate < MAX_SYMBOLS);
+        if (ITCH_LIKELY(books_[stock_locate] != nullptr)) {
+            return *books_[stock_locate];
+        }
+        return open_book(stock_locate);
+    }
+    
+    /**
+     * @brief get_book() that sizes the book's order index for
+     * `expected_orders` instead of UNSIZED_BOOK_CAPACITY
+     */
+    Book& get_book(StockLocate stock_locate, std::size_t expected_orders) {
+        assert(stock_locate < MAX_SYMBOLS);
+        if (books_[stock_locate] != nullptr) {
+            books_[stock_locate]->reserve_orders(expected_orders);
+            if (expected_orders != 0) mark_sized(stock_locate);
+            return *books_[stock_locate];
+        }
+        return create_book(stock_locate, expected_orders);
     }
     
-    OrderBook& get_book(StockLocate stock_locate) noexcept {
-        if (books_[stock_locate].stock_locate() == 0) {
-            books_[stock_locate] = OrderBook(stock_locate);
+    /**
+     * @brief Allocate the book for `stock_locate` if it has none yet
+     *
+     * Called for each stock directory message so books exist before their
+     * first order. A new book's index is sized by the presize() hint, or
+     * starts at UNSIZED_BOOK_CAPACITY without one.
+     */
+    Book& open_book(StockLocate stock_locate) {
+        assert(stock_locate < MAX_SYMBOLS);
+        if (books_[stock_locate] != nullptr) {
+            return *books_[stock_locate];
         }
-        return books_[stock_locate];
+        return create_book(stock_locate, peak_orders_per_book_);
+    }
+    
+    /**
+     * @brief Expected-peak sizing hint
+     *
+     * Reserves the order pool for `peak_live_orders` and sizes the order index
+     * of every book (current and future) for `peak_orders_per_book`, so the
+     * session never grows either on the feed path. 0 leaves that part as is.
+     */
+    void presize(std::size_t peak_live_orders, std::size_t peak_orders_per_book) {
+        order_pool_.reserve(peak_live_orders);
+        if (peak_orders_per_book == 0) return;
+        peak_orders_per_book_ = peak_orders_per_book;
+        for_each_present([&](std::size_t locate) {
+            books_[locate]->reserve_orders(peak_orders_per_book);
+            mark_sized(static_cast<StockLocate>(locate));
+        });
+    }
+    
+    /**
+     * @brief Fault in the order pool and the order index of every sized book
+     *
+     * Call after presizing (presize(), warm_start()) and before the session,
+     * so the first writes to reserved memory do not take page faults. Only
+     * books sized by a hint (presize(), a sizing profile, a checkpoint) are
+     * touched, each for the index it actually has; unsized directory books
+     * are left to fault in as they grow, so a full directory costs no RSS.
+     */
+    void prefault() noexcept {
+        order_pool_.prefault();
+        for_each_bit(sized_, [&](std::size_t locate) { books_[locate]->prefault_orders(); });
+    }
+    
+    /**
+     * @brief Whether the book for `stock_locate` was sized by a hint
+     * (and so is prefaulted by prefault())
+     */
+    bool is_sized(StockLocate stock_locate) const noexcept {
+        return stock_locate < MAX_SYMBOLS &&
+               (sized_[stock_locate / 64] >> (stock_locate % 64) & 1) != 0;
+    }
+    
+    /**
+     * @brief Route top-N level deltas of every book (current and future) into `buffer`
+     */
+    void set_depth_feed(DepthDeltaBuffer* buffer, std::size_t levels) noexcept {
+        depth_feed_ = buffer;
+        depth_feed_levels_ = levels;
+        for_each_active([&](Book& book) { book.set_depth_feed(buffer, levels); });
+    }
+    
+    /**
+     * @brief Cache the top `levels` of every book (current and future); 0 disables
+     */
+    void set_depth_cache(std::size_t levels) {
+        depth_cache_levels_ = levels;
+        for_each_active([&](Book& book) { book.set_depth_cache(levels); });
     }
     
     bool has_book(StockLocate stock_locate) const noexcept {
-        return stock_locate < books_.size() && 
-               books_[stock_locate].stock_locate() != 0;
+        return stock_locate < MAX_SYMBOLS &&
+               (present_[stock_locate / 64] >> (stock_locate % 64) & 1) != 0;
+    }
+    
+    const Book* find_book(StockLocate stock_locate) const noexcept {
+        return has_book(stock_locate) ? books_[stock_locate].get() : nullptr;
+    }
+    
+    Store& order_pool() noexcept { return order_pool_; }
+    const Store& order_pool() const noexcept { return order_pool_; }
+    
+    /**
+     * @brief Visit every open book, in locate order
+     */
+    template<typename F>
+    void for_each_book(F&& fn) const {
+        for_each_present([&](std::size_t locate) { fn(*books_[locate]); });
     }
     
-    ObjectPool<Order>& order_pool() noexcept { return order_pool_; }
+    /// Books opened so far (they stay open across clear())
+    std::size_t active_book_count() const noexcept { return book_count_; }
     
     std::size_t total_order_count() const noexcept {
         std::size_t count = 0;
-        for (const auto& book : books_) {
-            count += book.order_count();
-        }
+        for_each_book([&](const Book& book) { count += book.order_count(); });
         return count;
     }
     
+    /**
+     * @brief Empty every open book (and reset the peaks they and the order
+     * store track); the books themselves are kept
+     */
     void clear() noexcept {
-        for (auto& book : books_) {
-            book.clear(order_pool_);
-        }
+        for_each_active([&](Book& book) { book.clear(order_pool_); });
+        order_pool_.reset_peak();
     }
 
 private:
-    std::vector<OrderBook> books_;
-    ObjectPool<Order> order_pool_;
+    static constexpr std::size_t PRESENT_WORDS = MAX_SYMBOLS / 64;
+    
+    std::vector<std::unique_ptr<Book>> books_;              // Null until opened
+    std::array<std::uint64_t, PRESENT_WORDS> present_{};    // Bit per open book
+    std::array<std::uint64_t, PRESENT_WORDS> sized_{};      // Bit per hint-sized book
+    std::size_t book_count_ = 0;
+    Store order_pool_;
+    DepthDeltaBuffer* depth_feed_ = nullptr;
+    std::size_t depth_feed_levels_ = 0;
+    std::size_t depth_cache_levels_ = 0;
+    std::size_t peak_orders_per_book_ = 0;  // presize() hint for new books
+    
+    /// Allocate a book (index sized for `expected_orders`, 0 = unsized),
+    /// mark it present and apply the manager-wide settings
+    ITCH_NOINLINE Book& create_book(StockLocate stock_locate, std::size_t expected_orders) {
+        auto& slot = books_[stock_locate];
+        slot = std::make_unique<Book>(stock_locate, expected_orders != 0 ? expected_orders * 2
+                                                                         : UNSIZED_BOOK_CAPACITY);
+        present_[stock_locate / 64] |= std::uint64_t{1} << (stock_locate % 64);
+        if (expected_orders != 0) mark_sized(stock_locate);
+        ++book_count_;
+        slot->set_depth_feed(depth_feed_, depth_feed_levels_);
+        if (depth_cache_levels_) slot->set_depth_cache(depth_cache_levels_);
+        return *slot;
+    }
+    
+    void mark_sized(StockLocate stock_locate) noexcept {
+        sized_[stock_locate / 64] |= std::uint64_t{1} << (stock_locate % 64);
+    }
+    
+    template<typename F>
+    static void for_each_bit(const std::array<std::uint64_t, PRESENT_WORDS>& words, F&& fn) {
+        for (std::size_t w = 0; w < PRESENT_WORDS; ++w) {
+            for (std::uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+                fn(w * 64 + static_cast<std::size_t>(__builtin_ctzll(bits)));
+            }
+        }
+    }
+    
+    template<typename F>
+    void for_each_present(F&& fn) const {
+        for_each_bit(present_, std::forward<F>(fn));
+    }
+    
+    template<typename F>
+    void for_each_active(F&& fn) {
+        for_each_present([&](std::size_t locate) { fn(*books_[locate]); });
+    }
 };
 
+using OrderBookManager = BasicOrderBookManager<WideOrderLayout>;
+using CompactOrderBookManager = BasicOrderBookManager<CompactOrderLayout>;
+
 // =============================================================================
 // Symbol Directory
 // =============================================================================
@@ -698,6 +1986,21 @@ public:
         }
         return count;
     }
+    
+    void clear() noexcept {
+        symbols_.clear();
+        symbol_to_locate_.clear();
+    }
+    
+    /**
+     * @brief Visit every active symbol as (locate, info)
+     */
+    template<typename F>
+    void for_each(F&& fn) const {
+        for (std::size_t i = 0; i < symbols_.size(); ++i) {
+            if (symbols_[i].is_active) fn(static_cast<StockLocate>(i), symbols_[i]);
+        }
+    }
 
 private:
     std::vector<SymbolInfo> symbols_;
@@ -0,0 +1,322 @@
+/**
+ * @file paged_order_map.hpp
+ * @brief Direct-indexed OrderId -> order handle table for monotonic order refs
+ *
+ * ITCH order reference numbers increase (roughly) monotonically through the
+ * day, so the live refs at any moment sit in a window that slides forward.
+ * This index maps a ref straight to its slot through two levels:
+ *
+ *   directory[(ref >> PAGE_BITS) & dir_mask]  ->  page->slots[ref & SLOT_MASK]
+ *
+ * A lookup is two dependent loads: no hashing, no probing, and nothing ever
+ * rehashes. The directory is a power-of-two ring covering the page numbers
+ * [base, base + span); pages are allocated lazily on first insert and go back
+ * to a free list as soon as their last order leaves, and the window's front
+ * advances past them.
+ *
+ * Refs that do not fit the pattern go to a SwissOrderMap fallback instead:
+ * - refs below the window (their page was already recycled)
+ * - new pages while the table is too sparse to pay for them: beyond MIN_PAGES
+ *   a page is only taken while the pages in use average at most
+ *   MAX_SLOTS_PER_ORDER slots per order they hold, so a book that sees one
+ *   ref in a thousand stays on the hash
+ * - the oldest page, when a long-lived order pins it so far behind the newest
+ *   ref that the window would span more than MAX_SPAN_PER_PAGE directory
+ *   entries per page in use (its survivors move to the fallback)
+ * - refs at or above HASHED_REF_FLOOR, far beyond any session's ref count
+ *   (e.g. the reserved warm-up refs, see warmup.hpp), so the window never
+ *   jumps there and evicts every page
+ * The fallback is probed only on a page miss while it is non-empty.
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "swiss_order_map.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace itch {
+
+/**
+ * @brief OrderId -> V table; V is an order handle whose value-initialised
+ * state is null (see BasicOrderMap)
+ */
+template<typename V>
+class BasicPagedOrderMap {
+public:
+    static constexpr unsigned PAGE_BITS = 9;
+    static constexpr std::size_t PAGE_SLOTS = std::size_t{1} << PAGE_BITS;
+    static constexpr std::size_t MIN_PAGES = 4;             // Always allowed
+    static constexpr std::size_t MAX_SLOTS_PER_ORDER = 16;  // Density floor for more
+    static constexpr std::size_t MIN_SPAN_PAGES = 64;       // Directory ring bound:
+    static constexpr std::size_t MAX_SPAN_PER_PAGE = 16;    // max(MIN, pages * PER_PAGE)
+    static constexpr OrderId HASHED_REF_FLOOR = OrderId{1} << 48;
+
+    explicit BasicPagedOrderMap(std::size_t initial_capacity = 100000)
+        : fallback_(initial_capacity / MAX_SLOTS_PER_ORDER) {}
+
+    V find(OrderId id) const noexcept {
+        const std::uint64_t page_no = id >> PAGE_BITS;
+        if (ITCH_LIKELY(page_no - base_ < span_)) {
+            if (const Page* page = directory_[page_no & dir_mask_]) {
+                if (V order = page->slots[id & SLOT_MASK]) {
+                    return order;
+                }
+            }
+        }
+        return fallback_.size() != 0 ? fallback_.find(id) : V{};
+    }
+
+    void put(OrderId id, V order) {
+        if (Page* page = page_for_insert(id)) {
+            page->slots[id & SLOT_MASK] = order;
+            ++page->live;
+        } else {
+            fallback_.put(id, order);
+        }
+        ++size_;
+    }
+
+    /**
+     * @brief put() that refuses an id already present
+     */
+    bool insert(OrderId id, V order) {
+        if (find(id)) {
+            return false;
+        }
+        put(id, order);
+        return true;
+    }
+
+    void remove(OrderId id) noexcept {
+        extract(id);
+    }
+
+    /**
+     * @brief Remove `id` and return its order (null handle if absent)
+     */
+    V extract(OrderId id) noexcept {
+        const std::uint64_t page_no = id >> PAGE_BITS;
+        if (ITCH_LIKELY(page_no - base_ < span_)) {
+            Page*& page = directory_[page_no & dir_mask_];
+            if (page) {
+                if (V order = page->slots[id & SLOT_MASK]) {
+                    page->slots[id & SLOT_MASK] = V{};
+                    --size_;
+                    if (--page->live == 0) {
+                        recycle(page);
+                        trim_front();
+                    }
+                    return order;
+                }
+            }
+        }
+        if (fallback_.size() == 0) {
+            return V{};
+        }
+        V order = fallback_.extract(id);
+        if (order) {
+            --size_;
+        }
+        return order;
+    }
+
+    void clear() noexcept {
+        for (std::size_t i = 0; i < span_; ++i) {
+            Page*& page = directory_[(base_ + i) & dir_mask_];
+            if (page) {
+                std::fill(std::begin(page->slots), std::end(page->slots), V{});
+                page->live = 0;
+                recycle(page);
+            }
+        }
+        span_ = 0;
+        fallback_.clear();
+        size_ = 0;
+    }
+
+    /**
+     * @brief Presize so `count` live orders need no allocation
+     *
+     * Pages come from one calloc (the OS zeroes them lazily, so untouched pages
+     * cost no memory); the fallback is sized for the share expected to miss.
+     */
+    void reserve(std::size_t count) {
+        const std::size_t pages = (count + PAGE_SLOTS - 1) / PAGE_SLOTS;
+        if (pages > free_pages_.size()) {
+            allocate_pages(pages - free_pages_.size());
+        }
+        fallback_.reserve(count / MAX_SLOTS_PER_ORDER);
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    std::size_t capacity() const noexcept {
+        return pages_in_use_ * PAGE_SLOTS + fallback_.capacity();
+    }
+
+    /**
+     * @brief Fault in the reserved free pages and the fallback ahead of the session
+     */
+    void prefault() noexcept {
+        for (Page* page : free_pages_) {
+            prefault_pages(page, sizeof(Page));
+        }
+        fallback_.prefault();
+    }
+
+    /// Pages currently holding at least one order
+    std::size_t pages_in_use() const noexcept { return pages_in_use_; }
+
+    /// Orders held by the hash fallback rather than a page
+    std::size_t fallback_size() const noexcept { return fallback_.size(); }
+
+private:
+    static constexpr std::uint64_t SLOT_MASK = PAGE_SLOTS - 1;
+
+    struct Page {
+        V slots[PAGE_SLOTS];
+        std::size_t live;
+    };
+
+    struct FreeDeleter {
+        void operator()(Page* p) const noexcept { std::free(p); }
+    };
+
+    std::vector<Page*> directory_;              // Ring over [base_, base_ + span_)
+    std::size_t dir_mask_ = 0;
+    std::uint64_t base_ = 0;                    // Page number of the window front
+    std::uint64_t span_ = 0;
+    std::size_t size_ = 0;
+    std::size_t pages_in_use_ = 0;
+    std::vector<Page*> free_pages_;             // All slots null
+    std::vector<std::unique_ptr<Page, FreeDeleter>> blocks_;
+    BasicSwissOrderMap<V> fallback_;
+
+    /**
+     * @brief Page that should hold `id`, allocating or extending the window
+     * as allowed, or nullptr to send `id` to the fallback
+     */
+    Page* page_for_insert(OrderId id) {
+        const std::uint64_t page_no = id >> PAGE_BITS;
+        if (ITCH_LIKELY(page_no - base_ < span_)) {
+            Page*& page = directory_[page_no & dir_mask_];
+            if (ITCH_LIKELY(page != nullptr)) {
+                return page;
+            }
+            return page_allowed() ? (page = take_page()) : nullptr;
+        }
+        if ((span_ != 0 && page_no < base_) || id >= HASHED_REF_FLOOR) {
+            return nullptr;     // Behind the window, or beyond any real ref: out of pattern
+        }
+        if (!page_allowed()) {
+            return nullptr;
+        }
+        extend_to(page_no);
+        Page*& page = directory_[page_no & dir_mask_];
+        page = take_page();
+        return page;
+    }
+
+    std::uint64_t span_limit() const noexcept {
+        return std::max(MIN_SPAN_PAGES, (pages_in_use_ + 1) * MAX_SPAN_PER_PAGE);
+    }
+
+    /// Density check over the orders the pages actually hold, so a book whose
+    /// refs mostly hash does not keep buying near-empty pages
+    bool page_allowed() const noexcept {
+        const std::size_t paged = size_ - fallback_.size();
+        return pages_in_use_ < MIN_PAGES ||
+               pages_in_use_ * PAGE_SLOTS <= (paged + 1) * MAX_SLOTS_PER_ORDER;
+    }
+
+    /// Grow the window forward to cover `page_no`, evicting the oldest pages
+    /// when the span would outgrow span_limit()
+    void extend_to(std::uint64_t page_no) {
+        if (span_ == 0) {
+            base_ = page_no;
+        }
+        while (span_ != 0 && page_no - base_ >= span_limit()) {
+            evict_front();
+        }
+        if (span_ == 0) {
+            base_ = page_no;
+        }
+        const std::uint64_t new_span = page_no - base_ + 1;
+        if (new_span > directory_.size()) {
+            grow_directory(static_cast<std::size_t>(new_span));
+        }
+        span_ = new_span;
+    }
+
+    void grow_directory(std::size_t min_size) {
+        std::size_t size = directory_.empty() ? 64 : directory_.size();
+        while (size < min_size) size <<= 1;
+        std::vector<Page*> grown(size, nullptr);
+        for (std::uint64_t i = 0; i < span_; ++i) {
+            grown[(base_ + i) & (size - 1)] = directory_[(base_ + i) & dir_mask_];
+        }
+        directory_ = std::move(grown);
+        dir_mask_ = size - 1;
+    }
+
+    /// Move the front page's orders to the fallback and drop it from the window
+    void evict_front() {
+        Page*& page = directory_[base_ & dir_mask_];
+        if (page) {
+            const OrderId first = base_ << PAGE_BITS;
+            for (std::size_t s = 0; s < PAGE_SLOTS && page->live != 0; ++s) {
+                if (page->slots[s]) {
+                    fallback_.put(first + s, page->slots[s]);
+                    page->slots[s] = V{};
+                    --page->live;
+                }
+            }
+            recycle(page);
+        }
+        ++base_;
+        --span_;
+        trim_front();
+    }
+
+    /// Advance the window front past pages that have been recycled
+    void trim_front() noexcept {
+        while (span_ != 0 && directory_[base_ & dir_mask_] == nullptr) {
+            ++base_;
+            --span_;
+        }
+    }
+
+    Page* take_page() {
+        if (free_pages_.empty()) {
+            allocate_pages(pages_in_use_ < MIN_PAGES ? 1 : pages_in_use_ / 2);
+        }
+        Page* page = free_pages_.back();
+        free_pages_.pop_back();
+        ++pages_in_use_;
+        return page;
+    }
+
+    void recycle(Page*& page) noexcept {
+        free_pages_.push_back(page);
+        page = nullptr;
+        --pages_in_use_;
+    }
+
+    void allocate_pages(std::size_t count) {
+        Page* block = static_cast<Page*>(std::calloc(count, sizeof(Page)));
+        blocks_.emplace_back(block);
+        free_pages_.reserve(free_pages_.size() + count);
+        for (std::size_t i = count; i-- > 0;) {
+            free_pages_.push_back(block + i);
+        }
+    }
+};
+
+using PagedOrderMap = BasicPagedOrderMap<Order*>;
+
+} // namespace itch
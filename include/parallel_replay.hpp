@@ -0,0 +1,258 @@
+/**
+ * @file parallel_replay.hpp
+ * @brief Multi-threaded file replay partitioned by stock_locate
+ *
+ * A raw ITCH file has no framing, so TemplateParser::parse() must walk it
+ * serially. ParallelReplay splits the work in two parallel phases per
+ * window of the file:
+ *
+ * 1. Boundary discovery: the window is cut into one chunk per thread. Each
+ *    thread speculatively finds the first message boundary in its chunk by
+ *    validating a chain of candidate messages against get_message_size(),
+ *    the stock_locate range and the timestamp range, then walks its chunk
+ *    and buckets message offsets by owning worker. Chunks are stitched
+ *    serially: if a chunk's walk does not end exactly where the next chunk
+ *    started, the next chunk is re-walked from the proven boundary.
+ * 2. Apply: every worker replays only the messages of its locates, in file
+ *    order, into a private FeedHandler (and so a private OrderBookManager).
+ *
+ * Every order message carries its stock_locate, so per-locate books come
+ * out identical to a serial replay. Offset buckets are 4 bytes per message
+ * of the current window only; windows bound memory on multi-GB files.
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "message_types.hpp"
+#include "feed_handler.hpp"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace itch {
+
+// =============================================================================
+// Boundary Discovery
+// =============================================================================
+
+/**
+ * @brief Whether `count` consecutive plausible messages start at `offset`
+ *
+ * A chain that ends exactly at `len`, or in a message truncated by `len`,
+ * after at least one whole message is accepted: the serial parser would
+ * stop at the same place.
+ */
+inline bool plausible_message_chain(const char* data, std::size_t len, std::size_t offset,
+                                    std::size_t count) noexcept {
+    constexpr Timestamp ONE_DAY_NS = 86400ULL * 1000000000ULL;
+    for (std::size_t k = 0; k < count; ++k) {
+        if (offset == len) {
+            return k > 0;
+        }
+        const std::size_t size = get_message_size(data[offset]);
+        if (size == 0) {
+            return false;
+        }
+        if (len - offset < size) {
+            return k > 0;
+        }
+        const StockLocate locate = endian::be16_to_host(
+            *reinterpret_cast<const std::uint16_t*>(data + offset + 1));
+        const Timestamp ts = endian::be48_to_host(
+            reinterpret_cast<const std::uint8_t*>(data + offset + 5));
+        if (locate >= OrderBookManager::MAX_SYMBOLS || ts >= ONE_DAY_NS) {
+            return false;
+        }
+        offset += size;
+    }
+    return true;
+}
+
+/**
+ * @brief First offset >= `from` that starts a plausible message chain, or `len`
+ */
+inline std::size_t find_message_boundary(const char* data, std::size_t len, std::size_t from,
+                                         std::size_t chain = 32) noexcept {
+    for (std::size_t offset = from; offset < len; ++offset) {
+        if (plausible_message_chain(data, len, offset, chain)) {
+            return offset;
+        }
+    }
+    return len;
+}
+
+// =============================================================================
+// Parallel Replay
+// =============================================================================
+
+struct ParallelReplayStats {
+    std::uint64_t messages = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t windows = 0;
+    std::uint64_t resyncs = 0;          // Speculative chunk starts that were wrong
+};
+
+class ParallelReplay {
+public:
+    static constexpr std::size_t DEFAULT_WINDOW_BYTES = 256 * 1024 * 1024;
+
+    explicit ParallelReplay(std::size_t threads = std::thread::hardware_concurrency(),
+                            std::size_t window_bytes = DEFAULT_WINDOW_BYTES)
+        : threads_(threads ? threads : 1),
+          window_bytes_(std::min<std::size_t>(window_bytes, 0xFFFF0000u)) {
+        for (std::size_t w = 0; w < threads_; ++w) {
+            workers_.push_back(std::make_unique<FeedHandler>());
+        }
+        chunks_.resize(threads_);
+        for (auto& chunk : chunks_) {
+            chunk.buckets.resize(threads_);
+        }
+    }
+
+    /**
+     * @brief Replay back-to-back ITCH messages
+     * @return Bytes consumed (stops at the first invalid message, like parse())
+     */
+    std::size_t process(const char* data, std::size_t len) {
+        std::size_t base = 0;
+        while (base < len) {
+            const std::size_t end = process_window(data, len, base);
+            if (end == base) break;
+            base = end;
+            if (!window_complete_) break;
+        }
+        stats_.bytes += base;
+        return base;
+    }
+
+    std::size_t process_file(const char* path) {
+        MemoryMappedFile file;
+        if (!file.open(path)) {
+            return 0;
+        }
+        return process(file.data(), file.size());
+    }
+
+    std::size_t worker_count() const noexcept { return threads_; }
+    std::size_t worker_for(StockLocate locate) const noexcept { return locate % threads_; }
+
+    FeedHandler& worker(std::size_t w) noexcept { return *workers_[w]; }
+    const FeedHandler& worker(std::size_t w) const noexcept { return *workers_[w]; }
+
+    /// Book for `locate` in its owning worker, or nullptr if never touched
+    const OrderBook* find_book(StockLocate locate) const noexcept {
+        return workers_[worker_for(locate)]->book_manager().find_book(locate);
+    }
+
+    std::size_t total_order_count() const noexcept {
+        std::size_t count = 0;
+        for (const auto& w : workers_) {
+            count += w->book_manager().total_order_count();
+        }
+        return count;
+    }
+
+    const ParallelReplayStats& stats() const noexcept { return stats_; }
+
+private:
+    struct Chunk {
+        std::size_t start = 0;
+        std::size_t end = 0;            // First boundary at or past the chunk's nominal end
+        bool valid = true;              // false: walk hit an unparseable message at `end`
+        std::uint64_t messages = 0;
+        std::vector<std::vector<std::uint32_t>> buckets;    // Window-relative offsets per worker
+    };
+
+    template<typename F>
+    void run_parallel(F&& fn) {
+        std::vector<std::thread> threads;
+        for (std::size_t t = 1; t < threads_; ++t) {
+            threads.emplace_back([&fn, t] { fn(t); });
+        }
+        fn(0);
+        for (auto& t : threads) t.join();
+    }
+
+    void walk(Chunk& chunk, const char* data, std::size_t len, std::size_t base,
+              std::size_t stop) {
+        for (auto& bucket : chunk.buckets) bucket.clear();
+        chunk.messages = 0;
+        chunk.valid = true;
+        std::size_t offset = chunk.start;
+        while (offset < stop) {
+            const std::size_t size = get_message_size(data[offset]);
+            if (ITCH_UNLIKELY(size == 0 || len - offset < size)) {
+                chunk.valid = false;
+                break;
+            }
+            const StockLocate locate = endian::be16_to_host(
+                *reinterpret_cast<const std::uint16_t*>(data + offset + 1));
+            chunk.buckets[worker_for(locate)].push_back(static_cast<std::uint32_t>(offset - base));
+            ++chunk.messages;
+            offset += size;
+        }
+        chunk.end = offset;
+    }
+
+    /// Replays the window starting at boundary `base`; returns the next boundary
+    std::size_t process_window(const char* data, std::size_t len, std::size_t base) {
+        const std::size_t window_end = std::min(len, base + window_bytes_);
+        const std::size_t span = window_end - base;
+
+        // Phase 1: speculative boundary discovery and bucketing
+        run_parallel([&](std::size_t c) {
+            Chunk& chunk = chunks_[c];
+            const std::size_t nominal = base + span * c / threads_;
+            const std::size_t stop = c + 1 == threads_ ? window_end
+                                                       : base + span * (c + 1) / threads_;
+            chunk.start = c == 0 ? base : find_message_boundary(data, len, nominal);
+            walk(chunk, data, len, base, std::max(stop, chunk.start));
+        });
+
+        // Stitch: every chunk must start where its predecessor's walk ended
+        std::size_t used = threads_;
+        for (std::size_t c = 1; c < threads_; ++c) {
+            const Chunk& prev = chunks_[c - 1];
+            if (!prev.valid) {
+                used = c;
+                break;
+            }
+            if (chunks_[c].start != prev.end) {
+                ++stats_.resyncs;
+                const std::size_t stop = c + 1 == threads_ ? window_end
+                                                           : base + span * (c + 1) / threads_;
+                chunks_[c].start = prev.end;
+                walk(chunks_[c], data, len, base, std::max(stop, prev.end));
+            }
+        }
+        window_complete_ = chunks_[used - 1].valid;
+
+        // Phase 2: each worker applies its own locates in file order
+        run_parallel([&](std::size_t w) {
+            FeedHandler& handler = *workers_[w];
+            for (std::size_t c = 0; c < used; ++c) {
+                for (std::uint32_t rel : chunks_[c].buckets[w]) {
+                    const char* msg = data + base + rel;
+                    handler.process(msg, get_message_size(msg[0]));
+                }
+            }
+        });
+
+        for (std::size_t c = 0; c < used; ++c) {
+            stats_.messages += chunks_[c].messages;
+        }
+        ++stats_.windows;
+        return chunks_[used - 1].end;
+    }
+
+    std::size_t threads_;
+    std::size_t window_bytes_;
+    std::vector<std::unique_ptr<FeedHandler>> workers_;
+    std::vector<Chunk> chunks_;
+    ParallelReplayStats stats_;
+    bool window_complete_ = true;
+};
+
+} // namespace itch
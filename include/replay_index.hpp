@@ -0,0 +1,297 @@
+/**
+ * @file replay_index.hpp
+ * @brief Timestamp / offset sidecar index for seek-to-time replay
+ *
+ * One pass over a raw ITCH day file records (timestamp, byte offset,
+ * message sequence) samples every K messages or every sample_ns of feed
+ * time, plus the offset of every StockDirectoryMessage. A replay can then
+ * binary-search the samples to start at any time, or - combined with a
+ * checkpoint - rebuild the books as of any time without replaying the
+ * file from byte zero.
+ *
+ * Sidecar layout (host-endian, written next to the data file as <file>.idx):
+ *   ReplayIndexHeader
+ *   ReplayIndexEntry  x entry_count
+ *   std::uint64_t     x directory_count   (StockDirectoryMessage offsets)
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "message_types.hpp"
+#include "feed_handler.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+namespace itch {
+
+// =============================================================================
+// On-Disk Records
+// =============================================================================
+
+struct ReplayIndexHeader {
+    char          magic[8];         // "ITCHIDX\0"
+    std::uint32_t version;
+    std::uint32_t sample_messages;  // K: at most this many messages between samples
+    std::uint64_t sample_ns;        // ... or this much feed time
+    std::uint64_t entry_count;
+    std::uint64_t directory_count;
+    std::uint64_t message_count;    // Messages in the indexed file
+    std::uint64_t file_size;        // Bytes of whole messages in the indexed file
+    std::uint64_t reserved;
+
+    static constexpr char MAGIC[8] = {'I', 'T', 'C', 'H', 'I', 'D', 'X', '\0'};
+    static constexpr std::uint32_t VERSION = 1;
+};
+static_assert(sizeof(ReplayIndexHeader) == 64, "ReplayIndexHeader must be 64 bytes");
+
+/**
+ * @brief One sample: the message at `offset` is message number `sequence`
+ *
+ * `timestamp` is the highest timestamp seen up to and including that
+ * message, so samples stay sorted even if the feed is not strictly
+ * monotonic and every message before `offset` is no later than it.
+ */
+struct ReplayIndexEntry {
+    Timestamp     timestamp;
+    std::uint64_t offset;
+    std::uint64_t sequence;
+};
+static_assert(sizeof(ReplayIndexEntry) == 24, "ReplayIndexEntry must be 24 bytes");
+
+// =============================================================================
+// Replay Index
+// =============================================================================
+
+/**
+ * @brief Sampling policy: a sample is taken when either limit is reached
+ */
+struct ReplayIndexOptions {
+    std::uint32_t sample_messages = 4096;
+    std::uint64_t sample_ns = 1000000;      // 1 ms
+};
+
+class ReplayIndex {
+public:
+    using Options = ReplayIndexOptions;
+
+    /// Conventional sidecar location for a data file
+    static std::string sidecar_path(const char* data_path) {
+        return std::string(data_path) + ".idx";
+    }
+
+    /**
+     * @brief Index a buffer of back-to-back ITCH messages
+     * @return false if the buffer does not end on a message boundary; the
+     *         index still covers every whole message before that point
+     */
+    bool build(const char* data, std::size_t len, Options options = Options{}) {
+        options_ = options;
+        entries_.clear();
+        directory_.clear();
+        message_count_ = 0;
+
+        std::size_t offset = 0;
+        Timestamp max_ts = 0;
+        ReplayIndexEntry last{0, 0, 0};
+        while (offset < len) {
+            const std::size_t size = get_message_size(data[offset]);
+            if (ITCH_UNLIKELY(size == 0 || len - offset < size)) {
+                break;
+            }
+            const Timestamp ts = endian::be48_to_host(
+                reinterpret_cast<const std::uint8_t*>(data + offset + 5));
+            max_ts = std::max(max_ts, ts);
+
+            if (entries_.empty() ||
+                message_count_ - last.sequence >= options_.sample_messages ||
+                max_ts - last.timestamp >= options_.sample_ns) {
+                last = {max_ts, offset, message_count_};
+                entries_.push_back(last);
+            }
+            if (data[offset] == 'R') {
+                directory_.push_back(offset);
+            }
+
+            offset += size;
+            ++message_count_;
+        }
+        file_size_ = offset;
+        return offset == len;
+    }
+
+    bool build_file(const char* path, Options options = Options{}) {
+        MemoryMappedFile file;
+        if (!file.open(path)) {
+            return false;
+        }
+        return build(file.data(), file.size(), options);
+    }
+
+    bool save(const char* path) const {
+        BufferedFileWriter out;
+        if (!out.open(path)) {
+            return false;
+        }
+        ReplayIndexHeader header{};
+        std::memcpy(header.magic, ReplayIndexHeader::MAGIC, sizeof(header.magic));
+        header.version = ReplayIndexHeader::VERSION;
+        header.sample_messages = options_.sample_messages;
+        header.sample_ns = options_.sample_ns;
+        header.entry_count = entries_.size();
+        header.directory_count = directory_.size();
+        header.message_count = message_count_;
+        header.file_size = file_size_;
+        out.write_pod(header);
+        out.write(entries_.data(), entries_.size() * sizeof(ReplayIndexEntry));
+        out.write(directory_.data(), directory_.size() * sizeof(std::uint64_t));
+        return out.commit();
+    }
+
+    bool load(const char* path) {
+        MemoryMappedFile file;
+        if (!file.open(path) || file.size() < sizeof(ReplayIndexHeader)) {
+            return false;
+        }
+        ReplayIndexHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, ReplayIndexHeader::MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != ReplayIndexHeader::VERSION) {
+            return false;
+        }
+        const std::uint64_t expected = sizeof(ReplayIndexHeader) +
+            header.entry_count * sizeof(ReplayIndexEntry) +
+            header.directory_count * sizeof(std::uint64_t);
+        if (expected != file.size()) {
+            return false;
+        }
+
+        const char* cursor = file.data() + sizeof(header);
+        entries_.resize(static_cast<std::size_t>(header.entry_count));
+        std::memcpy(entries_.data(), cursor, entries_.size() * sizeof(ReplayIndexEntry));
+        cursor += entries_.size() * sizeof(ReplayIndexEntry);
+        directory_.resize(static_cast<std::size_t>(header.directory_count));
+        std::memcpy(directory_.data(), cursor, directory_.size() * sizeof(std::uint64_t));
+
+        options_.sample_messages = header.sample_messages;
+        options_.sample_ns = header.sample_ns;
+        message_count_ = header.message_count;
+        file_size_ = header.file_size;
+        return true;
+    }
+
+    /**
+     * @brief Latest sample at which every earlier message is before `ts`
+     *
+     * Binary search; returns the first sample (offset 0) when `ts` precedes
+     * the whole file.
+     */
+    ReplayIndexEntry seek(Timestamp ts) const noexcept {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), ts,
+            [](const ReplayIndexEntry& e, Timestamp t) { return e.timestamp < t; });
+        if (it == entries_.begin()) {
+            return ReplayIndexEntry{0, 0, 0};
+        }
+        return *(it - 1);
+    }
+
+    /**
+     * @brief Exact position of the first message with timestamp >= `ts`
+     *
+     * seek() followed by a forward scan of at most one sample interval over
+     * `data`, which must be the indexed file. Returns the end of the file
+     * when no such message exists, and also when `data` stops parsing like
+     * the indexed file (truncated, another file, BinaryFILE framing).
+     */
+    ReplayPosition locate(const char* data, std::size_t len, Timestamp ts) const noexcept {
+        const ReplayIndexEntry start = seek(ts);
+        ReplayPosition pos{start.sequence, start.offset};
+        const std::size_t end = static_cast<std::size_t>(std::min<std::uint64_t>(len, file_size_));
+        while (pos.offset < end) {
+            const char* msg = data + pos.offset;
+            const std::size_t size = get_message_size(msg[0]);
+            if (size == 0 || end - pos.offset < size) {
+                pos.offset = end;
+                break;
+            }
+            const Timestamp msg_ts = endian::be48_to_host(
+                reinterpret_cast<const std::uint8_t*>(msg + 5));
+            if (msg_ts >= ts) {
+                break;
+            }
+            pos.offset += size;
+            ++pos.sequence;
+        }
+        if (pos.offset > end) {
+            pos.offset = end;
+        }
+        return pos;
+    }
+
+    const std::vector<ReplayIndexEntry>& entries() const noexcept { return entries_; }
+    const std::vector<std::uint64_t>& directory_offsets() const noexcept { return directory_; }
+    const Options& options() const noexcept { return options_; }
+    std::uint64_t message_count() const noexcept { return message_count_; }
+    std::uint64_t file_size() const noexcept { return file_size_; }
+
+private:
+    Options options_;
+    std::vector<ReplayIndexEntry> entries_;
+    std::vector<std::uint64_t> directory_;
+    std::uint64_t message_count_ = 0;
+    std::uint64_t file_size_ = 0;
+};
+
+// =============================================================================
+// Seek-to-Time Replay
+// =============================================================================
+
+/**
+ * @brief Replay messages with timestamps in [from, to] into `handler`
+ *
+ * Directory records located before the window are applied first so every
+ * symbol in the window resolves. Books only contain orders added inside the
+ * window; load a checkpoint and use replay_until() for full books.
+ */
+inline std::size_t replay_range(FeedHandler& handler, const char* data, std::size_t len,
+                                const ReplayIndex& index, Timestamp from, Timestamp to) {
+    const ReplayPosition start = index.locate(data, len, from);
+    for (std::uint64_t offset : index.directory_offsets()) {
+        if (offset >= start.offset) break;
+        handler.process(data + offset, sizeof(StockDirectoryMessage));
+    }
+    handler.set_position(start);
+
+    const ReplayPosition end = to == std::numeric_limits<Timestamp>::max()
+        ? ReplayPosition{index.message_count(), index.file_size()}
+        : index.locate(data, len, to + 1);
+    if (end.offset <= start.offset) {
+        return 0;
+    }
+    return handler.process(data + start.offset, static_cast<std::size_t>(end.offset - start.offset));
+}
+
+/**
+ * @brief Advance `handler` from its current position() up to and including `ts`
+ *
+ * Typically called right after load_checkpoint() to show the books as of
+ * `ts`. Returns false if the handler is already past `ts`.
+ */
+inline bool replay_until(FeedHandler& handler, const char* data, std::size_t len,
+                         const ReplayIndex& index, Timestamp ts) {
+    const ReplayPosition end = ts == std::numeric_limits<Timestamp>::max()
+        ? ReplayPosition{index.message_count(), index.file_size()}
+        : index.locate(data, len, ts + 1);
+    const std::uint64_t start = handler.position().offset;
+    if (start > end.offset) {
+        return false;
+    }
+    handler.process(data + start, static_cast<std::size_t>(end.offset - start));
+    return handler.position().offset == end.offset;
+}
+
+} // namespace itch
@@ -0,0 +1,177 @@
+/**
+ * @file sizing_profile.hpp
+ * @brief End-of-day sizing profile for warm-starting the next session
+ *
+ * The order pool block size and the default order-index capacity are fixed
+ * guesses, so a session that outgrows them grows during the opening burst.
+ * A sizing profile records what the day actually needed (peak live orders
+ * overall, and per locate the peak live orders, peak level counts and the
+ * price range) from the high-water marks the books and the order store keep.
+ * Save it before the end-of-day reset; at the next start-up, load it and
+ * apply it before the first message so the pool and every profiled book's
+ * order index are already large enough.
+ *
+ * Level counts and price ranges are recorded for capacity planning; the
+ * std::map level store has no capacity to presize.
+ *
+ * File layout (host-endian, all records naturally aligned):
+ *   SizingProfileHeader
+ *   SizingProfileBook x book_count
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "order_book.hpp"
+#include "feed_handler.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace itch {
+
+// =============================================================================
+// On-Disk Records
+// =============================================================================
+
+struct SizingProfileHeader {
+    char          magic[8];         // "ITCHSIZE"
+    std::uint32_t version;
+    std::uint32_t book_count;
+    std::uint64_t peak_live_orders; // Across all books at once
+
+    static constexpr char MAGIC[8] = {'I', 'T', 'C', 'H', 'S', 'I', 'Z', 'E'};
+    static constexpr std::uint32_t VERSION = 1;
+};
+static_assert(sizeof(SizingProfileHeader) == 24, "SizingProfileHeader must be 24 bytes");
+
+struct SizingProfileBook {
+    StockLocate   stock_locate;
+    std::uint16_t reserved;
+    std::uint32_t peak_orders;
+    std::uint32_t peak_bid_levels;
+    std::uint32_t peak_ask_levels;
+    std::uint32_t min_price;        // ITCH prices are 32-bit on the wire
+    std::uint32_t max_price;
+};
+static_assert(sizeof(SizingProfileBook) == 24, "SizingProfileBook must be 24 bytes");
+
+/**
+ * @brief In-memory profile: one record per book that held an order
+ */
+struct SizingProfile {
+    std::uint64_t peak_live_orders = 0;
+    std::vector<SizingProfileBook> books;
+};
+
+// =============================================================================
+// Capture / Save / Load
+// =============================================================================
+
+/**
+ * @brief Profile of the session so far (call before reset())
+ */
+inline SizingProfile capture_sizing_profile(const FeedHandler& handler) {
+    const OrderBookManager& books = handler.book_manager();
+    SizingProfile profile;
+    profile.peak_live_orders = books.order_pool().peak_in_use();
+    books.for_each_book([&](const OrderBook& book) {
+        const BookPeaks& peaks = book.peaks();
+        if (peaks.orders == 0) return;
+        SizingProfileBook rec{};
+        rec.stock_locate = book.stock_locate();
+        rec.peak_orders = static_cast<std::uint32_t>(peaks.orders);
+        rec.peak_bid_levels = static_cast<std::uint32_t>(peaks.bid_levels);
+        rec.peak_ask_levels = static_cast<std::uint32_t>(peaks.ask_levels);
+        rec.min_price = static_cast<std::uint32_t>(peaks.min_price);
+        rec.max_price = static_cast<std::uint32_t>(peaks.max_price);
+        profile.books.push_back(rec);
+    });
+    return profile;
+}
+
+inline bool save_sizing_profile(const SizingProfile& profile, const char* path) {
+    BufferedFileWriter out(64 * 1024);
+    if (!out.open(path)) {
+        return false;
+    }
+    SizingProfileHeader header{};
+    std::memcpy(header.magic, SizingProfileHeader::MAGIC, sizeof(header.magic));
+    header.version = SizingProfileHeader::VERSION;
+    header.book_count = static_cast<std::uint32_t>(profile.books.size());
+    header.peak_live_orders = profile.peak_live_orders;
+    out.write_pod(header);
+    for (const SizingProfileBook& rec : profile.books) {
+        out.write_pod(rec);
+    }
+    return out.commit();
+}
+
+/**
+ * @brief Write the end-of-day profile of `handler` to `path`
+ */
+inline bool save_sizing_profile(const FeedHandler& handler, const char* path) {
+    return save_sizing_profile(capture_sizing_profile(handler), path);
+}
+
+inline bool load_sizing_profile(const char* path, SizingProfile& profile) {
+    MemoryMappedFile file;
+    if (!file.open(path) || file.size() < sizeof(SizingProfileHeader)) {
+        return false;
+    }
+    SizingProfileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, SizingProfileHeader::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SizingProfileHeader::VERSION ||
+        file.size() != sizeof(header) + std::uint64_t{header.book_count} * sizeof(SizingProfileBook)) {
+        return false;
+    }
+    profile.peak_live_orders = header.peak_live_orders;
+    profile.books.resize(header.book_count);
+    if (header.book_count != 0) {
+        std::memcpy(profile.books.data(), file.data() + sizeof(header),
+                    profile.books.size() * sizeof(SizingProfileBook));
+    }
+    return true;
+}
+
+// =============================================================================
+// Warm Start
+// =============================================================================
+
+/**
+ * @brief Presize `handler` from a previous day's profile
+ *
+ * Reserves the order pool for the profiled peak and opens every profiled
+ * book with its order index sized for that book's peak, each scaled by
+ * `headroom` for a busier day. Call before the first message; books the
+ * profile does not name start unsized (UNSIZED_BOOK_CAPACITY).
+ */
+inline void apply_sizing_profile(FeedHandler& handler, const SizingProfile& profile,
+                                 double headroom = 1.25) {
+    OrderBookManager& books = handler.book_manager();
+    auto scaled = [headroom](std::uint64_t count) {
+        return static_cast<std::size_t>(static_cast<double>(count) * headroom);
+    };
+    books.order_pool().reserve(scaled(profile.peak_live_orders));
+    for (const SizingProfileBook& rec : profile.books) {
+        if (rec.stock_locate < OrderBookManager::MAX_SYMBOLS) {
+            books.get_book(rec.stock_locate, scaled(rec.peak_orders));
+        }
+    }
+}
+
+/**
+ * @brief load_sizing_profile() + apply_sizing_profile(); false (and nothing
+ * presized) if `path` is missing or not a valid profile
+ */
+inline bool warm_start(FeedHandler& handler, const char* path, double headroom = 1.25) {
+    SizingProfile profile;
+    if (!load_sizing_profile(path, profile)) {
+        return false;
+    }
+    apply_sizing_profile(handler, profile, headroom);
+    return true;
+}
+
+} // namespace itch
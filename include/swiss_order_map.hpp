@@ -0,0 +1,318 @@
+/**
+ * @file swiss_order_map.hpp
+ * @brief SIMD group-probing OrderId -> order handle index (alternative OrderMap backend)
+ *
+ * Layout:
+ * - Slots are split into groups of 15. Each group is a 256-byte block: a
+ *   16-byte control word followed by its 15 {id, order} entries. Control
+ *   bytes 0..14 hold a tag per slot (0 = empty, 0x80 | 7 hash bits = full),
+ *   byte 15 is the group's overflow count.
+ * - A lookup compares all 15 tags against the key's tag in one SSE2 compare
+ *   (scalar loop elsewhere) and only touches entries whose tag matches, so a
+ *   probe costs one 16-byte load per group instead of one key per slot.
+ * - Keys are spread by a full 64-bit mix, so sequential, strided or otherwise
+ *   clustered order refs land uniformly across groups.
+ *
+ * Probing walks groups linearly from the home group. The overflow count of a
+ * group is the number of entries that were displaced past it, so a lookup
+ * stops at the first group with a zero count - no need to find an empty slot.
+ * Deletion just clears the tag and decrements the counts on the entry's probe
+ * path: there are no tombstones and lookups never degrade with churn.
+ *
+ * Probe length is bounded: an insert that would need more than
+ * MAX_PROBE_GROUPS groups grows the table instead, so no lookup ever visits
+ * more than MAX_PROBE_GROUPS control words. Load is capped at 7/8.
+ */
+
+#pragma once
+
+#include "common.hpp"
+
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ITCH_SWISS_SSE2 1
+#endif
+
+namespace itch {
+
+struct Order;
+
+/**
+ * @brief OrderId -> V index; V is an order handle whose value-initialised
+ * state is null (see BasicOrderMap)
+ */
+template<typename V>
+class BasicSwissOrderMap {
+public:
+    static constexpr std::size_t GROUP_SLOTS = 15;
+    static constexpr std::size_t MAX_PROBE_GROUPS = 16;
+
+    explicit BasicSwissOrderMap(std::size_t initial_capacity = 100000) {
+        rehash(groups_for_slots(initial_capacity));
+    }
+
+    V find(OrderId id) const noexcept {
+        const std::uint64_t h = hash(id);
+        const std::uint8_t tag = tag_of(h);
+        std::size_t g = group_of(h);
+        for (std::size_t probe = 0; probe < MAX_PROBE_GROUPS; ++probe) {
+            const Group& group = groups_[g];
+            for (std::uint32_t m = match(group, tag); m; m &= m - 1) {
+                const Entry& e = group.entries[lowest_bit(m)];
+                if (e.id == id) {
+                    return e.order;
+                }
+            }
+            if (ITCH_LIKELY(group.ctrl[OVERFLOW_BYTE] == 0)) {
+                break;
+            }
+            g = (g + 1) & group_mask_;
+        }
+        return V{};
+    }
+
+    void put(OrderId id, V order) noexcept {
+        place(hash(id), id, order);
+    }
+
+    /**
+     * @brief put() that refuses an id already present
+     */
+    bool insert(OrderId id, V order) noexcept {
+        const std::uint64_t h = hash(id);
+        if (locate(h, id).group) {
+            return false;
+        }
+        place(h, id, order);
+        return true;
+    }
+
+    void remove(OrderId id) noexcept {
+        extract(id);
+    }
+
+    /**
+     * @brief Remove `id` and return its order (null handle if absent)
+     */
+    V extract(OrderId id) noexcept {
+        const std::uint64_t h = hash(id);
+        const Location loc = locate(h, id);
+        if (!loc.group) {
+            return V{};
+        }
+        loc.group->ctrl[loc.slot] = EMPTY;
+        // Entries displaced past a group keep it on their probe path; undo
+        // this entry's contribution so lookups can stop there again.
+        std::size_t g = group_of(h);
+        for (std::size_t i = 0; i < loc.probe; ++i) {
+            std::uint8_t& overflow = groups_[g].ctrl[OVERFLOW_BYTE];
+            if (overflow != OVERFLOW_STICKY) {
+                --overflow;
+            }
+            g = (g + 1) & group_mask_;
+        }
+        --size_;
+        return loc.group->entries[loc.slot].order;
+    }
+
+    void clear() noexcept {
+        for (Group& group : groups_) {
+            std::memset(group.ctrl, 0, sizeof(group.ctrl));
+        }
+        size_ = 0;
+    }
+
+    /**
+     * @brief Presize so `count` entries fit without growing
+     */
+    void reserve(std::size_t count) {
+        if (count > max_load()) {
+            rehash(groups_for_slots(count + count / 7 + 1));
+        }
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    std::size_t capacity() const noexcept { return groups_.size() * GROUP_SLOTS; }
+
+    /**
+     * @brief Fault in every group's pages ahead of the session
+     */
+    void prefault() noexcept {
+        prefault_pages(groups_.data(), groups_.size() * sizeof(Group));
+    }
+
+    /// Longest probe (in groups, 1 = home group) any insert has needed
+    std::size_t max_probe() const noexcept { return max_probe_; }
+
+private:
+    static constexpr std::size_t OVERFLOW_BYTE = GROUP_SLOTS;
+    static constexpr std::uint8_t OVERFLOW_STICKY = 0xFF;   // Saturated; cleared by rehash
+    static constexpr std::uint8_t EMPTY = 0;
+    static constexpr std::uint32_t SLOT_MASK = (1u << GROUP_SLOTS) - 1;
+
+    struct Entry {
+        OrderId id;
+        V order;
+    };
+
+    // Control word and its entries share one 256-byte block: a hit reads the
+    // control line and at most one neighbouring line.
+    struct alignas(CACHE_LINE_SIZE) Group {
+        std::uint8_t ctrl[16];
+        Entry entries[GROUP_SLOTS];
+    };
+
+    struct Location {
+        Group* group;
+        unsigned slot;
+        std::size_t probe;      // Groups passed before the one holding it
+    };
+
+    std::vector<Group> groups_;
+    std::size_t group_mask_ = 0;
+    std::size_t size_ = 0;
+    std::size_t max_probe_ = 0;
+
+    static std::uint64_t hash(OrderId id) noexcept {
+        // MurmurHash3 fmix64: a bijection, so distinct ids never fully collide
+        std::uint64_t h = id;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static std::uint8_t tag_of(std::uint64_t h) noexcept {
+        return static_cast<std::uint8_t>(0x80 | (h & 0x7F));
+    }
+
+    std::size_t group_of(std::uint64_t h) const noexcept {
+        return static_cast<std::size_t>(h >> 7) & group_mask_;
+    }
+
+    std::size_t max_load() const noexcept {
+        return capacity() - capacity() / 8;
+    }
+
+    static std::uint32_t match(const Group& group, std::uint8_t tag) noexcept {
+#if defined(ITCH_SWISS_SSE2)
+        const __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group.ctrl));
+        const __m128i eq = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(tag)));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(eq)) & SLOT_MASK;
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < GROUP_SLOTS; ++i) {
+            mask |= static_cast<std::uint32_t>(group.ctrl[i] == tag) << i;
+        }
+        return mask;
+#endif
+    }
+
+    static unsigned lowest_bit(std::uint32_t mask) noexcept {
+#if defined(ITCH_GCC_COMPATIBLE)
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#elif defined(ITCH_MSVC)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        unsigned index = 0;
+        while (!(mask & 1u)) {
+            mask >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    Location locate(std::uint64_t h, OrderId id) noexcept {
+        const std::uint8_t tag = tag_of(h);
+        std::size_t g = group_of(h);
+        for (std::size_t probe = 0; probe < MAX_PROBE_GROUPS; ++probe) {
+            Group& group = groups_[g];
+            for (std::uint32_t m = match(group, tag); m; m &= m - 1) {
+                if (group.entries[lowest_bit(m)].id == id) {
+                    return {&groups_[g], lowest_bit(m), probe};
+                }
+            }
+            if (group.ctrl[OVERFLOW_BYTE] == 0) {
+                break;
+            }
+            g = (g + 1) & group_mask_;
+        }
+        return {nullptr, 0, 0};
+    }
+
+    void place(std::uint64_t h, OrderId id, V order) {
+        if (ITCH_UNLIKELY(size_ >= max_load())) {
+            rehash(groups_.size() * 2);
+        }
+        while (!try_place(h, id, order)) {
+            // Probe bound exceeded: doubling adds a hash bit and splits the run
+            rehash(groups_.size() * 2);
+        }
+        ++size_;
+    }
+
+    bool try_place(std::uint64_t h, OrderId id, V order) noexcept {
+        const std::size_t home = group_of(h);
+        std::size_t g = home;
+        for (std::size_t probe = 0; probe < MAX_PROBE_GROUPS; ++probe) {
+            const std::uint32_t empty = match(groups_[g], EMPTY);
+            if (empty) {
+                const unsigned slot = lowest_bit(empty);
+                groups_[g].ctrl[slot] = tag_of(h);
+                groups_[g].entries[slot] = {id, order};
+                for (std::size_t i = 0, p = home; i < probe; ++i, p = (p + 1) & group_mask_) {
+                    std::uint8_t& overflow = groups_[p].ctrl[OVERFLOW_BYTE];
+                    if (overflow != OVERFLOW_STICKY) {
+                        ++overflow;
+                    }
+                }
+                if (probe + 1 > max_probe_) {
+                    max_probe_ = probe + 1;
+                }
+                return true;
+            }
+            g = (g + 1) & group_mask_;
+        }
+        return false;
+    }
+
+    static std::size_t groups_for_slots(std::size_t slots) noexcept {
+        std::size_t groups = 1;
+        while (groups * GROUP_SLOTS < slots) groups <<= 1;
+        return groups;
+    }
+
+    void rehash(std::size_t new_groups) {
+        std::vector<Group> old_groups = std::move(groups_);
+        for (;;) {
+            groups_.assign(new_groups, Group{});
+            group_mask_ = new_groups - 1;
+            max_probe_ = 0;
+            bool placed = true;
+            for (std::size_t g = 0; g < old_groups.size() && placed; ++g) {
+                for (std::size_t s = 0; s < GROUP_SLOTS; ++s) {
+                    if (old_groups[g].ctrl[s] == EMPTY) continue;
+                    const Entry& e = old_groups[g].entries[s];
+                    if (!try_place(hash(e.id), e.id, e.order)) {
+                        placed = false;
+                        break;
+                    }
+                }
+            }
+            if (placed) return;
+            new_groups *= 2;
+        }
+    }
+};
+
+using SwissOrderMap = BasicSwissOrderMap<Order*>;
+
+} // namespace itch
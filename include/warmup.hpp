@@ -0,0 +1,169 @@
+/**
+ * @file warmup.hpp
+ * @brief Synthetic ITCH message mix used to warm the feed path
+ *
+ * FeedHandler::warmup() and FeedHandler::idle_warmup() push a WarmupBatch
+ * per book through the real parser and books, so the dispatch switch, the
+ * add/execute/cancel/replace/delete handlers, the std::map level paths and
+ * the event paths are all hot (i-cache, branch predictors, TLB, the book's
+ * own lines) when real traffic arrives. The handler rolls back everything
+ * the batch changed; see FeedHandler::warm_books().
+ *
+ * A batch only touches its own orders: refs are drawn from
+ * [WARMUP_ORDER_REF_BASE, ...), far above anything a real session assigns,
+ * and every order it adds is executed away or deleted before it ends. Prices
+ * sit at and just behind the book's current best bid and offer (or around
+ * DEFAULT_MID for an empty side), so real levels are joined and new ones
+ * created without ever crossing the book.
+ */
+
+#pragma once
+
+#include "common.hpp"
+#include "message_types.hpp"
+#include "order_book.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace itch {
+
+/// Order refs at or above this are reserved for synthetic warm-up orders
+constexpr OrderId WARMUP_ORDER_REF_BASE = OrderId{0xF} << 60;
+
+/**
+ * @brief One book's synthetic message mix, encoded in wire format
+ *
+ * Per side, ORDERS_PER_SIDE adds (two at the best price, two one tick
+ * behind, the last as an 'F'); then a partial 'E', a printable 'C', a
+ * partial 'X', a 'U' onto a new level, a full 'E', a 'P' trade and a 'D'
+ * for every order still open: 21 messages, 629 bytes.
+ */
+class WarmupBatch {
+public:
+    static constexpr std::size_t ORDERS_PER_SIDE = 4;
+    static constexpr std::size_t MAX_BYTES = 1024;
+    static constexpr Price DEFAULT_MID = 1000000;   // $100.0000
+    static constexpr Price TICK = 100;              // $0.01
+    static constexpr Quantity SHARES = 100;
+
+    /**
+     * @brief Encode the mix for `locate` around `bbo`
+     * @return bytes encoded (size())
+     */
+    std::size_t build(StockLocate locate, const BBO& bbo) noexcept {
+        size_ = 0;
+        locate_ = locate;
+        const Price bid = bbo.has_bid() ? bbo.bid_price
+                        : bbo.has_ask() ? bbo.ask_price - TICK : DEFAULT_MID - TICK;
+        const Price ask = bbo.has_ask() ? bbo.ask_price : bid + 2 * TICK;
+
+        // Refs 0..3 bids, 4..7 asks, 8 the replacement of ask 5
+        for (std::size_t k = 0; k < ORDERS_PER_SIDE; ++k) {
+            const Price behind = static_cast<Price>(k / 2) * TICK;
+            add(ref(k), 'B', bid - behind, k + 1 == ORDERS_PER_SIDE);
+            add(ref(ORDERS_PER_SIDE + k), 'S', ask + behind, k + 1 == ORDERS_PER_SIDE);
+        }
+
+        auto& exec = append<OrderExecutedMessage>('E');
+        put64(exec.order_ref_number, ref(0));
+        put32(exec.executed_shares, SHARES / 4);
+        put64(exec.match_number, ref(0));
+
+        auto& exec_price = append<OrderExecutedPriceMessage>('C');
+        put64(exec_price.order_ref_number, ref(4));
+        put32(exec_price.executed_shares, SHARES / 4);
+        put64(exec_price.match_number, ref(4));
+        exec_price.printable = 'Y';
+        put32(exec_price.execution_price, wire_price(ask));
+
+        auto& cancel = append<OrderCancelMessage>('X');
+        put64(cancel.order_ref_number, ref(1));
+        put32(cancel.cancelled_shares, SHARES / 4);
+
+        auto& replace = append<OrderReplaceMessage>('U');
+        put64(replace.original_order_ref_number, ref(5));
+        put64(replace.new_order_ref_number, ref(8));
+        put32(replace.shares, SHARES);
+        put32(replace.price, wire_price(ask + 2 * TICK));
+
+        auto& fill = append<OrderExecutedMessage>('E');
+        put64(fill.order_ref_number, ref(2));
+        put32(fill.executed_shares, SHARES);
+        put64(fill.match_number, ref(2));
+
+        auto& trade = append<TradeMessage>('P');
+        put64(trade.order_ref_number, 0);
+        trade.buy_sell_indicator = 'B';
+        put32(trade.shares, SHARES);
+        std::memset(trade.stock, ' ', sizeof(trade.stock));
+        put32(trade.price, wire_price(bid));
+        put64(trade.match_number, ref(9));
+
+        static constexpr std::size_t OPEN_AT_END[] = {0, 1, 3, 4, 6, 7, 8};
+        for (const std::size_t k : OPEN_AT_END) {
+            auto& del = append<OrderDeleteMessage>('D');
+            put64(del.order_ref_number, ref(k));
+        }
+        return size_;
+    }
+
+    const char* data() const noexcept { return buf_.data(); }
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    std::array<char, MAX_BYTES> buf_{};
+    std::size_t size_ = 0;
+    StockLocate locate_ = 0;
+
+    OrderId ref(std::size_t k) const noexcept {
+        return WARMUP_ORDER_REF_BASE | (OrderId{locate_} << 8) | k;
+    }
+
+    static std::uint32_t wire_price(Price price) noexcept {
+        return static_cast<std::uint32_t>(std::max<Price>(price, TICK));
+    }
+
+    static void put16(std::uint16_t& field, std::uint16_t value) noexcept {
+        field = endian::be16_to_host(value);
+    }
+    static void put32(std::uint32_t& field, std::uint32_t value) noexcept {
+        field = endian::be32_to_host(value);
+    }
+    static void put64(std::uint64_t& field, std::uint64_t value) noexcept {
+        field = endian::be64_to_host(value);
+    }
+
+    /// Zeroed message of type M at the end of the buffer (timestamp 0)
+    template<typename M>
+    M& append(char type) noexcept {
+        static_assert(sizeof(M) <= MAX_BYTES, "message larger than the batch buffer");
+        M* msg = reinterpret_cast<M*>(buf_.data() + size_);
+        std::memset(static_cast<void*>(msg), 0, sizeof(M));
+        msg->message_type = type;
+        put16(msg->stock_locate, locate_);
+        size_ += sizeof(M);
+        return *msg;
+    }
+
+    void add(OrderId id, char side, Price price, bool mpid) noexcept {
+        if (mpid) {
+            auto& msg = append<AddOrderMPIDMessage>('F');
+            fill_add(msg, id, side, price);
+            std::memcpy(msg.attribution, "WARM", sizeof(msg.attribution));
+        } else {
+            fill_add(append<AddOrderMessage>('A'), id, side, price);
+        }
+    }
+
+    template<typename M>
+    static void fill_add(M& msg, OrderId id, char side, Price price) noexcept {
+        put64(msg.order_ref_number, id);
+        msg.buy_sell_indicator = side;
+        put32(msg.shares, SHARES);
+        std::memset(msg.stock, ' ', sizeof(msg.stock));
+        put32(msg.price, wire_price(price));
+    }
+};
+
+} // namespace itch
@@ -0,0 +1,115 @@
+/**
+ * @file bench_background_checkpoint.cpp
+ * @brief Feed-thread latency impact of fork-based background checkpoints
+ *
+ * Replays the same workload twice, timing every message: once without
+ * checkpoints and once with BackgroundCheckpointer::poll() called after each
+ * message. Reports per-message latency percentiles, the fork() stall and the
+ * child's checkpoint write bandwidth.
+ *
+ * Usage: bench_background_checkpoint [messages] [interval_ms] [symbols]
+ */
+
+#include "bench_common.hpp"
+#include "../include/checkpoint.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+struct LatencyStats {
+    double p50, p99, p999, p9999, max;
+    std::size_t over_10us;
+};
+
+LatencyStats summarize(std::vector<std::uint64_t>& cycles, double cycles_per_ns) {
+    std::sort(cycles.begin(), cycles.end());
+    auto at = [&](double p) {
+        const std::size_t idx = std::min(cycles.size() - 1,
+            static_cast<std::size_t>(p * static_cast<double>(cycles.size())));
+        return static_cast<double>(cycles[idx]) / cycles_per_ns;
+    };
+    const auto threshold = static_cast<std::uint64_t>(10000.0 * cycles_per_ns);
+    const std::size_t over = static_cast<std::size_t>(
+        cycles.end() - std::upper_bound(cycles.begin(), cycles.end(), threshold));
+    return {at(0.50), at(0.99), at(0.999), at(0.9999),
+            static_cast<double>(cycles.back()) / cycles_per_ns, over};
+}
+
+void print_row(const char* name, const LatencyStats& s) {
+    std::cout << std::left << std::setw(18) << name << std::right << std::fixed
+              << std::setprecision(0)
+              << std::setw(9) << s.p50 << std::setw(9) << s.p99 << std::setw(10) << s.p999
+              << std::setw(11) << s.p9999 << std::setw(12) << s.max
+              << std::setw(10) << s.over_10us << "\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 3000000;
+    const long interval_ms = argc > 2 ? std::strtol(argv[2], nullptr, 10) : 500;
+    const std::size_t num_symbols = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 500;
+
+    bench::print_header("Background Checkpoint Benchmark");
+
+    const double cycles_per_ns = itch::timing::calibrate_tsc();
+    bench::WorkloadGenerator gen(42, num_symbols, 1000);
+    const auto directory = gen.directory();
+    const auto workload = gen.generate(num_messages);
+
+    std::vector<std::uint64_t> cycles(workload.message_count());
+    LatencyStats results[2];
+    itch::BackgroundCheckpointer::Stats ckpt_stats;
+    std::vector<std::string> written;
+
+    for (int with_checkpoints = 0; with_checkpoints < 2; ++with_checkpoints) {
+        itch::FeedHandler handler;
+        handler.process(directory.data.data(), directory.data.size());
+        itch::BackgroundCheckpointer checkpointer("bench_background",
+                                                  std::chrono::milliseconds(interval_ms));
+
+        for (std::size_t i = 0; i < workload.message_count(); ++i) {
+            const std::uint64_t t0 = itch::timing::rdtsc();
+            handler.process(workload.message(i), workload.message_size(i));
+            if (with_checkpoints && checkpointer.poll(handler)) {
+                written.push_back(checkpointer.last_path());
+            }
+            cycles[i] = itch::timing::rdtscp() - t0;
+        }
+        checkpointer.wait();
+        results[with_checkpoints] = summarize(cycles, cycles_per_ns);
+
+        if (with_checkpoints) {
+            ckpt_stats = checkpointer.stats();
+        }
+    }
+    for (const auto& path : written) {
+        std::remove(path.c_str());
+    }
+
+    std::cout << "Messages: " << workload.message_count() << ", symbols: " << num_symbols
+              << ", interval: " << interval_ms << " ms\n\n";
+    std::cout << "Per-message latency (ns)\n";
+    std::cout << std::left << std::setw(18) << "" << std::right << std::setw(9) << "p50"
+              << std::setw(9) << "p99" << std::setw(10) << "p99.9" << std::setw(11) << "p99.99"
+              << std::setw(12) << "max" << std::setw(10) << ">10us" << "\n";
+    print_row("No checkpoints", results[0]);
+    print_row("Background", results[1]);
+
+    std::cout << "\nCheckpoints: " << ckpt_stats.started << " started, "
+              << ckpt_stats.completed << " completed, " << ckpt_stats.skipped << " skipped, "
+              << ckpt_stats.failed << " failed\n";
+    std::cout << std::fixed << std::setprecision(1)
+              << "fork() stall: last " << (static_cast<double>(ckpt_stats.last_fork_ns) / 1e3)
+              << " us, max " << (static_cast<double>(ckpt_stats.max_fork_ns) / 1e3) << " us\n";
+    if (ckpt_stats.last_duration_ns > 0) {
+        std::cout << "Last checkpoint: " << (static_cast<double>(ckpt_stats.last_bytes) / 1e6)
+                  << " MB in " << (static_cast<double>(ckpt_stats.last_duration_ns) / 1e6)
+                  << " ms (" << (static_cast<double>(ckpt_stats.last_bytes) /
+                                 (static_cast<double>(ckpt_stats.last_duration_ns) / 1e9) / 1e6)
+                  << " MB/s)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file bench_bar_engine.cpp
+ * @brief Cost of inline OHLCV / VWAP bars per trade
+ *
+ * Two measurements:
+ *   - BarEngine::on_trade() alone over a pre-built trade stream, for 1, 2
+ *     and 4 intervals (the per-trade budget is a few nanoseconds)
+ *   - an execution-heavy ITCH replay with and without enable_bars(), to show
+ *     the end-to-end overhead on the feed thread
+ *
+ * Usage: bench_bar_engine [trades] [symbols] [runs]
+ */
+
+#include "bench_common.hpp"
+#include "../include/bar_engine.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+struct TradeInput {
+    itch::Timestamp ts;
+    itch::Price price;
+    itch::Quantity shares;
+    itch::StockLocate locate;
+};
+
+std::vector<TradeInput> make_trades(std::size_t count, std::size_t symbols) {
+    std::mt19937_64 rng(42);
+    std::vector<TradeInput> trades(count);
+    itch::Timestamp ts = 34200000000000ULL;     // 09:30
+    for (auto& t : trades) {
+        ts += rng() % 20000;                     // ~10us between prints
+        t.ts = ts;
+        t.locate = static_cast<itch::StockLocate>(1 + rng() % symbols);
+        t.price = 1500000 + static_cast<itch::Price>(rng() % 2000);
+        t.shares = 100 * static_cast<itch::Quantity>(1 + rng() % 10);
+    }
+    return trades;
+}
+
+template<typename F>
+double best_of(std::size_t runs, F&& fn) {
+    double best = 1e30;
+    for (std::size_t i = 0; i < runs; ++i) best = std::min(best, bench::time_ns(fn));
+    return best;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_trades = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const std::size_t num_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500;
+    const std::size_t runs = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 3;
+
+    bench::print_header("Trade Bar Engine Benchmark");
+
+    const auto trades = make_trades(num_trades, num_symbols);
+    const double trade_count = static_cast<double>(num_trades);
+    const std::vector<std::uint64_t> all_intervals = {
+        1000000000ULL, 5000000000ULL, 60000000000ULL, 300000000000ULL};   // 1s, 5s, 1m, 5m
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Trades: " << num_trades << " across " << num_symbols << " symbols\n\n"
+              << std::left << std::setw(24) << "Engine only" << std::right << std::setw(12)
+              << "ns/trade" << std::setw(14) << "M trades/s\n";
+    for (std::size_t n : {1, 2, 4}) {
+        const std::vector<std::uint64_t> intervals(all_intervals.begin(), all_intervals.begin() + n);
+        auto engine = std::make_unique<itch::BarEngine>(intervals);
+        std::uint64_t match = 0;
+        const double ns = best_of(runs, [&] {
+            engine->clear();
+            for (const auto& t : trades) {
+                engine->on_trade(t.locate, t.price, t.shares, ++match, t.ts);
+            }
+        });
+        const std::string label = std::to_string(n) + (n == 1 ? " interval" : " intervals");
+        std::cout << std::left << std::setw(24) << label << std::right << std::setw(12)
+                  << (ns / trade_count) << std::setw(13) << (trade_count / ns * 1e3) << "\n";
+    }
+
+    // End-to-end: execution-heavy feed, bars off vs. on (one handler alive at a time)
+    bench::WorkloadGenerator gen(42, num_symbols, 200);
+    bench::WorkloadMix mix;
+    mix.add = 40;
+    mix.execute = 30;
+    mix.cancel = 5;
+    mix.remove = 20;
+    mix.replace = 5;
+    gen.set_mix(mix);
+    const auto directory = gen.directory();
+    const auto workload = gen.generate(num_trades / 2);
+
+    auto replay = [&](bool bars) {
+        double best = 1e30;
+        for (std::size_t run = 0; run < runs; ++run) {
+            auto handler = std::make_unique<itch::FeedHandler>();
+            if (bars) handler->enable_bars(all_intervals);
+            handler->process(directory.data.data(), directory.data.size());
+            best = std::min(best, bench::time_ns([&] {
+                handler->process(workload.data.data(), workload.data.size());
+            }));
+        }
+        return best;
+    };
+    const double off_ns = replay(false);
+    const double on_ns = replay(true);
+    const double msgs = static_cast<double>(workload.message_count());
+    const double execs = msgs * mix.execute / 100.0;
+
+    std::cout << "\nFeed replay (" << workload.message_count() << " msgs, ~"
+              << static_cast<std::uint64_t>(execs) << " executions)\n"
+              << "  bars off:  " << (off_ns / msgs) << " ns/msg\n"
+              << "  bars on:   " << (on_ns / msgs) << " ns/msg (4 intervals)\n"
+              << "  overhead:  " << ((on_ns - off_ns) / execs) << " ns/execution\n";
+    return 0;
+}
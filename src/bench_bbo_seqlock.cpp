@@ -0,0 +1,129 @@
+/**
+ * @file bench_bbo_seqlock.cpp
+ * @brief Seqlock BBO contention: 1 feed writer vs. 1..16 reader threads
+ *
+ * The writer replays a mixed workload concentrated on a few hot symbols with
+ * BBO publishing enabled; readers spin on read() over the same symbols for as
+ * long as the writer runs. Reports writer cost per message and reader
+ * latency / retry rate per reader count.
+ *
+ * Usage: bench_bbo_seqlock [messages] [hot_symbols] [max_readers]
+ */
+
+#include "bench_common.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+struct ReaderStats {
+    std::uint64_t reads = 0;
+    std::uint64_t retries = 0;
+    std::uint64_t cycles = 0;
+    std::uint64_t checksum = 0;
+};
+
+struct RunResult {
+    double writer_ns_per_msg = 0.0;
+    ReaderStats readers;
+};
+
+RunResult run(std::size_t num_readers, std::size_t hot_symbols,
+              const bench::Workload& directory, const bench::Workload& workload) {
+    itch::FeedHandler handler;
+    handler.process(directory.data.data(), directory.data.size());
+    handler.enable_bbo_publishing();
+    const itch::BBOPublisher* publisher = handler.bbo_publisher();
+
+    std::atomic<bool> start{false};
+    std::atomic<bool> done{false};
+    std::vector<ReaderStats> stats(num_readers);
+    std::vector<std::thread> readers;
+
+    for (std::size_t r = 0; r < num_readers; ++r) {
+        readers.emplace_back([&, r] {
+            ReaderStats local;
+            itch::StockLocate locate = static_cast<itch::StockLocate>(1 + r % hot_symbols);
+            while (!start.load(std::memory_order_acquire)) itch::cpu_relax();
+
+            while (!done.load(std::memory_order_relaxed)) {
+                // Batch reads so rdtsc overhead stays out of the per-read figure
+                const std::uint64_t t0 = itch::timing::rdtsc();
+                for (int i = 0; i < 64; ++i) {
+                    itch::BBOSnapshot snap;
+                    while (!publisher->try_read(locate, snap)) {
+                        ++local.retries;
+                        itch::cpu_relax();
+                    }
+                    local.checksum += static_cast<std::uint64_t>(snap.bbo.bid_price);
+                    locate = static_cast<itch::StockLocate>(1 + (locate % hot_symbols));
+                }
+                local.cycles += itch::timing::rdtscp() - t0;
+                local.reads += 64;
+            }
+            stats[r] = local;
+        });
+    }
+
+    start.store(true, std::memory_order_release);
+    const double elapsed = bench::time_ns([&] {
+        for (std::size_t i = 0; i < workload.message_count(); ++i) {
+            handler.process(workload.message(i), workload.message_size(i));
+        }
+    });
+    done.store(true);
+    for (auto& t : readers) t.join();
+
+    RunResult result;
+    result.writer_ns_per_msg = elapsed / static_cast<double>(workload.message_count());
+    for (const auto& s : stats) {
+        result.readers.reads += s.reads;
+        result.readers.retries += s.retries;
+        result.readers.cycles += s.cycles;
+        result.readers.checksum += s.checksum;
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const std::size_t hot_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+    const std::size_t max_readers = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 16;
+
+    bench::print_header("Seqlock BBO Contention Benchmark");
+
+    const double cycles_per_ns = itch::timing::calibrate_tsc();
+    bench::WorkloadGenerator gen(42, hot_symbols, 500);
+    const auto directory = gen.directory();
+    const auto workload = gen.generate(num_messages);
+
+    std::cout << "Messages: " << workload.message_count() << ", hot symbols: " << hot_symbols
+              << ", hardware threads: " << std::thread::hardware_concurrency() << "\n\n";
+    std::cout << std::left << std::setw(10) << "Readers" << std::setw(16) << "Writer ns/msg"
+              << std::setw(16) << "Read ns" << std::setw(16) << "Reads/s (M)"
+              << "Retry %\n";
+
+    for (std::size_t readers = 0; readers <= max_readers; readers = readers ? readers * 2 : 1) {
+        const RunResult r = run(readers, hot_symbols, directory, workload);
+        const double read_ns = r.readers.reads
+            ? static_cast<double>(r.readers.cycles) / cycles_per_ns / static_cast<double>(r.readers.reads)
+            : 0.0;
+        const double total_s = r.writer_ns_per_msg * static_cast<double>(workload.message_count()) / 1e9;
+        const double retry_pct = r.readers.reads
+            ? 100.0 * static_cast<double>(r.readers.retries) / static_cast<double>(r.readers.reads)
+            : 0.0;
+
+        std::cout << std::left << std::fixed << std::setw(10) << readers
+                  << std::setprecision(1) << std::setw(16) << r.writer_ns_per_msg
+                  << std::setw(16) << read_ns
+                  << std::setprecision(2) << std::setw(16)
+                  << (static_cast<double>(r.readers.reads) / total_s / 1e6)
+                  << std::setprecision(3) << retry_pct << "\n";
+    }
+
+    return 0;
+}
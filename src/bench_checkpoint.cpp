@@ -0,0 +1,101 @@
+/**
+ * @file bench_checkpoint.cpp
+ * @brief Checkpoint save / restore time vs. full replay
+ *
+ * Builds a large book set by replaying a synthetic day from a file, saves a
+ * checkpoint part-way through, restores it into a fresh handler, resumes the
+ * file from the recorded offset and verifies both handlers end identical.
+ *
+ * Usage: bench_checkpoint [messages] [symbols] [live_orders_per_symbol]
+ */
+
+#include "bench_common.hpp"
+#include "../include/checkpoint.hpp"
+
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+bool books_equal(const itch::FeedHandler& a, const itch::FeedHandler& b) {
+    bool equal = a.book_manager().total_order_count() == b.book_manager().total_order_count();
+    a.book_manager().for_each_book([&](const itch::OrderBook& book) {
+        const itch::OrderBook& other =
+            const_cast<itch::FeedHandler&>(b).book_manager().get_book(book.stock_locate());
+        equal = equal && book.order_count() == other.order_count() &&
+                book.bbo().bid_price == other.bbo().bid_price &&
+                book.bbo().bid_quantity == other.bbo().bid_quantity &&
+                book.bbo().ask_price == other.bbo().ask_price &&
+                book.bbo().ask_quantity == other.bbo().ask_quantity;
+    });
+    return equal;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const std::size_t num_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    const std::size_t live_per_symbol = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000;
+    const char* day_path = "bench_checkpoint_day.itch";
+    const char* ckpt_path = "bench_checkpoint.ckpt";
+
+    bench::print_header("Checkpoint / Restore Benchmark");
+
+    // Write a synthetic day to disk so resume-by-offset is exercised for real
+    bench::WorkloadGenerator gen(42, num_symbols, live_per_symbol);
+    bench::WorkloadMix mix;
+    mix.add = 55; mix.execute = 5; mix.cancel = 5; mix.remove = 25; mix.replace = 10;
+    gen.set_mix(mix);
+    const auto directory = gen.directory();
+    const auto workload = gen.generate(num_messages);
+    {
+        std::ofstream out(day_path, std::ios::binary);
+        out.write(directory.data.data(), static_cast<std::streamsize>(directory.data.size()));
+        out.write(workload.data.data(), static_cast<std::streamsize>(workload.data.size()));
+    }
+    const std::size_t split = directory.data.size() +
+        workload.offsets[workload.message_count() * 3 / 4];
+
+    // Replay the first three quarters, as if the process died mid-session
+    itch::FeedHandler live;
+    itch::MemoryMappedFile day;
+    day.open(day_path);
+    const double replay_ns = bench::time_ns([&] { live.process(day.data(), split); });
+
+    itch::CheckpointInfo saved;
+    const double save_ns = bench::time_ns([&] {
+        itch::save_checkpoint(live, ckpt_path, &saved);
+    });
+
+    itch::FeedHandler restored;
+    itch::CheckpointInfo loaded;
+    bool ok = false;
+    const double load_ns = bench::time_ns([&] {
+        ok = itch::load_checkpoint(restored, ckpt_path, &loaded);
+    });
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Live orders:        " << saved.order_count << " in " << saved.book_count
+              << " books (" << saved.symbol_count << " symbols)\n";
+    std::cout << "Checkpoint size:    " << (static_cast<double>(saved.file_bytes) / 1e6) << " MB\n";
+    std::cout << "Replay to split:    " << (replay_ns / 1e6) << " ms ("
+              << saved.position.sequence << " messages)\n";
+    std::cout << "Save checkpoint:    " << (save_ns / 1e6) << " ms ("
+              << (static_cast<double>(saved.file_bytes) / (save_ns / 1e9) / 1e6) << " MB/s)\n";
+    std::cout << "Restore checkpoint: " << (load_ns / 1e6) << " ms ("
+              << (static_cast<double>(loaded.order_count) / (load_ns / 1e9) / 1e6)
+              << " M orders/s)\n";
+
+    // Resume both from the same point and compare
+    live.process(day.data() + split, day.size() - split);
+    restored.process_file(day_path, restored.position().offset);
+    const bool equal = ok && books_equal(live, restored) && books_equal(restored, live) &&
+                       live.position().offset == restored.position().offset;
+    std::cout << "Resume from offset " << loaded.position.offset << ": "
+              << (equal ? "books identical" : "MISMATCH") << "\n";
+
+    std::remove(day_path);
+    std::remove(ckpt_path);
+    return equal ? 0 : 1;
+}
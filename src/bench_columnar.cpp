@@ -0,0 +1,142 @@
+/**
+ * @file bench_columnar.cpp
+ * @brief Columnar scans vs. re-parsing the raw ITCH file
+ *
+ * Writes a synthetic day, exports it to per-type columns once, then answers
+ * the same research queries both ways:
+ *   - executed shares for one symbol          (E.locate, E.shares)
+ *   - added notional for one symbol           (A.locate, A.price, A.shares)
+ *   - executed shares across the whole day    (E.shares)
+ * The re-parse path walks every message of the raw file and decodes the
+ * fields it needs, i.e. the fastest the row format allows.
+ *
+ * Usage: bench_columnar [messages] [symbols] [runs]
+ */
+
+#include "bench_common.hpp"
+#include "../include/columnar_export.hpp"
+
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+struct RawAnswers {
+    std::uint64_t symbol_executed = 0;
+    std::uint64_t symbol_notional = 0;
+    std::uint64_t day_executed = 0;
+};
+
+RawAnswers scan_raw(const char* data, std::size_t len, itch::StockLocate locate) {
+    RawAnswers r;
+    for (std::size_t offset = 0; offset < len; offset += itch::get_message_size(data[offset])) {
+        const char* msg = data + offset;
+        if (msg[0] == 'E') {
+            const auto& m = *reinterpret_cast<const itch::OrderExecutedMessage*>(msg);
+            const std::uint32_t shares = itch::endian::be32_to_host(m.executed_shares);
+            r.day_executed += shares;
+            if (itch::endian::be16_to_host(m.stock_locate) == locate) r.symbol_executed += shares;
+        } else if (msg[0] == 'A') {
+            const auto& m = *reinterpret_cast<const itch::AddOrderMessage*>(msg);
+            if (itch::endian::be16_to_host(m.stock_locate) == locate) {
+                r.symbol_notional += static_cast<std::uint64_t>(itch::endian::be32_to_host(m.price)) *
+                                     itch::endian::be32_to_host(m.shares);
+            }
+        }
+    }
+    return r;
+}
+
+template<typename F>
+double best_of(std::size_t runs, F&& fn) {
+    double best = 1e30;
+    for (std::size_t i = 0; i < runs; ++i) best = std::min(best, bench::time_ns(fn));
+    return best;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const std::size_t num_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500;
+    const std::size_t runs = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 5;
+    const char* day_path = "bench_columnar_day.itch";
+    const char* dir = "bench_columnar_day.cols";
+    const itch::StockLocate locate = 7;
+
+    bench::print_header("Columnar Export Benchmark");
+
+    {
+        bench::WorkloadGenerator gen(42, num_symbols, 500);
+        const auto directory = gen.directory();
+        const auto workload = gen.generate(num_messages);
+        std::ofstream out(day_path, std::ios::binary);
+        out.write(directory.data.data(), static_cast<std::streamsize>(directory.data.size()));
+        out.write(workload.data.data(), static_cast<std::streamsize>(workload.data.size()));
+    }
+
+    itch::ColumnarExportInfo info;
+    const double export_ns = bench::time_ns([&] { itch::export_columnar_file(day_path, dir, &info); });
+
+    itch::MemoryMappedFile raw;
+    itch::ColumnarDay cols;
+    if (!raw.open(day_path) || !cols.open(dir)) {
+        std::cerr << "Failed to open day or columns\n";
+        return 1;
+    }
+
+    RawAnswers expected;
+    const double raw_ns = best_of(runs, [&] { expected = scan_raw(raw.data(), raw.size(), locate); });
+
+    RawAnswers got;
+    const std::size_t e_rows = cols.rows('E');
+    const std::size_t a_rows = cols.rows('A');
+    const double q1_ns = best_of(runs, [&] {
+        got.symbol_executed = itch::columnar::sum_where_equal(cols.shares('E'), cols.locates('E'),
+                                                              e_rows, locate);
+    });
+    const double q2_ns = best_of(runs, [&] {
+        got.symbol_notional = itch::columnar::dot_where_equal(cols.prices('A'), cols.shares('A'),
+                                                              cols.locates('A'), a_rows, locate);
+    });
+    const double q3_ns = best_of(runs, [&] {
+        got.day_executed = itch::columnar::sum(cols.shares('E'), e_rows);
+    });
+
+    const bool match = got.symbol_executed == expected.symbol_executed &&
+                       got.symbol_notional == expected.symbol_notional &&
+                       got.day_executed == expected.day_executed;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Raw file:  " << (static_cast<double>(info.source_bytes) / 1e6) << " MB, "
+              << info.messages << " messages\n"
+              << "Columns:   " << (static_cast<double>(info.file_bytes) / 1e6) << " MB, export "
+              << (export_ns / 1e6) << " ms (one-off)\n"
+#if defined(ITCH_COLUMNAR_AVX2)
+              << "Kernels:   AVX2\n\n";
+#else
+              << "Kernels:   scalar\n\n";
+#endif
+
+    const double e_bytes = static_cast<double>(e_rows) * 6;     // locate + shares
+    const double a_bytes = static_cast<double>(a_rows) * 10;    // locate + price + shares
+    std::cout << std::left << std::setw(34) << "Query" << std::right << std::setw(12) << "ms"
+              << std::setw(12) << "MB read" << std::setw(12) << "vs raw\n";
+    std::cout << std::left << std::setw(34) << "re-parse raw (all three queries)" << std::right
+              << std::setw(12) << (raw_ns / 1e6) << std::setw(12)
+              << (static_cast<double>(raw.size()) / 1e6) << std::setw(11) << 1.0 << "x\n";
+    auto row = [&](const char* name, double ns, double bytes) {
+        std::cout << std::left << std::setw(34) << name << std::right << std::setw(12)
+                  << (ns / 1e6) << std::setw(12) << (bytes / 1e6) << std::setw(11)
+                  << (raw_ns / ns) << "x\n";
+    };
+    row("symbol executed shares", q1_ns, e_bytes);
+    row("symbol added notional", q2_ns, a_bytes);
+    row("day executed shares", q3_ns, static_cast<double>(e_rows) * 4);
+    row("all three (columnar)", q1_ns + q2_ns + q3_ns, e_bytes + a_bytes);
+    std::cout << "\nResults " << (match ? "match" : "MISMATCH") << " the raw scan\n";
+
+    std::remove(day_path);
+    std::filesystem::remove_all(dir);
+    return match ? 0 : 1;
+}
@@ -0,0 +1,537 @@
+/**
+ * @file bench_common.hpp
+ * @brief Shared helpers for the benchmark executables
+ *
+ * Provides:
+ * - Big-endian message field writers
+ * - A deterministic mixed-workload generator (add/execute/cancel/delete/replace)
+ *   that only references live orders, so every message hits the book, plus
+ *   auction rounds (NOII, cross trades) for opening/closing scenarios
+ * - Small console formatting and timing helpers (incl. latency percentiles)
+ * - Microbenchmark support: optimizer barriers and outlier-resistant
+ *   statistics over TSC-timed batches
+ * - Resident set size (/proc/self/status)
+ * - Hardware cache-miss / instruction counters (perf_event_open, Linux)
+ */
+
+#pragma once
+
+#include "../include/feed_handler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+// =============================================================================
+// Field Writers
+// =============================================================================
+
+inline void set_be16(std::uint16_t& field, std::uint16_t value) {
+    field = itch::endian::be16_to_host(value);
+}
+
+inline void set_be32(std::uint32_t& field, std::uint32_t value) {
+    field = itch::endian::be32_to_host(value);
+}
+
+inline void set_be64(std::uint64_t& field, std::uint64_t value) {
+    field = itch::endian::be64_to_host(value);
+}
+
+inline void set_timestamp(std::uint8_t* ts, itch::Timestamp value) {
+    ts[0] = static_cast<std::uint8_t>((value >> 40) & 0xFF);
+    ts[1] = static_cast<std::uint8_t>((value >> 32) & 0xFF);
+    ts[2] = static_cast<std::uint8_t>((value >> 24) & 0xFF);
+    ts[3] = static_cast<std::uint8_t>((value >> 16) & 0xFF);
+    ts[4] = static_cast<std::uint8_t>((value >> 8) & 0xFF);
+    ts[5] = static_cast<std::uint8_t>(value & 0xFF);
+}
+
+// =============================================================================
+// Mixed Workload Generator
+// =============================================================================
+
+/**
+ * @brief Relative message weights for the mixed workload
+ */
+struct WorkloadMix {
+    std::uint32_t add = 40;
+    std::uint32_t execute = 10;
+    std::uint32_t cancel = 10;
+    std::uint32_t remove = 30;  // OrderDelete
+    std::uint32_t replace = 10;
+};
+
+/**
+ * @brief Raw ITCH stream plus the offset of every message
+ */
+struct Workload {
+    std::vector<char> data;
+    std::vector<std::uint32_t> offsets;
+
+    std::size_t message_count() const noexcept { return offsets.size(); }
+
+    const char* message(std::size_t i) const noexcept { return data.data() + offsets[i]; }
+
+    std::size_t message_size(std::size_t i) const noexcept {
+        return itch::get_message_size(data[offsets[i]]);
+    }
+
+    /// Append another stream (e.g. the next phase of a scenario)
+    void append(const Workload& other) {
+        const auto base = static_cast<std::uint32_t>(data.size());
+        data.insert(data.end(), other.data.begin(), other.data.end());
+        for (const std::uint32_t off : other.offsets) offsets.push_back(base + off);
+    }
+};
+
+/**
+ * @brief Generates a deterministic stream of book-affecting messages
+ *
+ * Prices random-walk around a per-symbol reference so books develop realistic
+ * depth near the touch. The live-order population is held near `target_live`
+ * per symbol so long runs reach a steady state instead of growing forever.
+ */
+class WorkloadGenerator {
+public:
+    explicit WorkloadGenerator(std::uint64_t seed = 42, std::size_t num_symbols = 100,
+                               std::size_t target_live_per_symbol = 1000)
+        : rng_(seed), num_symbols_(num_symbols),
+          target_live_(target_live_per_symbol * num_symbols),
+          ref_prices_(num_symbols + 1, 1500000) {}
+
+    void set_mix(const WorkloadMix& mix) noexcept { mix_ = mix; }
+
+    /// Price levels per side that new orders spread over behind the touch
+    void set_price_band(std::size_t levels) noexcept { price_band_ = levels ? levels : 1; }
+
+    /**
+     * @brief Stock directory messages for locates 1..num_symbols
+     */
+    Workload directory() {
+        Workload w;
+        for (std::size_t i = 1; i <= num_symbols_; ++i) {
+            char* buf = append(w, sizeof(itch::StockDirectoryMessage));
+            auto* msg = reinterpret_cast<itch::StockDirectoryMessage*>(buf);
+            std::memset(buf, ' ', sizeof(itch::StockDirectoryMessage));
+            msg->message_type = 'R';
+            set_be16(msg->stock_locate, static_cast<std::uint16_t>(i));
+            set_be16(msg->tracking_number, 0);
+            set_timestamp(msg->timestamp, timestamp_);
+            char symbol[9];
+            std::snprintf(symbol, sizeof(symbol), "SYM%05zu", i);
+            std::memcpy(msg->stock, symbol, 8);
+            msg->market_category = 'Q';
+            msg->financial_status = 'N';
+            set_be32(msg->round_lot_size, 100);
+            set_be32(msg->etp_leverage_factor, 0);
+        }
+        return w;
+    }
+
+    /**
+     * @brief Generate `count` messages following the configured mix
+     */
+    Workload generate(std::size_t count) {
+        Workload w;
+        w.data.reserve(count * 36);
+        w.offsets.reserve(count);
+
+        const std::uint32_t total = mix_.add + mix_.execute + mix_.cancel +
+                                    mix_.remove + mix_.replace;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint32_t roll = static_cast<std::uint32_t>(rng_() % total);
+            // Hold the population near target: grow when short, shrink when long
+            if (live_.empty() || live_.size() < target_live_ / 2) {
+                roll = 0;
+            } else if (live_.size() > target_live_ * 2 && roll < mix_.add && total > mix_.add) {
+                roll = mix_.add;
+            }
+
+            if (roll < mix_.add) {
+                add_order(w);
+            } else if ((roll -= mix_.add) < mix_.execute) {
+                reduce_order(w, 'E');
+            } else if ((roll -= mix_.execute) < mix_.cancel) {
+                reduce_order(w, 'X');
+            } else if ((roll -= mix_.cancel) < mix_.remove) {
+                delete_order(w);
+            } else {
+                replace_order(w);
+            }
+        }
+        return w;
+    }
+
+    /**
+     * @brief One NOII per symbol, paired around each symbol's reference price
+     */
+    Workload imbalances(char cross_type = 'O') {
+        Workload w;
+        for (std::size_t i = 1; i <= num_symbols_; ++i) {
+            const auto locate = static_cast<itch::StockLocate>(i);
+            const auto ref = static_cast<std::uint32_t>(ref_prices_[locate]);
+            auto* msg = begin_message<itch::NOIIMessage>(w, 'I', locate);
+            set_be64(msg->paired_shares, 100 * (1 + rng_() % 500));
+            set_be64(msg->imbalance_shares, 100 * (rng_() % 50));
+            msg->imbalance_direction = "BSN"[rng_() % 3];
+            std::memset(msg->stock, ' ', 8);
+            set_be32(msg->far_price, ref);
+            set_be32(msg->near_price, ref);
+            set_be32(msg->current_ref_price, ref);
+            msg->cross_type = cross_type;
+            msg->price_variation_indicator = 'L';
+        }
+        return w;
+    }
+
+    /**
+     * @brief One cross trade per symbol at its reference price
+     */
+    Workload crosses(char cross_type = 'O') {
+        Workload w;
+        for (std::size_t i = 1; i <= num_symbols_; ++i) {
+            const auto locate = static_cast<itch::StockLocate>(i);
+            auto* msg = begin_message<itch::CrossTradeMessage>(w, 'Q', locate);
+            set_be64(msg->shares, 100 * (1 + rng_() % 5000));
+            std::memset(msg->stock, ' ', 8);
+            set_be32(msg->cross_price, static_cast<std::uint32_t>(ref_prices_[locate]));
+            set_be64(msg->match_number, next_match_++);
+            msg->cross_type = cross_type;
+        }
+        return w;
+    }
+
+    std::size_t live_orders() const noexcept { return live_.size(); }
+
+private:
+    struct LiveOrder {
+        itch::OrderId id;
+        itch::Price price;
+        itch::Quantity quantity;
+        itch::StockLocate locate;
+        bool buy;
+    };
+
+    std::mt19937_64 rng_;
+    std::size_t num_symbols_;
+    std::size_t target_live_;
+    std::vector<itch::Price> ref_prices_;
+    std::vector<LiveOrder> live_;
+    WorkloadMix mix_;
+    std::size_t price_band_ = 50;
+    itch::Timestamp timestamp_ = 34200000000000ULL; // 9:30 AM in nanoseconds
+    itch::OrderId next_order_id_ = 1;
+    std::uint64_t next_match_ = 1;
+
+    static char* append(Workload& w, std::size_t size) {
+        w.offsets.push_back(static_cast<std::uint32_t>(w.data.size()));
+        w.data.resize(w.data.size() + size);
+        return w.data.data() + w.offsets.back();
+    }
+
+    template<typename Msg>
+    Msg* begin_message(Workload& w, char type, itch::StockLocate locate) {
+        auto* msg = reinterpret_cast<Msg*>(append(w, sizeof(Msg)));
+        msg->message_type = type;
+        set_be16(msg->stock_locate, locate);
+        set_be16(msg->tracking_number, 0);
+        timestamp_ += 1 + rng_() % 2000;
+        set_timestamp(msg->timestamp, timestamp_);
+        return msg;
+    }
+
+    itch::Price next_price(itch::StockLocate locate, bool buy) {
+        itch::Price& ref = ref_prices_[locate];
+        ref += static_cast<itch::Price>(rng_() % 201) - 100;
+        if (ref < 10000) ref = 10000;
+        // Cluster around the touch in whole cents
+        const itch::Price offset = static_cast<itch::Price>(rng_() % price_band_) * 100;
+        return buy ? ref - 100 - offset : ref + 100 + offset;
+    }
+
+    void add_order(Workload& w) {
+        const auto locate = static_cast<itch::StockLocate>(1 + rng_() % num_symbols_);
+        const bool buy = (rng_() & 1) == 0;
+        const itch::Price price = next_price(locate, buy);
+        const auto qty = static_cast<itch::Quantity>(100 * (1 + rng_() % 20));
+        const itch::OrderId id = next_order_id_++;
+
+        auto* msg = begin_message<itch::AddOrderMessage>(w, 'A', locate);
+        set_be64(msg->order_ref_number, id);
+        msg->buy_sell_indicator = buy ? 'B' : 'S';
+        set_be32(msg->shares, qty);
+        std::memset(msg->stock, ' ', 8);
+        set_be32(msg->price, static_cast<std::uint32_t>(price));
+
+        live_.push_back({id, price, qty, locate, buy});
+    }
+
+    void reduce_order(Workload& w, char type) {
+        const std::size_t pick = rng_() % live_.size();
+        LiveOrder& o = live_[pick];
+        const auto qty = static_cast<itch::Quantity>(1 + rng_() % o.quantity);
+
+        if (type == 'E') {
+            auto* msg = begin_message<itch::OrderExecutedMessage>(w, 'E', o.locate);
+            set_be64(msg->order_ref_number, o.id);
+            set_be32(msg->executed_shares, qty);
+            set_be64(msg->match_number, next_match_++);
+        } else {
+            auto* msg = begin_message<itch::OrderCancelMessage>(w, 'X', o.locate);
+            set_be64(msg->order_ref_number, o.id);
+            set_be32(msg->cancelled_shares, qty);
+        }
+
+        o.quantity -= qty;
+        if (o.quantity == 0) {
+            remove_live(pick);
+        }
+    }
+
+    void delete_order(Workload& w) {
+        const std::size_t pick = rng_() % live_.size();
+        auto* msg = begin_message<itch::OrderDeleteMessage>(w, 'D', live_[pick].locate);
+        set_be64(msg->order_ref_number, live_[pick].id);
+        remove_live(pick);
+    }
+
+    void replace_order(Workload& w) {
+        const std::size_t pick = rng_() % live_.size();
+        LiveOrder& o = live_[pick];
+        const itch::OrderId new_id = next_order_id_++;
+        const itch::Price price = next_price(o.locate, o.buy);
+        const auto qty = static_cast<itch::Quantity>(100 * (1 + rng_() % 20));
+
+        auto* msg = begin_message<itch::OrderReplaceMessage>(w, 'U', o.locate);
+        set_be64(msg->original_order_ref_number, o.id);
+        set_be64(msg->new_order_ref_number, new_id);
+        set_be32(msg->shares, qty);
+        set_be32(msg->price, static_cast<std::uint32_t>(price));
+
+        o.id = new_id;
+        o.price = price;
+        o.quantity = qty;
+    }
+
+    void remove_live(std::size_t pick) {
+        live_[pick] = live_.back();
+        live_.pop_back();
+    }
+};
+
+// =============================================================================
+// Console Helpers
+// =============================================================================
+
+inline void print_header(const std::string& title) {
+    std::cout << std::string(70, '=') << "\n"
+              << " " << title << "\n"
+              << std::string(70, '=') << "\n";
+}
+
+template<typename F>
+double time_ns(F&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+/// p-th percentile (0..1) of per-operation latencies; sorts a copy
+inline std::uint64_t percentile(std::vector<std::uint64_t> samples, double p) {
+    if (samples.empty()) return 0;
+    const auto rank = std::min(samples.size() - 1,
+                               static_cast<std::size_t>(p * static_cast<double>(samples.size())));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(rank),
+                     samples.end());
+    return samples[rank];
+}
+
+// =============================================================================
+// Microbenchmark Support
+// =============================================================================
+
+/// Keep `value` (and the work producing it) alive without emitting a store
+template<typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/// Compiler-level memory fence: pending stores must happen, loads are redone
+inline void clobber_memory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+/// TSC ticks per nanosecond, calibrated once per process
+inline double tsc_per_ns() {
+    static const double rate = itch::timing::calibrate_tsc();
+    return rate;
+}
+
+/**
+ * @brief Outlier-resistant summary of repeated measurements
+ *
+ * `mad` is the median absolute deviation scaled by 1.4826 (a robust
+ * standard deviation); `outliers` counts samples above median + 3 * mad,
+ * typically interrupts, page faults or a migration mid-batch.
+ */
+struct RobustStats {
+    double median = 0;
+    double mad = 0;
+    double min = 0;
+    double p90 = 0;
+    std::size_t outliers = 0;
+};
+
+inline RobustStats robust_stats(std::vector<double> samples) {
+    RobustStats s;
+    if (samples.empty()) return s;
+    std::sort(samples.begin(), samples.end());
+    const std::size_t n = samples.size();
+    s.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    s.min = samples.front();
+    s.p90 = samples[std::min(n - 1, n * 9 / 10)];
+    std::vector<double> dev(n);
+    for (std::size_t i = 0; i < n; ++i) dev[i] = std::abs(samples[i] - s.median);
+    std::nth_element(dev.begin(), dev.begin() + static_cast<std::ptrdiff_t>(n / 2), dev.end());
+    s.mad = 1.4826 * dev[n / 2];
+    for (const double x : samples) {
+        if (x > s.median + 3 * s.mad) ++s.outliers;
+    }
+    return s;
+}
+
+/// Resident set size in KiB from /proc/self/status (0 where unavailable)
+inline std::size_t rss_kib() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return std::strtoull(line.c_str() + 6, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+// =============================================================================
+// Hardware Counters
+// =============================================================================
+
+/**
+ * @brief Cache-miss and instruction counters for the calling thread
+ *
+ * Uses perf_event_open on Linux. Counters the kernel or hypervisor does not
+ * expose (common in VMs and containers) report available() == false rather
+ * than failing the benchmark.
+ */
+class PerfCounters {
+public:
+    enum Event { CacheMisses, L1DReadMisses, Instructions, EVENT_COUNT };
+
+    PerfCounters() {
+#if defined(__linux__)
+        const std::uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        fds_[CacheMisses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds_[L1DReadMisses] = open_event(PERF_TYPE_HW_CACHE, l1d_read_miss);
+        fds_[Instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) ::close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available(Event e) const noexcept { return fds_[e] >= 0; }
+
+    bool any_available() const noexcept {
+        for (int fd : fds_) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    void start() noexcept {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() noexcept {
+#if defined(__linux__)
+        for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+            if (fds_[i] < 0) continue;
+            ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+            std::uint64_t value = 0;
+            values_[i] = ::read(fds_[i], &value, sizeof(value)) == sizeof(value) ? value : 0;
+        }
+#endif
+    }
+
+    std::uint64_t value(Event e) const noexcept { return values_[e]; }
+
+    static const char* name(Event e) noexcept {
+        static const char* const names[EVENT_COUNT] = {"cache-misses", "L1d-read-misses",
+                                                       "instructions"};
+        return names[e];
+    }
+
+private:
+    int fds_[EVENT_COUNT] = {-1, -1, -1};
+    std::uint64_t values_[EVENT_COUNT] = {};
+
+#if defined(__linux__)
+    static int open_event(std::uint32_t type, std::uint64_t config) noexcept {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+};
+
+} // namespace bench
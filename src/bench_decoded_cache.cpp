@@ -0,0 +1,85 @@
+/**
+ * @file bench_decoded_cache.cpp
+ * @brief Raw ITCH replay vs. pre-decoded fixed-stride cache replay
+ *
+ * Writes a synthetic day file, converts it once to the decoded cache and
+ * then replays both several times into fresh books, reporting the one-off
+ * conversion cost and the per-replay time of each path.
+ *
+ * Usage: bench_decoded_cache [messages] [symbols] [runs]
+ */
+
+#include "bench_common.hpp"
+#include "../include/decoded_cache.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    const std::size_t num_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500;
+    const std::size_t runs = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 3;
+    const char* day_path = "bench_decoded_day.itch";
+    const char* cache_path = "bench_decoded_day.cache";
+
+    bench::print_header("Decoded Cache Replay Benchmark");
+
+    {
+        bench::WorkloadGenerator gen(42, num_symbols, 500);
+        const auto directory = gen.directory();
+        const auto workload = gen.generate(num_messages);
+        std::ofstream out(day_path, std::ios::binary);
+        out.write(directory.data.data(), static_cast<std::streamsize>(directory.data.size()));
+        out.write(workload.data.data(), static_cast<std::streamsize>(workload.data.size()));
+    }
+
+    itch::DecodedCacheInfo info;
+    const double convert_ns = bench::time_ns([&] {
+        itch::write_decoded_cache_file(day_path, cache_path, &info);
+    });
+    itch::DecodedCache cache;
+    if (!cache.open(cache_path)) {
+        std::cerr << "Failed to open decoded cache\n";
+        return 1;
+    }
+
+    double raw_best = 1e30;
+    double cache_best = 1e30;
+    std::size_t raw_orders = 0;
+    std::size_t cache_orders = 0;
+    for (std::size_t run = 0; run < runs; ++run) {
+        {
+            auto handler = std::make_unique<itch::FeedHandler>();
+            raw_best = std::min(raw_best, bench::time_ns([&] { handler->process_file(day_path); }));
+            raw_orders = handler->book_manager().total_order_count();
+        }
+        {
+            auto books = std::make_unique<itch::OrderBookManager>();
+            cache_best = std::min(cache_best, bench::time_ns([&] { cache.replay(*books); }));
+            cache_orders = books->total_order_count();
+        }
+    }
+
+    const double msgs = static_cast<double>(info.book_messages + info.side_messages);
+    std::cout << std::fixed << std::setprecision(1)
+              << "Raw file:     " << (static_cast<double>(info.source_bytes) / 1e6) << " MB, "
+              << (info.book_messages + info.side_messages) << " messages\n"
+              << "Cache file:   " << (static_cast<double>(info.file_bytes) / 1e6) << " MB, "
+              << info.record_count << " records, " << info.side_messages << " side messages\n"
+              << "Conversion:   " << (convert_ns / 1e6) << " ms (one-off)\n\n";
+    std::cout << std::left << std::setw(14) << "Path" << std::right << std::setw(12) << "Best ms"
+              << std::setw(12) << "ns/msg" << std::setw(14) << "M msgs/s\n";
+    std::cout << std::left << std::setw(14) << "raw ITCH" << std::right << std::setw(12)
+              << (raw_best / 1e6) << std::setw(12) << (raw_best / msgs) << std::setw(13)
+              << (msgs / raw_best * 1e3) << "\n";
+    std::cout << std::left << std::setw(14) << "decoded" << std::right << std::setw(12)
+              << (cache_best / 1e6) << std::setw(12) << (cache_best / msgs) << std::setw(13)
+              << (msgs / cache_best * 1e3) << "\n";
+    std::cout << "\nSpeedup: " << std::setprecision(2) << (raw_best / cache_best) << "x, books "
+              << (raw_orders == cache_orders ? "identical" : "MISMATCH") << "\n";
+
+    std::remove(day_path);
+    std::remove(cache_path);
+    return raw_orders == cache_orders ? 0 : 1;
+}
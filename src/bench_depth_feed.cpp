@@ -0,0 +1,87 @@
+/**
+ * @file bench_depth_feed.cpp
+ * @brief Cost of the incremental depth delta feed vs. polling depth snapshots
+ *
+ * Replays the same mixed workload three ways:
+ * - Baseline: books only
+ * - Delta feed: top-N deltas maintained and drained after every message
+ * - Polling: bid_depth(N) / ask_depth(N) queried after every message
+ *
+ * Usage: bench_depth_feed [messages] [levels]
+ */
+
+#include "bench_common.hpp"
+
+#include <cstdlib>
+
+namespace {
+
+enum class Mode { Baseline, DeltaFeed, Polling };
+
+struct Result {
+    double ns_per_msg;
+    std::uint64_t outputs; // deltas or depth levels seen by the consumer
+};
+
+Result run(Mode mode, const bench::Workload& directory, const bench::Workload& workload,
+           std::size_t levels) {
+    itch::FeedHandler handler;
+    handler.process(directory.data.data(), directory.data.size());
+    if (mode == Mode::DeltaFeed) {
+        handler.enable_depth_feed(levels);
+    }
+
+    std::uint64_t outputs = 0;
+    const double elapsed = bench::time_ns([&] {
+        for (std::size_t i = 0; i < workload.message_count(); ++i) {
+            const char* msg = workload.message(i);
+            handler.process(msg, workload.message_size(i));
+
+            if (mode == Mode::DeltaFeed) {
+                auto& deltas = handler.depth_deltas();
+                for (const auto& d : deltas) {
+                    outputs += d.quantity;
+                }
+                deltas.clear();
+            } else if (mode == Mode::Polling) {
+                const auto locate = itch::endian::be16_to_host(
+                    *reinterpret_cast<const std::uint16_t*>(msg + 1));
+                const auto& book = handler.book_manager().get_book(locate);
+                for (const auto& l : book.bid_depth(levels)) outputs += l.quantity;
+                for (const auto& l : book.ask_depth(levels)) outputs += l.quantity;
+            }
+        }
+    });
+
+    return {elapsed / static_cast<double>(workload.message_count()), outputs};
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const std::size_t levels = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+
+    bench::print_header("Depth Delta Feed Benchmark");
+
+    bench::WorkloadGenerator gen(42, 100, 2000);
+    const auto directory = gen.directory();
+    const auto workload = gen.generate(num_messages);
+
+    std::cout << "Messages: " << workload.message_count()
+              << ", symbols: 100, depth levels: " << levels << "\n\n";
+
+    const Result baseline = run(Mode::Baseline, directory, workload, levels);
+    const Result feed = run(Mode::DeltaFeed, directory, workload, levels);
+    const Result polling = run(Mode::Polling, directory, workload, levels);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Baseline (books only):    " << baseline.ns_per_msg << " ns/msg\n";
+    std::cout << "Delta feed (top " << levels << "):     " << feed.ns_per_msg << " ns/msg"
+              << "  (+" << (feed.ns_per_msg - baseline.ns_per_msg) << " ns)\n";
+    std::cout << "Polling depth (top " << levels << "):  " << polling.ns_per_msg << " ns/msg"
+              << "  (+" << (polling.ns_per_msg - baseline.ns_per_msg) << " ns)\n";
+    std::cout << "Consumer checksum: " << feed.outputs << " / " << polling.outputs << "\n";
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file bench_depth_query.cpp
+ * @brief Top-N depth query latency: allocating vs. caller buffer vs. cached
+ *
+ * Builds books from the mixed workload, then queries bid and ask depth at
+ * 1, 5, 10 and 50 levels, cycling over every book:
+ * - vector:  bid_depth(N) returning a std::vector (heap allocation + map walk)
+ * - buffer:  bid_depth(out, N) into a caller array (map walk, no allocation)
+ * - cached:  same call with set_depth_cache(50) (memcpy of the flat top N)
+ * Finally replays the workload with the cache off / 10 / 50 levels to show
+ * what the incremental maintenance costs on the feed path.
+ *
+ * Usage: bench_depth_query [messages] [queries]
+ */
+
+#include "bench_common.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+constexpr std::size_t MAX_QUERY_LEVELS = 50;
+
+enum class Path { Vector, Buffer, Cached };
+
+double query_ns(const std::vector<const itch::OrderBook*>& books, Path path,
+                std::size_t levels, std::size_t queries, std::uint64_t& sink) {
+    itch::DepthLevel out[MAX_QUERY_LEVELS];
+    const double elapsed = bench::time_ns([&] {
+        for (std::size_t i = 0; i < queries; ++i) {
+            const itch::OrderBook& book = *books[i % books.size()];
+            if (path == Path::Vector) {
+                for (const auto& l : book.bid_depth(levels)) sink += l.quantity;
+                for (const auto& l : book.ask_depth(levels)) sink += l.quantity;
+            } else {
+                const std::size_t bids = book.bid_depth(out, levels);
+                sink += bids ? out[bids - 1].quantity : 0;
+                const std::size_t asks = book.ask_depth(out, levels);
+                sink += asks ? out[asks - 1].quantity : 0;
+            }
+        }
+    });
+    return elapsed / static_cast<double>(queries);
+}
+
+double replay_ns(const bench::Workload& directory, const bench::Workload& workload,
+                 std::size_t cache_levels) {
+    auto handler = std::make_unique<itch::FeedHandler>();
+    handler->process(directory.data.data(), directory.data.size());
+    if (cache_levels) handler->enable_depth_cache(cache_levels);
+    const double elapsed = bench::time_ns([&] {
+        handler->process(workload.data.data(), workload.data.size());
+    });
+    return elapsed / static_cast<double>(workload.message_count());
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const std::size_t queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+
+    bench::print_header("Depth Query Benchmark");
+
+    bench::WorkloadGenerator gen(42, 100, 2000);
+    const auto directory = gen.directory();
+    const auto workload = gen.generate(num_messages);
+
+    auto handler = std::make_unique<itch::FeedHandler>();
+    handler->process(directory.data.data(), directory.data.size());
+    handler->process(workload.data.data(), workload.data.size());
+
+    std::vector<const itch::OrderBook*> books;
+    std::size_t total_levels = 0;
+    handler->book_manager().for_each_book([&](const itch::OrderBook& book) {
+        books.push_back(&book);
+        total_levels += book.bid_level_count() + book.ask_level_count();
+    });
+    std::cout << "Books: " << books.size() << ", avg levels/side: "
+              << (total_levels / (2 * books.size())) << ", queries: " << queries
+              << " (bid + ask each)\n\n";
+
+    std::uint64_t sink = 0;
+    const std::size_t sizes[] = {1, 5, 10, MAX_QUERY_LEVELS};
+    double vector_ns[4], buffer_ns[4], cached_ns[4];
+    for (std::size_t i = 0; i < 4; ++i) {
+        vector_ns[i] = query_ns(books, Path::Vector, sizes[i], queries, sink);
+        buffer_ns[i] = query_ns(books, Path::Buffer, sizes[i], queries, sink);
+    }
+    handler->enable_depth_cache(MAX_QUERY_LEVELS);
+    for (std::size_t i = 0; i < 4; ++i) {
+        cached_ns[i] = query_ns(books, Path::Cached, sizes[i], queries, sink);
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::left << std::setw(10) << "Levels" << std::right << std::setw(14)
+              << "vector ns" << std::setw(14) << "buffer ns" << std::setw(14) << "cached ns"
+              << std::setw(12) << "speedup\n";
+    for (std::size_t i = 0; i < 4; ++i) {
+        std::cout << std::left << std::setw(10) << sizes[i] << std::right << std::setw(14)
+                  << vector_ns[i] << std::setw(14) << buffer_ns[i] << std::setw(14)
+                  << cached_ns[i] << std::setw(11) << (vector_ns[i] / cached_ns[i]) << "x\n";
+    }
+    handler.reset();
+
+    // Interleave configurations so heap / page-cache drift between runs hits all three
+    const std::size_t cache_sizes[] = {0, 10, MAX_QUERY_LEVELS};
+    double replay_best[3] = {1e30, 1e30, 1e30};
+    for (std::size_t run = 0; run < 3; ++run) {
+        for (std::size_t c = 0; c < 3; ++c) {
+            replay_best[c] = std::min(replay_best[c], replay_ns(directory, workload, cache_sizes[c]));
+        }
+    }
+    const double off = replay_best[0];
+    const double top10 = replay_best[1];
+    const double top50 = replay_best[2];
+    std::cout << "\nCache maintenance (feed replay)\n"
+              << "  cache off:  " << off << " ns/msg\n"
+              << "  top 10:     " << top10 << " ns/msg  (+" << (top10 - off) << " ns)\n"
+              << "  top 50:     " << top50 << " ns/msg  (+" << (top50 - off) << " ns)\n"
+              << "Checksum: " << sink << "\n";
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file bench_index_growth.cpp
+ * @brief Worst single add_order latency across order-index growth events
+ *
+ * Adds N orders with sequential ids to one book that starts at the default
+ * index capacity, timing every call, in three modes:
+ * - stop-the-world: the index is grown synchronously at the 50% threshold
+ *                   (reserve() right before the add that would cross it,
+ *                   which is the rehash put() used to do inline)
+ * - incremental:    put() as shipped: migrate MIGRATE_STEP buckets per call
+ * - presized:       reserve_orders(N) up front from the expected-peak hint
+ * The order pool is reserved for N in every mode so only index growth shows.
+ *
+ * Usage: bench_index_growth [orders]
+ */
+
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+enum class Mode { StopTheWorld, Incremental, Presized };
+
+std::vector<std::uint64_t> run(Mode mode, std::size_t count) {
+    itch::ObjectPool<itch::Order> pool;
+    pool.reserve(count);
+    auto book = std::make_unique<itch::OrderBook>(1);
+    if (mode == Mode::Presized) book->reserve_orders(count);
+
+    std::vector<std::uint64_t> latency(count);
+    std::mt19937_64 rng(5);
+    for (std::size_t i = 0; i < count; ++i) {
+        const bool buy = i % 2 == 0;
+        const itch::Price offset = static_cast<itch::Price>(rng() % 200) * 100;
+        const auto start = std::chrono::steady_clock::now();
+        if (mode == Mode::StopTheWorld) book->reserve_orders(book->order_count());
+        book->add_order(i + 1, buy ? itch::Side::Buy : itch::Side::Sell,
+                        buy ? 1000000 - offset : 1000100 + offset, 100, 0, pool);
+        const auto end = std::chrono::steady_clock::now();
+        latency[i] = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    return latency;
+}
+
+std::uint64_t window_max(const std::vector<std::uint64_t>& latency, std::size_t from, std::size_t to) {
+    return *std::max_element(latency.begin() + static_cast<std::ptrdiff_t>(from),
+                             latency.begin() + static_cast<std::ptrdiff_t>(std::min(to, latency.size())));
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    bench::print_header("Order Index Growth Benchmark");
+    std::cout << "Orders added: " << count << " (one book, default initial capacity)\n\n";
+
+    const auto stop = run(Mode::StopTheWorld, count);
+    const auto incremental = run(Mode::Incremental, count);
+    const auto presized = run(Mode::Presized, count);
+
+    std::cout << std::left << std::setw(16) << "Mode" << std::right << std::setw(10) << "p50 ns"
+              << std::setw(10) << "p99 ns" << std::setw(12) << "p99.99 ns" << std::setw(14)
+              << "max ns\n";
+    const std::pair<const char*, const std::vector<std::uint64_t>*> modes[] = {
+        {"stop-the-world", &stop}, {"incremental", &incremental}, {"presized", &presized}};
+    for (const auto& m : modes) {
+        std::cout << std::left << std::setw(16) << m.first << std::right << std::setw(10)
+                  << bench::percentile(*m.second, 0.5) << std::setw(10)
+                  << bench::percentile(*m.second, 0.99) << std::setw(12)
+                  << bench::percentile(*m.second, 0.9999) << std::setw(13)
+                  << window_max(*m.second, 0, count) << "\n";
+    }
+
+    // The default index holds 2^17 buckets and grows when half full, so the
+    // n-th growth happens at 2^(15+n) orders; each window holds exactly one
+    std::cout << "\nWorst add per growth window\n"
+              << std::left << std::setw(24) << "Orders" << std::right << std::setw(18)
+              << "stop-the-world ns" << std::setw(16) << "incremental ns\n";
+    for (std::size_t at = std::size_t{1} << 16; at < count; at *= 2) {
+        std::cout << std::left << std::setw(24)
+                  << (std::to_string(at) + "-" + std::to_string(std::min(2 * at, count)))
+                  << std::right << std::setw(18) << window_max(stop, at, 2 * at) << std::setw(15)
+                  << window_max(incremental, at, 2 * at) << "\n";
+    }
+    return 0;
+}
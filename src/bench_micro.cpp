@@ -0,0 +1,464 @@
+/**
+ * @file bench_micro.cpp
+ * @brief Per-component microbenchmarks: OrderMap, PriceLevel, ObjectPool, parser, endian, OrderBook
+ *
+ * Each case times `batches` batches of a few hundred operations with the TSC
+ * (rdtsc before, rdtscp after) and reports ns/op as median, robust spread
+ * (scaled MAD), min, p90 and the number of outlier batches; see
+ * bench::RobustStats. Untimed per-batch setup keeps the structure under test
+ * at the stated size, and results go through bench::do_not_optimize so the
+ * compiler cannot drop the work.
+ *
+ * Groups:
+ * - ordermap:   find hit / miss, put, remove at 10%, 25% and 45% load of a
+ *               2^20-slot OrderMap, for dense, gapped (ITCH-like) and random
+ *               refs (see RefStream)
+ * - pricelevel: requeue front, requeue random, add + remove tail at queue
+ *               depths 1 .. 16384
+ * - pool:       ObjectPool acquire + release pairs, acquire and release bursts
+ * - parser:     TemplateParser vs. virtual ITCHParser per message type and
+ *               for a mixed stream, into the same do-little handler (the
+ *               virtual parser also keeps per-type counts)
+ * - endian:     be16/32/48/64 to host over a 4096-entry array
+ * - book:       OrderBook add + delete (existing / new level), partial
+ *               execute, replace (same price / other level) and a top-10
+ *               depth query at 1 .. 4096 levels per side, gapped refs
+ *
+ * Usage: bench_micro [group[,group...]] [batches]   (default: all, 200)
+ */
+
+#include "bench_common.hpp"
+
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+
+namespace {
+
+constexpr std::size_t WARMUP_BATCHES = 10;
+constexpr std::size_t BATCH = 256;
+
+std::size_t g_batches = 200;
+
+void print_group(const char* title) {
+    std::cout << "\n" << title << "\n"
+              << std::left << std::setw(40) << "  case" << std::right << std::setw(12) << "median"
+              << std::setw(11) << "+/-" << std::setw(11) << "min" << std::setw(11) << "p90"
+              << std::setw(10) << "outliers" << "   (ns/op)\n";
+}
+
+/**
+ * @brief Time `body` (which performs `ops` operations) over the configured batches
+ *
+ * `prepare` runs untimed before every batch to put the structure back in
+ * its starting state.
+ */
+template<typename Prepare, typename Body>
+void run(const std::string& label, std::size_t ops, Prepare&& prepare, Body&& body) {
+    std::vector<double> per_op;
+    per_op.reserve(g_batches);
+    for (std::size_t b = 0; b < WARMUP_BATCHES + g_batches; ++b) {
+        prepare();
+        bench::clobber_memory();
+        const std::uint64_t start = itch::timing::rdtsc();
+        body();
+        bench::clobber_memory();
+        const std::uint64_t end = itch::timing::rdtscp();
+        if (b >= WARMUP_BATCHES) {
+            per_op.push_back(static_cast<double>(end - start) / bench::tsc_per_ns() /
+                             static_cast<double>(ops));
+        }
+    }
+    const bench::RobustStats s = bench::robust_stats(std::move(per_op));
+    std::cout << "  " << std::left << std::setw(38) << label << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << s.median << std::setw(11) << s.mad
+              << std::setw(11) << s.min << std::setw(11) << s.p90 << std::setw(10) << s.outliers
+              << "\n";
+}
+
+template<typename Body>
+void run(const std::string& label, std::size_t ops, Body&& body) {
+    run(label, ops, [] {}, std::forward<Body>(body));
+}
+
+std::string label(const char* what, const char* unit, std::size_t n) {
+    std::ostringstream out;
+    out << what << " @ " << n << unit;
+    return out.str();
+}
+
+// =============================================================================
+// OrderMap
+// =============================================================================
+
+/**
+ * @brief Order-ref streams as one book sees them
+ *
+ * dense:  1, 2, 3, ... (the book gets every ref; one long probe run)
+ * gapped: ascending with random gaps of 1..127, as for one of ~64 books
+ *         sharing the feed's ref sequence
+ * rand:   uniform 64-bit refs
+ */
+enum class RefStream { Dense, Gapped, Random };
+constexpr const char* REF_STREAM_NAMES[] = {"dense", "gapped", "rand"};
+
+class RefSource {
+public:
+    RefSource(RefStream stream, std::uint64_t seed) : stream_(stream), rng_(seed) {}
+
+    itch::OrderId next() {
+        switch (stream_) {
+            case RefStream::Dense:  return ++last_;
+            case RefStream::Gapped: return last_ += 1 + rng_() % 127;
+            default:                return rng_() | 1;
+        }
+    }
+
+private:
+    RefStream stream_;
+    std::mt19937_64 rng_;
+    itch::OrderId last_ = 0;
+};
+
+void bench_order_map() {
+    print_group("OrderMap (2^20 slots)");
+    constexpr std::size_t CAPACITY = std::size_t{1} << 20;
+    static itch::Order dummy;
+    itch::Order* const value = &dummy;
+
+    for (const RefStream stream : {RefStream::Dense, RefStream::Gapped, RefStream::Random}) {
+        for (const std::size_t pct : {10, 25, 45}) {
+            const std::size_t live = CAPACITY * pct / 100;
+            RefSource refs(stream, pct);
+            std::mt19937_64 rng(pct);
+            auto map = std::make_unique<itch::OrderMap>(CAPACITY);
+            std::vector<itch::OrderId> ids(live);
+            for (auto& id : ids) {
+                id = refs.next();
+                map->put(id, value);
+            }
+            // Every dense remove walks the rest of one long probe run: keep its batch short
+            const std::size_t removes = stream == RefStream::Dense ? 16 : BATCH;
+            std::vector<itch::OrderId> hits(BATCH), misses(BATCH), fresh(BATCH), victims(removes);
+            for (auto& id : hits) id = ids[rng() % live];
+            for (auto& id : misses) id = refs.next();   // Never inserted
+            for (auto& id : fresh) id = refs.next();
+            // Distinct live orders for remove
+            std::shuffle(ids.begin(), ids.end(), rng);
+            std::copy(ids.begin(), ids.begin() + static_cast<std::ptrdiff_t>(removes), victims.begin());
+
+            const std::string tag = std::to_string(pct) + "% load " + REF_STREAM_NAMES[static_cast<int>(stream)];
+            run("find hit    " + tag, BATCH, [&] {
+                for (const itch::OrderId id : hits) bench::do_not_optimize(map->find(id));
+            });
+            run("find miss   " + tag, BATCH, [&] {
+                for (const itch::OrderId id : misses) bench::do_not_optimize(map->find(id));
+            });
+            run("put new     " + tag, BATCH,
+                [&] { for (const itch::OrderId id : fresh) map->remove(id); },
+                [&] { for (const itch::OrderId id : fresh) map->put(id, value); });
+            for (const itch::OrderId id : fresh) map->remove(id);
+            run("remove live " + tag, removes,
+                [&] { for (const itch::OrderId id : victims) map->put(id, value); },
+                [&] { for (const itch::OrderId id : victims) map->remove(id); });
+        }
+    }
+}
+
+// =============================================================================
+// PriceLevel
+// =============================================================================
+
+void bench_price_level() {
+    print_group("PriceLevel (doubly-linked FIFO)");
+    for (const std::size_t depth : {1, 8, 64, 1024, 16384}) {
+        std::vector<itch::Order> orders(depth + 1);
+        itch::PriceLevel level(1000000);
+        for (std::size_t i = 0; i < orders.size(); ++i) {
+            orders[i].reset();
+            orders[i].order_id = i + 1;
+            orders[i].quantity = 100;
+            if (i < depth) level.add_order(&orders[i]);
+        }
+        itch::Order* const spare = &orders[depth];
+        std::mt19937_64 rng(depth);
+        std::vector<itch::Order*> picks(BATCH);
+        for (auto& p : picks) p = &orders[rng() % depth];
+
+        run(label("requeue front", " orders", depth), BATCH, [&] {
+            for (std::size_t i = 0; i < BATCH; ++i) {
+                itch::Order* o = level.front();
+                level.remove_order(o);
+                level.add_order(o);
+            }
+        });
+        run(label("requeue random", " orders", depth), BATCH, [&] {
+            for (itch::Order* o : picks) {
+                level.remove_order(o);
+                level.add_order(o);
+            }
+        });
+        run(label("add + remove tail", " orders", depth), BATCH, [&] {
+            for (std::size_t i = 0; i < BATCH; ++i) {
+                level.add_order(spare);
+                level.remove_order(spare);
+            }
+        });
+        bench::do_not_optimize(level.total_quantity());
+    }
+}
+
+// =============================================================================
+// ObjectPool
+// =============================================================================
+
+void bench_pool() {
+    print_group("ObjectPool<Order>");
+    itch::ObjectPool<itch::Order> pool;
+    std::vector<itch::Order*> held(BATCH);
+
+    run("acquire + release", BATCH, [&] {
+        for (std::size_t i = 0; i < BATCH; ++i) {
+            itch::Order* o = pool.acquire();
+            bench::do_not_optimize(o);
+            pool.release(o);
+        }
+    });
+    run(label("acquire burst", "", BATCH), BATCH,
+        [&] { for (itch::Order* o : held) if (o) pool.release(o); },
+        [&] { for (auto& o : held) o = pool.acquire(); });
+    for (itch::Order* o : held) if (o) pool.release(o);
+    run(label("release burst", "", BATCH), BATCH,
+        [&] { for (auto& o : held) o = pool.acquire(); },
+        [&] { for (itch::Order* o : held) pool.release(o); });
+}
+
+// =============================================================================
+// Parser Dispatch
+// =============================================================================
+
+/**
+ * @brief Same trivial work for every message; final so TemplateParser's calls are direct
+ */
+class ChecksumSink final : public itch::MessageHandler {
+public:
+    std::uint64_t sum = 0;
+
+#define ITCH_BENCH_SINK(fn, Msg) \
+    void fn(const itch::Msg& msg, itch::Timestamp ts) override { sum += ts + msg.stock_locate; }
+    ITCH_BENCH_SINK(on_system_event, SystemEventMessage)
+    ITCH_BENCH_SINK(on_stock_directory, StockDirectoryMessage)
+    ITCH_BENCH_SINK(on_stock_trading_action, StockTradingActionMessage)
+    ITCH_BENCH_SINK(on_reg_sho_restriction, RegSHORestrictionMessage)
+    ITCH_BENCH_SINK(on_market_participant_pos, MarketParticipantPosMessage)
+    ITCH_BENCH_SINK(on_mwcb_decline_level, MWCBDeclineLevelMessage)
+    ITCH_BENCH_SINK(on_mwcb_status, MWCBStatusMessage)
+    ITCH_BENCH_SINK(on_ipo_quoting_period, IPOQuotingPeriodMessage)
+    ITCH_BENCH_SINK(on_luld_auction_collar, LULDAuctionCollarMessage)
+    ITCH_BENCH_SINK(on_operational_halt, OperationalHaltMessage)
+    ITCH_BENCH_SINK(on_add_order, AddOrderMessage)
+    ITCH_BENCH_SINK(on_add_order_mpid, AddOrderMPIDMessage)
+    ITCH_BENCH_SINK(on_order_executed, OrderExecutedMessage)
+    ITCH_BENCH_SINK(on_order_executed_price, OrderExecutedPriceMessage)
+    ITCH_BENCH_SINK(on_order_cancel, OrderCancelMessage)
+    ITCH_BENCH_SINK(on_order_delete, OrderDeleteMessage)
+    ITCH_BENCH_SINK(on_order_replace, OrderReplaceMessage)
+    ITCH_BENCH_SINK(on_trade, TradeMessage)
+    ITCH_BENCH_SINK(on_cross_trade, CrossTradeMessage)
+    ITCH_BENCH_SINK(on_broken_trade, BrokenTradeMessage)
+    ITCH_BENCH_SINK(on_noii, NOIIMessage)
+    ITCH_BENCH_SINK(on_rpii, RPIIMessage)
+#undef ITCH_BENCH_SINK
+};
+
+/// BATCH messages of one type (zeroed bodies; only header fields vary)
+bench::Workload single_type_stream(char type) {
+    bench::Workload w;
+    const std::size_t size = itch::get_message_size(type);
+    w.data.resize(size * BATCH);
+    for (std::size_t i = 0; i < BATCH; ++i) {
+        char* msg = w.data.data() + i * size;
+        w.offsets.push_back(static_cast<std::uint32_t>(i * size));
+        msg[0] = type;
+        std::uint16_t locate;
+        bench::set_be16(locate, static_cast<std::uint16_t>(1 + i % 100));
+        std::memcpy(msg + 1, &locate, sizeof(locate));
+        bench::set_timestamp(reinterpret_cast<std::uint8_t*>(msg + 5),
+                             34200000000000ULL + i * 1000);
+    }
+    return w;
+}
+
+void bench_parser() {
+    print_group("Parser dispatch (TemplateParser vs. virtual ITCHParser)");
+    ChecksumSink sink;
+    itch::TemplateParser<ChecksumSink> direct(&sink);
+    itch::ITCHParser virtual_parser(&sink);
+
+    bench::WorkloadGenerator gen(42, 100, 1000);
+    std::vector<std::pair<std::string, bench::Workload>> streams;
+    for (const char type : {'A', 'F', 'E', 'C', 'X', 'D', 'U', 'P', 'Q', 'I', 'S', 'R', 'H'}) {
+        streams.emplace_back(std::string("'") + type + "'", single_type_stream(type));
+    }
+    streams.emplace_back("mixed", gen.generate(BATCH));
+
+    for (const auto& [name, w] : streams) {
+        const char* data = w.data.data();
+        const std::size_t len = w.data.size();
+        run("template " + name, w.message_count(), [&] { bench::do_not_optimize(direct.parse(data, len)); });
+        run("virtual  " + name, w.message_count(), [&] { bench::do_not_optimize(virtual_parser.parse(data, len)); });
+    }
+    bench::do_not_optimize(sink.sum);
+}
+
+// =============================================================================
+// Endian Conversion
+// =============================================================================
+
+void bench_endian() {
+    print_group("Endian conversion (4096 values)");
+    constexpr std::size_t N = 4096;
+    std::mt19937_64 rng(1);
+    std::vector<std::uint16_t> v16(N);
+    std::vector<std::uint32_t> v32(N);
+    std::vector<std::uint64_t> v64(N);
+    std::vector<std::uint8_t> v48(N * 6);
+    for (std::size_t i = 0; i < N; ++i) {
+        v16[i] = static_cast<std::uint16_t>(rng());
+        v32[i] = static_cast<std::uint32_t>(rng());
+        v64[i] = rng();
+    }
+    for (auto& b : v48) b = static_cast<std::uint8_t>(rng());
+
+    run("be16_to_host", N, [&] {
+        std::uint64_t sum = 0;
+        for (const std::uint16_t x : v16) sum += itch::endian::be16_to_host(x);
+        bench::do_not_optimize(sum);
+    });
+    run("be32_to_host", N, [&] {
+        std::uint64_t sum = 0;
+        for (const std::uint32_t x : v32) sum += itch::endian::be32_to_host(x);
+        bench::do_not_optimize(sum);
+    });
+    run("be48_to_host (timestamp)", N, [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < N; ++i) sum += itch::endian::be48_to_host(&v48[i * 6]);
+        bench::do_not_optimize(sum);
+    });
+    run("be64_to_host", N, [&] {
+        std::uint64_t sum = 0;
+        for (const std::uint64_t x : v64) sum += itch::endian::be64_to_host(x);
+        bench::do_not_optimize(sum);
+    });
+}
+
+// =============================================================================
+// OrderBook
+// =============================================================================
+
+void bench_book() {
+    print_group("OrderBook (4 orders per level)");
+    constexpr itch::Price MID = 1000000;
+    constexpr itch::Price TICK = 100;
+    constexpr std::size_t PER_LEVEL = 4;
+    constexpr itch::Quantity BIG = 1000000000;
+
+    for (const std::size_t levels : {1, 16, 256, 4096}) {
+        itch::ObjectPool<itch::Order> pool;
+        auto book = std::make_unique<itch::OrderBook>(1, levels * PER_LEVEL * 4);
+        // Levels on even ticks away from the touch; odd ticks stay free for new levels
+        auto bid_at = [&](std::size_t k) { return MID - TICK - static_cast<itch::Price>(2 * k) * TICK; };
+        RefSource refs(RefStream::Gapped, levels);
+        std::vector<itch::OrderId> resting;
+        for (std::size_t k = 0; k < levels; ++k) {
+            for (std::size_t j = 0; j < PER_LEVEL; ++j) {
+                resting.push_back(refs.next());
+                book->add_order(resting.back(), itch::Side::Buy, bid_at(k), BIG, 0, pool);
+                book->add_order(refs.next(), itch::Side::Sell,
+                                MID + TICK + static_cast<itch::Price>(2 * k) * TICK, BIG, 0, pool);
+            }
+        }
+        std::mt19937_64 rng(levels);
+        std::vector<itch::Price> existing(BATCH), gaps(BATCH);
+        std::vector<itch::OrderId> picks(BATCH);
+        for (std::size_t i = 0; i < BATCH; ++i) {
+            const std::size_t k = rng() % levels;
+            existing[i] = bid_at(k);
+            gaps[i] = bid_at(k) - TICK;     // Odd tick: no level there yet
+            picks[i] = resting[rng() % resting.size()];
+        }
+
+        run(label("add + delete, existing level", " lvls", levels), BATCH, [&] {
+            for (const itch::Price p : existing) {
+                const itch::OrderId id = refs.next();
+                book->add_order(id, itch::Side::Buy, p, 100, 0, pool);
+                book->delete_order(id, pool);
+            }
+        });
+        run(label("add + delete, new level", " lvls", levels), BATCH, [&] {
+            for (const itch::Price p : gaps) {
+                const itch::OrderId id = refs.next();
+                book->add_order(id, itch::Side::Buy, p, 100, 0, pool);
+                book->delete_order(id, pool);
+            }
+        });
+        run(label("execute 1 share", " lvls", levels), BATCH, [&] {
+            for (const itch::OrderId id : picks) bench::do_not_optimize(book->execute_order(id, 1, pool));
+        });
+        // Replace back and forth between the touch and one level further out
+        itch::OrderId moving = refs.next();
+        book->add_order(moving, itch::Side::Buy, bid_at(0), 100, 0, pool);
+        run(label("replace, same price", " lvls", levels), BATCH, [&] {
+            for (std::size_t i = 0; i < BATCH; ++i) {
+                const itch::OrderId id = refs.next();
+                book->replace_order(moving, id, 100, bid_at(0), 0, pool);
+                moving = id;
+            }
+        });
+        const itch::Price away = bid_at(std::min<std::size_t>(1, levels - 1));
+        run(label("replace, other level", " lvls", levels), BATCH, [&] {
+            for (std::size_t i = 0; i < BATCH; ++i) {
+                const itch::OrderId id = refs.next();
+                book->replace_order(moving, id, 100, i % 2 ? bid_at(0) : away, 0, pool);
+                moving = id;
+            }
+        });
+        std::array<itch::DepthLevel, 10> top{};
+        run(label("top-10 bid depth", " lvls", levels), BATCH, [&] {
+            for (std::size_t i = 0; i < BATCH; ++i) {
+                bench::do_not_optimize(book->bid_depth(top));
+                bench::clobber_memory();
+            }
+        });
+    }
+}
+
+struct Group {
+    const char* name;
+    void (*fn)();
+};
+
+constexpr Group GROUPS[] = {
+    {"ordermap", bench_order_map}, {"pricelevel", bench_price_level}, {"pool", bench_pool},
+    {"parser", bench_parser},      {"endian", bench_endian},          {"book", bench_book},
+};
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::string filter = argc > 1 ? argv[1] : "all";
+    g_batches = argc > 2 ? std::max<std::size_t>(1, std::strtoull(argv[2], nullptr, 10)) : 200;
+
+    bench::print_header("Component Microbenchmarks");
+    std::cout << "TSC: " << std::fixed << std::setprecision(3) << bench::tsc_per_ns()
+              << " ticks/ns, " << g_batches << " batches of " << BATCH
+              << " ops per case (+" << WARMUP_BATCHES << " warm-up)\n";
+
+    for (const Group& g : GROUPS) {
+        if (filter == "all" || ("," + filter + ",").find("," + std::string(g.name) + ",") !=
+                                   std::string::npos) {
+            g.fn();
+        }
+    }
+    return 0;
+}
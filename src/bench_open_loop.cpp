@@ -0,0 +1,438 @@
+/**
+ * @file bench_open_loop.cpp
+ * @brief Open-loop latency vs. offered load for FeedHandler, free of coordinated omission
+ *
+ * A closed loop (process the next message when the last one is done) never
+ * lets a queue form, so slow messages delay the measurement instead of the
+ * messages behind them. Here arrivals follow a schedule fixed in advance:
+ * message i is due at start + schedule[i], at a fixed rate or with Poisson
+ * (exponential) gaps. Latency is measured from that intended send time to the
+ * end of FeedHandler::process() for the message, which includes the book
+ * update and any event callbacks. Time spent queued behind earlier messages
+ * therefore counts, however far the handler falls behind.
+ *
+ * Two input paths:
+ * - threads=2: a generator thread copies each message into a slot of a
+ *   single-producer/single-consumer ring when it is due, stamped with its
+ *   intended time; the handler thread drains the ring. A full ring stalls
+ *   the generator (counted) but not the stamps.
+ * - threads=1: the handler thread takes message i from the workload once
+ *   its intended time has passed. Same schedule and latency definition,
+ *   without the cross-core hand-off; the default on single-CPU hosts.
+ *
+ * The sweep first measures closed-loop capacity, then offers 10% .. 110% of
+ * it (or --rates), --repeat times per load, keeping the run with the median
+ * p99. The knee is the highest offered load up to which every point keeps
+ * p99 within --knee-factor of the lightest load's p99 and sustains 95% of
+ * the offered rate.
+ *
+ * Pauses of the host itself (preemption, SMIs, a hypervisor stealing the
+ * CPU) delay every message queued behind them, and an open loop reports
+ * that honestly. A one-second spin before the sweep counts such pauses so
+ * their effect on the tail can be told apart from the handler's.
+ *
+ * Usage: bench_open_loop [--rates r1,r2,... (M msgs/s)] [--arrivals fixed|poisson]
+ *                        [--duration SEC per point] [--messages N] [--seed S]
+ *                        [--threads 1|2] [--repeat R] [--knee-factor K] [--csv FILE]
+ */
+
+#include "bench_common.hpp"
+
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// =============================================================================
+// Input Ring
+// =============================================================================
+
+/// One received message: intended send time (TSC) plus a copy of its bytes
+struct Slot {
+    std::uint64_t intended;
+    std::uint32_t len;
+    char data[52];
+};
+static_assert(sizeof(Slot) == 64, "Slot should fill one cache line");
+static_assert(sizeof(itch::NOIIMessage) <= sizeof(Slot::data), "largest message must fit a slot");
+
+/**
+ * @brief Bounded single-producer/single-consumer ring of Slots
+ */
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity_pow2) : slots_(capacity_pow2), mask_(capacity_pow2 - 1) {}
+
+    void clear() noexcept {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        cached_head_ = 0;
+    }
+
+    /// Producer side; false when the ring is full
+    bool try_push(std::uint64_t intended, const char* msg, std::size_t len) noexcept {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) return false;
+        }
+        Slot& s = slots_[tail & mask_];
+        s.intended = intended;
+        s.len = static_cast<std::uint32_t>(len);
+        std::memcpy(s.data, msg, len);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side: hand every published slot to `fn`; returns the count
+    template<typename F>
+    std::size_t drain(F&& fn) {
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        const std::uint64_t tail = tail_.load(std::memory_order_acquire);
+        for (std::uint64_t i = head; i < tail; ++i) fn(slots_[i & mask_]);
+        head_.store(tail, std::memory_order_release);
+        return static_cast<std::size_t>(tail - head);
+    }
+
+private:
+    std::vector<Slot> slots_;
+    std::size_t mask_;
+    alignas(itch::CACHE_LINE_SIZE) std::atomic<std::uint64_t> head_{0};  // Consumer
+    alignas(itch::CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail_{0};  // Producer
+    std::uint64_t cached_head_ = 0;                                       // Producer-local
+};
+
+// =============================================================================
+// Load Points
+// =============================================================================
+
+struct Options {
+    std::vector<double> rates;      // M msgs/s; empty = fractions of capacity
+    bool poisson = true;
+    double duration = 0.5;
+    std::size_t messages = 2000000;
+    std::uint64_t seed = 42;
+    std::size_t threads = std::thread::hardware_concurrency() > 1 ? 2 : 1;
+    std::size_t repeat = 3;
+    double knee_factor = 4.0;
+    std::string csv;
+};
+
+constexpr double CAPACITY_FRACTIONS[] = {0.1, 0.25, 0.5, 0.6, 0.7, 0.8, 0.85, 0.9, 0.95, 1.0, 1.1};
+constexpr std::size_t RING_SLOTS = 1u << 16;
+
+struct Point {
+    double offered = 0;             // M msgs/s
+    double achieved = 0;
+    std::size_t messages = 0;
+    std::uint64_t p50 = 0, p90 = 0, p99 = 0, p999 = 0, max = 0;    // ns, intended -> done
+    std::uint64_t service_p99 = 0;  // ns inside process() alone
+    std::uint64_t stalls = 0;       // Generator found the ring full
+};
+
+/// Callback work included in the measured span
+class BboSink : public itch::FeedEventHandler {
+public:
+    std::uint64_t sum = 0;
+    void on_bbo_update(const itch::BBOEvent& event) override { sum += event.new_bbo.bid_quantity; }
+    void on_trade(const itch::TradeEvent& event) override { sum += event.quantity; }
+};
+
+/// Intended send offsets in TSC ticks from the run's start
+std::vector<std::uint64_t> make_schedule(std::size_t count, double rate_mps, bool poisson,
+                                         std::uint64_t seed) {
+    const double mean_gap = bench::tsc_per_ns() * 1e3 / rate_mps;
+    std::mt19937_64 rng(seed);
+    std::exponential_distribution<double> gap(1.0 / mean_gap);
+    std::vector<std::uint64_t> out(count);
+    double t = 0;
+    for (auto& s : out) {
+        s = static_cast<std::uint64_t>(t);
+        t += poisson ? gap(rng) : mean_gap;
+    }
+    return out;
+}
+
+/// Spin, or yield where the two threads share a single CPU
+inline void pause() noexcept {
+    static const bool single_cpu = std::thread::hardware_concurrency() < 2;
+    if (single_cpu) {
+        std::this_thread::yield();
+    } else {
+        itch::cpu_relax();
+    }
+}
+
+inline void wait_until(std::uint64_t tsc) noexcept {
+    while (itch::timing::rdtsc() < tsc) pause();
+}
+
+class Harness {
+public:
+    Harness(const Options& opt, const bench::Workload& directory, const bench::Workload& day)
+        : opt_(opt), directory_(directory), day_(day), handler_(std::make_unique<itch::FeedHandler>()),
+          ring_(RING_SLOTS) {
+        handler_->set_event_handler(&sink_);
+        latency_.reserve(day.message_count());
+        service_.reserve(day.message_count());
+    }
+
+    /// Closed-loop messages per microsecond over the whole workload (after one warm pass)
+    double capacity() {
+        start_session();
+        handler_->process(day_.data.data(), day_.data.size());
+        start_session();
+        const double ns = bench::time_ns([&] { handler_->process(day_.data.data(), day_.data.size()); });
+        return static_cast<double>(day_.message_count()) / ns * 1e3;
+    }
+
+    /// `repeat` runs at `rate_mps`; the one with the median p99
+    Point measure(double rate_mps) {
+        std::vector<Point> runs;
+        for (std::size_t r = 0; r < opt_.repeat; ++r) runs.push_back(run(rate_mps));
+        std::sort(runs.begin(), runs.end(), [](const Point& a, const Point& b) { return a.p99 < b.p99; });
+        return runs[runs.size() / 2];
+    }
+
+private:
+    Point run(double rate_mps) {
+        const auto wanted = static_cast<std::size_t>(rate_mps * 1e6 * opt_.duration);
+        const std::size_t n = std::min(day_.message_count(), std::max<std::size_t>(wanted, 10000));
+        const std::vector<std::uint64_t> schedule = make_schedule(n, rate_mps, opt_.poisson, opt_.seed);
+        start_session();
+        latency_.clear();
+        service_.clear();
+
+        Point p;
+        p.offered = rate_mps;
+        p.messages = n;
+        const double ticks_per_ms = bench::tsc_per_ns() * 1e6;
+        const std::uint64_t start = itch::timing::rdtsc() + static_cast<std::uint64_t>(ticks_per_ms);
+        std::uint64_t last_done = start;
+
+        if (opt_.threads >= 2) {
+            ring_.clear();
+            std::thread generator([&] {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const std::uint64_t due = start + schedule[i];
+                    wait_until(due);
+                    while (!ring_.try_push(due, day_.message(i), day_.message_size(i))) {
+                        ++p.stalls;
+                        pause();
+                    }
+                }
+            });
+            std::size_t done = 0;
+            while (done < n) {
+                const std::size_t got = ring_.drain([&](const Slot& s) {
+                    const std::uint64_t begin = itch::timing::rdtsc();
+                    handler_->process(s.data, s.len);
+                    last_done = itch::timing::rdtscp();
+                    latency_.push_back(last_done - s.intended);
+                    service_.push_back(last_done - begin);
+                });
+                if (got == 0) pause();
+                done += got;
+            }
+            generator.join();
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::uint64_t due = start + schedule[i];
+                wait_until(due);
+                const std::uint64_t begin = itch::timing::rdtsc();
+                handler_->process(day_.message(i), day_.message_size(i));
+                last_done = itch::timing::rdtscp();
+                latency_.push_back(last_done - due);
+                service_.push_back(last_done - begin);
+            }
+        }
+
+        p.achieved = static_cast<double>(n) / ticks_to_ns(last_done - start) * 1e3;
+        summarize(p);
+        return p;
+    }
+
+    const Options& opt_;
+    const bench::Workload& directory_;
+    const bench::Workload& day_;
+    std::unique_ptr<itch::FeedHandler> handler_;
+    BboSink sink_;
+    SpscRing ring_;
+    std::vector<std::uint64_t> latency_;
+    std::vector<std::uint64_t> service_;
+
+    static double ticks_to_ns(std::uint64_t ticks) {
+        return static_cast<double>(ticks) / bench::tsc_per_ns();
+    }
+
+    void start_session() {
+        handler_->reset();
+        handler_->process(directory_.data.data(), directory_.data.size());
+    }
+
+    /// Percentiles over all but the first 5% of messages (the run's own warm-up)
+    void summarize(Point& p) {
+        const std::size_t skip = latency_.size() / 20;
+        std::vector<std::uint64_t> lat(latency_.begin() + static_cast<std::ptrdiff_t>(skip), latency_.end());
+        std::vector<std::uint64_t> svc(service_.begin() + static_cast<std::ptrdiff_t>(skip), service_.end());
+        std::sort(lat.begin(), lat.end());
+        const auto at = [&](const std::vector<std::uint64_t>& v, double q) {
+            const std::size_t i = std::min(v.size() - 1, static_cast<std::size_t>(q * static_cast<double>(v.size())));
+            return static_cast<std::uint64_t>(ticks_to_ns(v[i]));
+        };
+        p.p50 = at(lat, 0.5);
+        p.p90 = at(lat, 0.9);
+        p.p99 = at(lat, 0.99);
+        p.p999 = at(lat, 0.999);
+        p.max = static_cast<std::uint64_t>(ticks_to_ns(lat.back()));
+        std::sort(svc.begin(), svc.end());
+        p.service_p99 = at(svc, 0.99);
+    }
+};
+
+struct HostJitter {
+    std::size_t over_50us = 0;
+    std::size_t over_500us = 0;
+    std::uint64_t max_ns = 0;
+};
+
+/// Gaps between consecutive TSC reads while spinning for one second
+HostJitter measure_host_jitter() {
+    HostJitter j;
+    const double per_ns = bench::tsc_per_ns();
+    const std::uint64_t end = itch::timing::rdtsc() + static_cast<std::uint64_t>(per_ns * 1e9);
+    std::uint64_t last = itch::timing::rdtsc();
+    while (last < end) {
+        const std::uint64_t now = itch::timing::rdtsc();
+        const auto gap = static_cast<std::uint64_t>(static_cast<double>(now - last) / per_ns);
+        j.over_50us += gap > 50000;
+        j.over_500us += gap > 500000;
+        j.max_ns = std::max(j.max_ns, gap);
+        last = now;
+    }
+    return j;
+}
+
+/// Index of the knee point, or -1 if even the lightest load misses the criteria
+int find_knee(const std::vector<Point>& points, double factor) {
+    if (points.empty()) return -1;
+    const double base = static_cast<double>(std::max<std::uint64_t>(points.front().p99, 1));
+    int knee = -1;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const Point& p = points[i];
+        if (static_cast<double>(p.p99) > factor * base || p.achieved < 0.95 * p.offered) break;
+        knee = static_cast<int>(i);
+    }
+    return knee;
+}
+
+// =============================================================================
+// Command Line
+// =============================================================================
+
+bool parse_args(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        const char* value = argv[i + 1];
+        if (arg == "--rates") {
+            std::stringstream in(value);
+            std::string item;
+            while (std::getline(in, item, ',')) {
+                if (!item.empty()) opt.rates.push_back(std::strtod(item.c_str(), nullptr));
+            }
+        } else if (arg == "--arrivals") {
+            opt.poisson = std::string(value) != "fixed";
+        } else if (arg == "--duration") {
+            opt.duration = std::strtod(value, nullptr);
+        } else if (arg == "--messages") {
+            opt.messages = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--seed") {
+            opt.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--threads") {
+            opt.threads = std::strtoull(value, nullptr, 10) >= 2 ? 2 : 1;
+        } else if (arg == "--repeat") {
+            opt.repeat = std::max<std::size_t>(1, std::strtoull(value, nullptr, 10));
+        } else if (arg == "--knee-factor") {
+            opt.knee_factor = std::strtod(value, nullptr);
+        } else if (arg == "--csv") {
+            opt.csv = value;
+        } else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        std::cerr << "Missing value for " << argv[argc - 1] << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) return 2;
+
+    bench::print_header("Open-Loop Latency vs. Offered Load");
+    bench::WorkloadGenerator gen(opt.seed, 100, 1000);
+    const bench::Workload directory = gen.directory();
+    const bench::Workload day = gen.generate(opt.messages);
+    Harness harness(opt, directory, day);
+
+    const HostJitter jitter = measure_host_jitter();
+    const double capacity = harness.capacity();
+    if (opt.rates.empty()) {
+        for (const double f : CAPACITY_FRACTIONS) opt.rates.push_back(f * capacity);
+    }
+    std::sort(opt.rates.begin(), opt.rates.end());
+
+    std::cout << "Arrivals: " << (opt.poisson ? "poisson" : "fixed") << ", input path: "
+              << (opt.threads >= 2 ? "generator thread + SPSC ring" : "inline schedule")
+              << ", " << opt.duration << " s per point x " << opt.repeat << ", seed " << opt.seed
+              << "\n"
+              << "Host pauses in a 1 s spin: " << jitter.over_50us << " > 50 us, "
+              << jitter.over_500us << " > 500 us, longest " << jitter.max_ns / 1000 << " us\n"
+              << "Closed-loop capacity: " << std::fixed << std::setprecision(2) << capacity
+              << " M msgs/s\n\n"
+              << std::setw(9) << "offered" << std::setw(10) << "achieved" << std::setw(9) << "p50"
+              << std::setw(9) << "p90" << std::setw(10) << "p99" << std::setw(11) << "p99.9"
+              << std::setw(11) << "max" << std::setw(10) << "svc p99" << std::setw(9) << "stalls"
+              << "\n" << std::setw(9) << "(M/s)" << std::setw(10) << "(M/s)" << std::setw(69)
+              << "(ns, intended send -> done)\n";
+
+    std::vector<Point> points;
+    for (const double rate : opt.rates) {
+        if (rate <= 0) continue;
+        points.push_back(harness.measure(rate));
+        const Point& p = points.back();
+        std::cout << std::setw(9) << std::setprecision(3) << p.offered << std::setw(10) << p.achieved
+                  << std::setw(9) << p.p50 << std::setw(9) << p.p90 << std::setw(10) << p.p99
+                  << std::setw(11) << p.p999 << std::setw(11) << p.max << std::setw(10)
+                  << p.service_p99 << std::setw(9) << p.stalls << "\n";
+    }
+
+    const int knee = find_knee(points, opt.knee_factor);
+    if (knee < 0) {
+        std::cout << "\nKnee: not found (the lightest load already misses the criteria)\n";
+    } else {
+        const Point& k = points[static_cast<std::size_t>(knee)];
+        std::cout << "\nKnee: " << std::setprecision(3) << k.offered << " M msgs/s ("
+                  << std::setprecision(0) << 100.0 * k.offered / capacity
+                  << "% of closed-loop capacity), p99 " << k.p99 << " ns";
+        if (static_cast<std::size_t>(knee) + 1 == points.size()) std::cout << " (highest load tried)";
+        std::cout << "\n";
+    }
+
+    if (!opt.csv.empty()) {
+        std::ofstream out(opt.csv);
+        out << "offered_mps,achieved_mps,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,service_p99_ns,stalls\n";
+        for (const Point& p : points) {
+            out << p.offered << "," << p.achieved << "," << p.p50 << "," << p.p90 << "," << p.p99
+                << "," << p.p999 << "," << p.max << "," << p.service_p99 << "," << p.stalls << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file bench_order_handles.cpp
+ * @brief Cache misses per execute: id-based vs. handle-based OrderBook calls
+ *
+ * Seeds many books with large resting orders and applies the same random
+ * stream of one-share executions two ways:
+ * - by id:     get_order(id) then execute_order(id, ...), the feed handler's
+ *              original sequence (a second index probe, plus the level search
+ *              on trees that predate Order::level)
+ * - by handle: get_order(id) then execute_order(order, ...)
+ * Reports ns and, where the PMU is exposed, hardware counters per execute.
+ *
+ * Usage: bench_order_handles [executes] [symbols] [orders_per_symbol]
+ */
+
+#include "bench_common.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+struct ExecuteOp {
+    itch::StockLocate locate;
+    itch::OrderId id;
+};
+
+struct Result {
+    double ns = 0;
+    std::uint64_t counters[bench::PerfCounters::EVENT_COUNT] = {};
+};
+
+template<bool ByHandle>
+Result run(itch::OrderBookManager& books, const std::vector<ExecuteOp>& ops,
+           bench::PerfCounters& perf) {
+    auto& pool = books.order_pool();
+    Result r;
+    perf.start();
+    r.ns = bench::time_ns([&] {
+        for (const auto& op : ops) {
+            itch::OrderBook& book = books.get_book(op.locate);
+            itch::Order* order = book.get_order(op.id);
+            if (!order) continue;
+            if (ByHandle) {
+                book.execute_order(order, 1, pool);
+            } else {
+                book.execute_order(op.id, 1, pool);
+            }
+        }
+    }) / static_cast<double>(ops.size());
+    perf.stop();
+    for (std::size_t e = 0; e < bench::PerfCounters::EVENT_COUNT; ++e) {
+        r.counters[e] = perf.value(static_cast<bench::PerfCounters::Event>(e));
+    }
+    return r;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    const std::size_t num_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500;
+    const std::size_t per_symbol = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2000;
+
+    bench::print_header("Order Handle Execute Benchmark");
+
+    auto books = std::make_unique<itch::OrderBookManager>();
+    std::mt19937_64 rng(42);
+    itch::OrderId next_id = 1;
+    for (std::size_t s = 1; s <= num_symbols; ++s) {
+        const auto locate = static_cast<itch::StockLocate>(s);
+        itch::OrderBook& book = books->get_book(locate, per_symbol);
+        for (std::size_t i = 0; i < per_symbol; ++i) {
+            const bool buy = rng() % 2 == 0;
+            const itch::Price offset = static_cast<itch::Price>(rng() % 100) * 100;
+            book.add_order(next_id++, buy ? itch::Side::Buy : itch::Side::Sell,
+                           buy ? 1000000 - offset : 1000100 + offset, 1000000000, 0,
+                           books->order_pool());
+        }
+    }
+
+    std::vector<ExecuteOp> ops(num_ops);
+    for (auto& op : ops) {
+        op.id = 1 + rng() % (next_id - 1);
+        op.locate = static_cast<itch::StockLocate>(1 + (op.id - 1) / per_symbol);
+    }
+
+    bench::PerfCounters perf;
+    std::cout << "Books: " << num_symbols << " x " << per_symbol << " orders, executes: "
+              << num_ops << "\n";
+    if (!perf.any_available()) {
+        std::cout << "Hardware counters unavailable (no PMU access); timing only\n";
+    }
+    std::cout << "\n";
+
+    Result by_id = run<false>(*books, ops, perf);
+    Result by_handle = run<true>(*books, ops, perf);
+    // Second pass with the order reversed so neither path gets the cold run
+    by_handle = run<true>(*books, ops, perf);
+    by_id = run<false>(*books, ops, perf);
+
+    const double n = static_cast<double>(num_ops);
+    std::cout << std::fixed << std::setprecision(2)
+              << std::left << std::setw(20) << "Per execute" << std::right << std::setw(14)
+              << "by id" << std::setw(14) << "by handle\n"
+              << std::left << std::setw(20) << "ns" << std::right << std::setw(14)
+              << by_id.ns << std::setw(13) << by_handle.ns << "\n";
+    for (std::size_t e = 0; e < bench::PerfCounters::EVENT_COUNT; ++e) {
+        const auto event = static_cast<bench::PerfCounters::Event>(e);
+        if (!perf.available(event)) continue;
+        std::cout << std::left << std::setw(20) << bench::PerfCounters::name(event) << std::right
+                  << std::setw(14) << (static_cast<double>(by_id.counters[e]) / n)
+                  << std::setw(13) << (static_cast<double>(by_handle.counters[e]) / n) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file bench_order_index.cpp
+ * @brief OrderMap (linear probing, identity hash) vs. SwissOrderMap (SIMD groups)
+ *
+ * For each live-order count and each ref stream, both indexes run the same
+ * pre-generated operations:
+ * - insert:  N puts into a presized index
+ * - hit:     lookups of random live ids
+ * - churn:   extract a random live id + insert a fresh one (live count stays N)
+ * - miss:    lookups of the ids churn removed (late messages for dead orders)
+ * - erase:   extract every live id
+ *
+ * Streams:
+ * - sequential:  1, 2, 3, ...            (how ITCH assigns order refs)
+ * - random:      uniform 64-bit ids
+ * - adversarial: k << 10                 (refs that share their low bits, e.g.
+ *                                         a per-session prefix in the low word)
+ *
+ * Lookup / churn counts are capped at 10M per phase. Memory is roughly
+ * 16 * 2^ceil(log2(2N)) bytes for OrderMap and ~19 * N bytes for
+ * SwissOrderMap plus 8 * (2N + 20M) for the id streams: 100M live orders
+ * needs ~8 GB for the OrderMap run.
+ *
+ * Usage: bench_order_index [live_orders...]   (default: 1000000 10000000)
+ */
+
+#include "bench_common.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+constexpr std::size_t MAX_OPS = 10000000;
+
+enum class Stream { Sequential, Random, Adversarial };
+constexpr const char* STREAM_NAMES[] = {"sequential", "random", "adversarial"};
+constexpr const char* PHASE_NAMES[] = {"insert", "hit", "churn", "miss", "erase"};
+constexpr std::size_t PHASES = 5;
+
+struct Ops {
+    std::vector<itch::OrderId> ids;         // [0, N) initial, then churn inserts
+    std::vector<itch::OrderId> misses;      // Ids the churn phase removes
+    std::vector<std::uint32_t> hit_slots;   // Positions in the live table
+    std::vector<std::uint32_t> churn_slots;
+    std::size_t live = 0;
+    std::size_t ops = 0;
+};
+
+Ops make_ops(Stream stream, std::size_t live) {
+    Ops o;
+    o.live = live;
+    o.ops = std::min(live, MAX_OPS);
+    o.ids.resize(live + o.ops);
+    std::mt19937_64 rng(static_cast<std::uint64_t>(stream) + 1);
+    for (std::size_t i = 0; i < o.ids.size(); ++i) {
+        switch (stream) {
+            case Stream::Sequential:  o.ids[i] = i + 1; break;
+            case Stream::Random:      o.ids[i] = rng() | 1; break;
+            case Stream::Adversarial: o.ids[i] = static_cast<itch::OrderId>(i + 1) << 10; break;
+        }
+    }
+    o.hit_slots.resize(o.ops);
+    o.churn_slots.resize(o.ops);
+    for (auto& s : o.hit_slots) s = static_cast<std::uint32_t>(rng() % live);
+    for (auto& s : o.churn_slots) s = static_cast<std::uint32_t>(rng() % live);
+
+    std::vector<itch::OrderId> table(o.ids.begin(), o.ids.begin() + static_cast<std::ptrdiff_t>(live));
+    o.misses.resize(o.ops);
+    for (std::size_t i = 0; i < o.ops; ++i) {
+        o.misses[i] = table[o.churn_slots[i]];
+        table[o.churn_slots[i]] = o.ids[live + i];
+    }
+    return o;
+}
+
+itch::Order* fake_order(itch::OrderId id) {
+    // Never dereferenced; only carried through the index
+    return reinterpret_cast<itch::Order*>(static_cast<std::uintptr_t>(id) << 6);
+}
+
+template<typename Index>
+std::array<double, PHASES> run(const Ops& o, std::uint64_t& sink, std::size_t& max_probe) {
+    std::array<double, PHASES> ns{};
+    auto index = std::make_unique<Index>(0);
+    index->reserve(o.live);
+    std::vector<itch::OrderId> live(o.ids.begin(), o.ids.begin() + static_cast<std::ptrdiff_t>(o.live));
+
+    ns[0] = bench::time_ns([&] {
+        for (const itch::OrderId id : live) index->put(id, fake_order(id));
+    }) / static_cast<double>(o.live);
+
+    ns[1] = bench::time_ns([&] {
+        for (const std::uint32_t s : o.hit_slots) {
+            sink += reinterpret_cast<std::uintptr_t>(index->find(live[s]));
+        }
+    }) / static_cast<double>(o.ops);
+
+    const itch::OrderId* fresh = o.ids.data() + o.live;
+    ns[2] = bench::time_ns([&] {
+        for (std::size_t i = 0; i < o.ops; ++i) {
+            itch::OrderId& slot = live[o.churn_slots[i]];
+            sink += reinterpret_cast<std::uintptr_t>(index->extract(slot));
+            slot = fresh[i];
+            index->put(slot, fake_order(slot));
+        }
+    }) / static_cast<double>(o.ops);
+
+    ns[3] = bench::time_ns([&] {
+        for (const itch::OrderId id : o.misses) {
+            sink += reinterpret_cast<std::uintptr_t>(index->find(id));
+        }
+    }) / static_cast<double>(o.ops);
+
+    ns[4] = bench::time_ns([&] {
+        for (const itch::OrderId id : live) {
+            sink += reinterpret_cast<std::uintptr_t>(index->extract(id));
+        }
+    }) / static_cast<double>(o.live);
+
+    if constexpr (std::is_same_v<Index, itch::SwissOrderMap>) {
+        max_probe = index->max_probe();
+    }
+    return ns;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::size_t> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    if (sizes.empty()) sizes = {1000000, 10000000};
+
+    bench::print_header("Order Index Benchmark");
+    std::cout << "Backends: OrderMap (linear probing, identity hash, load <= 1/2)\n"
+              << "          SwissOrderMap (" << itch::SwissOrderMap::GROUP_SLOTS
+              << "-slot SIMD groups, fmix64, load <= 7/8)\n";
+
+    std::uint64_t sink = 0;
+    for (const std::size_t live : sizes) {
+        std::cout << "\nLive orders: " << live << "\n"
+                  << std::left << std::setw(14) << "Stream" << std::setw(9) << "Phase"
+                  << std::right << std::setw(14) << "OrderMap ns" << std::setw(12)
+                  << "Swiss ns" << std::setw(11) << "speedup\n";
+        for (const Stream stream : {Stream::Sequential, Stream::Random, Stream::Adversarial}) {
+            const Ops ops = make_ops(stream, live);
+            std::size_t max_probe = 0;
+            const auto linear = run<itch::OrderMap>(ops, sink, max_probe);
+            const auto swiss = run<itch::SwissOrderMap>(ops, sink, max_probe);
+            for (std::size_t p = 0; p < PHASES; ++p) {
+                std::cout << std::left << std::setw(14)
+                          << (p == 0 ? STREAM_NAMES[static_cast<int>(stream)] : "")
+                          << std::setw(9) << PHASE_NAMES[p] << std::right << std::fixed
+                          << std::setprecision(1) << std::setw(14) << linear[p]
+                          << std::setw(12) << swiss[p] << std::setw(10)
+                          << (linear[p] / swiss[p]) << "x\n";
+            }
+            std::cout << std::left << std::setw(14) << "" << "Swiss max probe: " << max_probe
+                      << " group(s)\n";
+        }
+    }
+    std::cout << "\nChecksum: " << sink << "\n";
+    return 0;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file bench_order_layout.cpp
+ * @brief Full-day replay: 64-byte Order (OrderBook) vs. hot/cold split (CompactOrderBook)
+ *
+ * Generates one synthetic day (directory + mixed add/execute/cancel/delete/
+ * replace stream) and replays it through a minimal parser-driven handler once
+ * per layout. Each layout runs in its own forked child so the RSS it reports
+ * (resident growth across the replay: books, order store, index) is not
+ * polluted by the other layout's freed memory. Both managers are presized for
+ * the generator's peak so neither grows its store on the feed path.
+ *
+ * Usage: bench_order_layout [messages] [symbols] [live_per_symbol]
+ */
+
+#include "bench_common.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+#if defined(__linux__)
+#include <sys/wait.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Book-building handler generic over the order layout
+ *
+ * Mirrors FeedHandler's book path (get_order + handle-based execute) without
+ * metrics, events or trade recording.
+ */
+template<typename Layout>
+class LayoutReplay {
+public:
+    using Manager = itch::BasicOrderBookManager<Layout>;
+
+    LayoutReplay(std::size_t peak_orders, std::size_t peak_per_book)
+        : books_(std::make_unique<Manager>()), parser_(this) {
+        books_->presize(peak_orders, peak_per_book);
+    }
+
+    std::size_t process(const char* data, std::size_t len) noexcept {
+        return parser_.parse(data, len);
+    }
+
+    const Manager& books() const noexcept { return *books_; }
+
+    void on_add_order(const itch::AddOrderMessage& msg, itch::Timestamp ts) {
+        using namespace itch::endian;
+        books_->get_book(be16_to_host(msg.stock_locate))
+            .add_order(be64_to_host(msg.order_ref_number), itch::char_to_side(msg.buy_sell_indicator),
+                       static_cast<itch::Price>(be32_to_host(msg.price)),
+                       be32_to_host(msg.shares), ts, books_->order_pool());
+    }
+
+    void on_order_executed(const itch::OrderExecutedMessage& msg, itch::Timestamp) {
+        using namespace itch::endian;
+        auto& book = books_->get_book(be16_to_host(msg.stock_locate));
+        if (auto order = book.get_order(be64_to_host(msg.order_ref_number))) {
+            book.execute_order(order, be32_to_host(msg.executed_shares), books_->order_pool());
+        }
+    }
+
+    void on_order_cancel(const itch::OrderCancelMessage& msg, itch::Timestamp) {
+        using namespace itch::endian;
+        books_->get_book(be16_to_host(msg.stock_locate))
+            .cancel_order(be64_to_host(msg.order_ref_number), be32_to_host(msg.cancelled_shares),
+                          books_->order_pool());
+    }
+
+    void on_order_delete(const itch::OrderDeleteMessage& msg, itch::Timestamp) {
+        using namespace itch::endian;
+        books_->get_book(be16_to_host(msg.stock_locate))
+            .delete_order(be64_to_host(msg.order_ref_number), books_->order_pool());
+    }
+
+    void on_order_replace(const itch::OrderReplaceMessage& msg, itch::Timestamp ts) {
+        using namespace itch::endian;
+        books_->get_book(be16_to_host(msg.stock_locate))
+            .replace_order(be64_to_host(msg.original_order_ref_number),
+                           be64_to_host(msg.new_order_ref_number), be32_to_host(msg.shares),
+                           static_cast<itch::Price>(be32_to_host(msg.price)), ts,
+                           books_->order_pool());
+    }
+
+    // Not generated by the workload
+    void on_add_order_mpid(const itch::AddOrderMPIDMessage&, itch::Timestamp) {}
+    void on_order_executed_price(const itch::OrderExecutedPriceMessage&, itch::Timestamp) {}
+    void on_trade(const itch::TradeMessage&, itch::Timestamp) {}
+    void on_cross_trade(const itch::CrossTradeMessage&, itch::Timestamp) {}
+    void on_broken_trade(const itch::BrokenTradeMessage&, itch::Timestamp) {}
+    void on_system_event(const itch::SystemEventMessage&, itch::Timestamp) {}
+    void on_stock_directory(const itch::StockDirectoryMessage&, itch::Timestamp) {}
+    void on_stock_trading_action(const itch::StockTradingActionMessage&, itch::Timestamp) {}
+    void on_reg_sho_restriction(const itch::RegSHORestrictionMessage&, itch::Timestamp) {}
+    void on_market_participant_pos(const itch::MarketParticipantPosMessage&, itch::Timestamp) {}
+    void on_mwcb_decline_level(const itch::MWCBDeclineLevelMessage&, itch::Timestamp) {}
+    void on_mwcb_status(const itch::MWCBStatusMessage&, itch::Timestamp) {}
+    void on_ipo_quoting_period(const itch::IPOQuotingPeriodMessage&, itch::Timestamp) {}
+    void on_luld_auction_collar(const itch::LULDAuctionCollarMessage&, itch::Timestamp) {}
+    void on_operational_halt(const itch::OperationalHaltMessage&, itch::Timestamp) {}
+    void on_noii(const itch::NOIIMessage&, itch::Timestamp) {}
+    void on_rpii(const itch::RPIIMessage&, itch::Timestamp) {}
+
+private:
+    std::unique_ptr<Manager> books_;
+    itch::TemplateParser<LayoutReplay> parser_;
+};
+
+template<typename Layout>
+void run(const char* name, const bench::Workload& day, std::size_t peak_orders,
+         std::size_t peak_per_book) {
+    const std::size_t rss_before = bench::rss_kib();
+    LayoutReplay<Layout> replay(peak_orders, peak_per_book);
+    std::size_t consumed = 0;
+    const double ns = bench::time_ns([&] { consumed = replay.process(day.data.data(), day.data.size()); });
+    const std::size_t rss_after = bench::rss_kib();
+
+    const double messages = static_cast<double>(day.message_count());
+    const double rss_mib = static_cast<double>(rss_after - rss_before) / 1024.0;
+    std::cout << std::left << std::setw(10) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << (messages * 1e3 / ns) << std::setw(10)
+              << (ns / messages) << std::setw(14) << rss_mib
+              << std::setw(14) << replay.books().total_order_count()
+              << (consumed == day.data.size() ? "" : "  (stream truncated)") << "\n";
+}
+
+template<typename Layout>
+void run_isolated(const char* name, const bench::Workload& day, std::size_t peak_orders,
+                  std::size_t peak_per_book) {
+    std::cout.flush();
+#if defined(__linux__)
+    const pid_t pid = fork();
+    if (pid == 0) {
+        run<Layout>(name, day, peak_orders, peak_per_book);
+        std::cout.flush();
+        std::_Exit(0);
+    }
+    if (pid > 0) {
+        waitpid(pid, nullptr, 0);
+        return;
+    }
+#endif
+    run<Layout>(name, day, peak_orders, peak_per_book);
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const std::size_t num_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    const std::size_t live_per_symbol = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2000;
+
+    bench::print_header("Order Layout Full-Day Replay Benchmark");
+    std::cout << "Wide:    Order " << sizeof(itch::Order) << " B (ObjectPool)\n"
+              << "Compact: CompactOrder " << sizeof(itch::CompactOrder) << " B hot + CompactOrderCold "
+              << sizeof(itch::CompactOrderCold) << " B cold (parallel arrays)\n";
+
+    bench::WorkloadGenerator gen(42, num_symbols, live_per_symbol);
+    bench::Workload day = gen.directory();
+    const bench::Workload stream = gen.generate(num_messages);
+    const std::size_t base = day.data.size();
+    day.data.insert(day.data.end(), stream.data.begin(), stream.data.end());
+    for (const std::uint32_t offset : stream.offsets) {
+        day.offsets.push_back(static_cast<std::uint32_t>(base + offset));
+    }
+
+    // The generator keeps the population within 2x of its target
+    const std::size_t peak_orders = 2 * num_symbols * live_per_symbol;
+    const std::size_t peak_per_book = 2 * live_per_symbol;
+    std::cout << "Messages: " << day.message_count() << ", symbols: " << num_symbols
+              << ", target live orders: " << num_symbols * live_per_symbol << "\n\n"
+              << std::left << std::setw(10) << "Layout" << std::right << std::setw(12)
+              << "Mmsg/s" << std::setw(10) << "ns/msg" << std::setw(14) << "RSS +MiB"
+              << std::setw(14) << "live orders\n";
+
+    run_isolated<itch::WideOrderLayout>("wide", day, peak_orders, peak_per_book);
+    run_isolated<itch::CompactOrderLayout>("compact", day, peak_orders, peak_per_book);
+    return 0;
+}
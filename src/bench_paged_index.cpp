@@ -0,0 +1,194 @@
+/**
+ * @file bench_paged_index.cpp
+ * @brief PagedOrderMap (direct-indexed pages) vs. the hash indexes on a realistic ref sequence
+ *
+ * The ref stream comes from the mixed-workload generator: refs are assigned
+ * in increasing order, each add / execute / cancel / delete / replace targets
+ * a live order, and lifetimes are long-tailed (a few orders rest all day).
+ * The messages are pre-decoded into index operations (find, put, extract),
+ * with the executions and cancels that empty an order turned into an extract,
+ * as the book would do.
+ *
+ * Two placements:
+ * - feed-wide: one index sees every ref (dense: the paged table's home turf)
+ * - per-book:  one index per stock locate, so each sees ~1/symbols of the
+ *              refs; shows how PagedOrderMap degrades to its hash fallback
+ * For each backend: ns per operation over the whole day, then a second day
+ * with every operation timed for the tail (growth stalls show up there; on a
+ * noisy host the max also catches preemption). OrderMap's identity hash turns
+ * the dense feed-wide refs into long clusters, so expect that row to be slow.
+ *
+ * Usage: bench_paged_index [messages] [symbols] [live_per_symbol]
+ */
+
+#include "bench_common.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+struct IndexOp {
+    enum Kind : std::uint8_t { Find, Put, Extract, Replace } kind;
+    itch::StockLocate locate;
+    itch::OrderId ref;
+    itch::OrderId new_ref;      // Replace only
+};
+
+std::vector<IndexOp> decode(const bench::Workload& day) {
+    using namespace itch::endian;
+    std::vector<IndexOp> ops;
+    ops.reserve(day.message_count());
+    std::vector<itch::Quantity> remaining;      // By ref; refs are dense from 1
+    auto track = [&](itch::OrderId ref, itch::Quantity qty) {
+        if (ref >= remaining.size()) remaining.resize(ref * 2 + 1);
+        remaining[ref] = qty;
+    };
+    for (std::size_t i = 0; i < day.message_count(); ++i) {
+        const char* msg = day.message(i);
+        switch (msg[0]) {
+            case 'A': {
+                const auto& m = *reinterpret_cast<const itch::AddOrderMessage*>(msg);
+                const itch::OrderId ref = be64_to_host(m.order_ref_number);
+                track(ref, be32_to_host(m.shares));
+                ops.push_back({IndexOp::Put, be16_to_host(m.stock_locate), ref, 0});
+                break;
+            }
+            case 'E':
+            case 'X': {
+                // Executed and cancelled shares sit at the same offset
+                const auto& m = *reinterpret_cast<const itch::OrderCancelMessage*>(msg);
+                const itch::OrderId ref = be64_to_host(m.order_ref_number);
+                remaining[ref] -= be32_to_host(m.cancelled_shares);
+                ops.push_back({remaining[ref] == 0 ? IndexOp::Extract : IndexOp::Find,
+                               be16_to_host(m.stock_locate), ref, 0});
+                break;
+            }
+            case 'D': {
+                const auto& m = *reinterpret_cast<const itch::OrderDeleteMessage*>(msg);
+                ops.push_back({IndexOp::Extract, be16_to_host(m.stock_locate),
+                               be64_to_host(m.order_ref_number), 0});
+                break;
+            }
+            case 'U': {
+                const auto& m = *reinterpret_cast<const itch::OrderReplaceMessage*>(msg);
+                const itch::OrderId new_ref = be64_to_host(m.new_order_ref_number);
+                track(new_ref, be32_to_host(m.shares));
+                ops.push_back({IndexOp::Replace, be16_to_host(m.stock_locate),
+                               be64_to_host(m.original_order_ref_number), new_ref});
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return ops;
+}
+
+itch::Order* fake_order(itch::OrderId id) {
+    // Never dereferenced; only carried through the index
+    return reinterpret_cast<itch::Order*>(static_cast<std::uintptr_t>(id) << 6);
+}
+
+template<typename Index>
+ITCH_FORCE_INLINE std::uint64_t apply(Index& index, const IndexOp& op) {
+    switch (op.kind) {
+        case IndexOp::Find:
+            return reinterpret_cast<std::uintptr_t>(index.find(op.ref));
+        case IndexOp::Put:
+            index.put(op.ref, fake_order(op.ref));
+            return 0;
+        case IndexOp::Extract:
+            return reinterpret_cast<std::uintptr_t>(index.extract(op.ref));
+        case IndexOp::Replace:
+            index.insert(op.new_ref, index.extract(op.ref));
+            return 0;
+    }
+    return 0;
+}
+
+struct Result {
+    double ns = 0;
+    std::uint64_t p999_ns = 0;
+    std::uint64_t max_ns = 0;
+    std::string note;
+};
+
+template<typename Index>
+std::vector<std::unique_ptr<Index>> make_indexes(std::size_t count) {
+    std::vector<std::unique_ptr<Index>> indexes;
+    for (std::size_t i = 0; i < count; ++i) indexes.push_back(std::make_unique<Index>());
+    return indexes;
+}
+
+template<typename Index>
+Result run(const std::vector<IndexOp>& ops, bool per_book, std::size_t symbols,
+           std::uint64_t& sink) {
+    Result r;
+    {
+        auto indexes = make_indexes<Index>(per_book ? symbols + 1 : 1);
+        r.ns = bench::time_ns([&] {
+            for (const IndexOp& op : ops) {
+                sink += apply(*indexes[per_book ? op.locate : 0], op);
+            }
+        }) / static_cast<double>(ops.size());
+
+        if constexpr (std::is_same_v<Index, itch::PagedOrderMap>) {
+            std::size_t live = 0, fallback = 0, pages = 0;
+            for (const auto& index : indexes) {
+                live += index->size();
+                fallback += index->fallback_size();
+                pages += index->pages_in_use();
+            }
+            r.note = std::to_string(pages) + " pages, " +
+                     std::to_string(live ? 100 * fallback / live : 0) + "% of live refs hashed";
+        }
+    }
+    // Second day on fresh indexes, timing each operation for the tail
+    auto indexes = make_indexes<Index>(per_book ? symbols + 1 : 1);
+    std::vector<std::uint64_t> latency(ops.size());
+    for (std::size_t i = 0; i < ops.size(); ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        sink += apply(*indexes[per_book ? ops[i].locate : 0], ops[i]);
+        const auto end = std::chrono::steady_clock::now();
+        latency[i] = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    r.p999_ns = bench::percentile(latency, 0.999);
+    r.max_ns = *std::max_element(latency.begin(), latency.end());
+    return r;
+}
+
+void report(const char* name, const Result& r) {
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << r.ns << std::setw(12) << r.p999_ns
+              << std::setw(12) << r.max_ns << (r.note.empty() ? "" : "   " + r.note) << "\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const std::size_t num_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100;
+    const std::size_t live_per_symbol = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 5000;
+
+    bench::print_header("Paged Order Index Benchmark");
+    bench::WorkloadGenerator gen(42, num_symbols, live_per_symbol);
+    const std::vector<IndexOp> ops = decode(gen.generate(num_messages));
+    std::cout << "Index operations: " << ops.size() << ", symbols: " << num_symbols
+              << ", live orders at close: " << gen.live_orders() << "\n"
+              << "Page: " << itch::PagedOrderMap::PAGE_SLOTS << " slots\n";
+
+    std::uint64_t sink = 0;
+    for (const bool per_book : {false, true}) {
+        std::cout << "\n" << (per_book ? "Per-book indexes" : "Feed-wide index") << "\n"
+                  << std::left << std::setw(16) << "Backend" << std::right << std::setw(10)
+                  << "ns/op" << std::setw(12) << "p99.9 ns" << std::setw(12) << "max ns\n";
+        report("OrderMap", run<itch::OrderMap>(ops, per_book, num_symbols, sink));
+        report("SwissOrderMap", run<itch::SwissOrderMap>(ops, per_book, num_symbols, sink));
+        report("PagedOrderMap", run<itch::PagedOrderMap>(ops, per_book, num_symbols, sink));
+    }
+    std::cout << "\nChecksum: " << sink << "\n";
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file bench_parallel_replay.cpp
+ * @brief Wall-clock file replay: serial process_file() vs. ParallelReplay
+ *
+ * Writes a synthetic day file, replays it once with FeedHandler::process_file
+ * and then with ParallelReplay at 1, 2, 4, ... threads, checking that every
+ * run ends with the same books. For multi-GB numbers pass a large message
+ * count (about 30 bytes per message).
+ *
+ * Usage: bench_parallel_replay [messages] [symbols] [max_threads]
+ */
+
+#include "bench_common.hpp"
+#include "../include/parallel_replay.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const std::size_t num_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500;
+    const std::size_t hw = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    const std::size_t max_threads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : hw;
+    const char* day_path = "bench_parallel_day.itch";
+
+    bench::print_header("Parallel Replay Benchmark");
+
+    std::size_t file_bytes = 0;
+    {
+        bench::WorkloadGenerator gen(42, num_symbols, 500);
+        const auto directory = gen.directory();
+        const auto workload = gen.generate(num_messages);
+        std::ofstream out(day_path, std::ios::binary);
+        out.write(directory.data.data(), static_cast<std::streamsize>(directory.data.size()));
+        out.write(workload.data.data(), static_cast<std::streamsize>(workload.data.size()));
+        file_bytes = directory.data.size() + workload.data.size();
+    }
+
+    // Warm the page cache so both modes read from memory
+    {
+        itch::MemoryMappedFile warm;
+        warm.open(day_path);
+        volatile std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < warm.size(); i += 4096) {
+            sum = sum + static_cast<unsigned char>(warm.data()[i]);
+        }
+    }
+
+    // Keep only a summary of the serial books so two full book sets never coexist
+    struct BookSummary {
+        itch::StockLocate locate;
+        std::size_t orders;
+        itch::Price bid, ask;
+    };
+    std::vector<BookSummary> expected;
+    std::size_t expected_orders = 0;
+    std::uint64_t serial_messages = 0;
+    double serial_ns = 0.0;
+    {
+        auto serial = std::make_unique<itch::FeedHandler>();
+        serial_ns = bench::time_ns([&] { serial->process_file(day_path); });
+        serial_messages = serial->position().sequence;
+        expected_orders = serial->book_manager().total_order_count();
+        serial->book_manager().for_each_book([&](const itch::OrderBook& book) {
+            expected.push_back({book.stock_locate(), book.order_count(),
+                                book.bbo().bid_price, book.bbo().ask_price});
+        });
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "File: " << (static_cast<double>(file_bytes) / 1e6) << " MB, "
+              << serial_messages << " messages, hardware threads: " << hw << "\n\n";
+    std::cout << std::left << std::setw(12) << "Mode" << std::right << std::setw(12) << "Wall ms"
+              << std::setw(14) << "M msgs/s" << std::setw(10) << "Speedup" << std::setw(10)
+              << "Resyncs" << std::setw(8) << "Match\n";
+    std::cout << std::left << std::setw(12) << "serial" << std::right << std::setw(12)
+              << (serial_ns / 1e6) << std::setw(14)
+              << (static_cast<double>(serial_messages) / (serial_ns / 1e3))
+              << std::setw(9) << 1.0 << "x" << std::setw(10) << "-" << std::setw(8) << "-" << "\n";
+
+    bool all_match = true;
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        itch::ParallelReplay parallel(threads);
+        const double ns = bench::time_ns([&] { parallel.process_file(day_path); });
+
+        bool match = parallel.total_order_count() == expected_orders;
+        for (const BookSummary& book : expected) {
+            const itch::OrderBook* other = parallel.find_book(book.locate);
+            match = match && other && other->order_count() == book.orders &&
+                    other->bbo().bid_price == book.bid && other->bbo().ask_price == book.ask;
+        }
+        all_match = all_match && match;
+
+        std::cout << std::left << std::setw(12) << (std::to_string(threads) + " threads")
+                  << std::right << std::setw(12) << (ns / 1e6) << std::setw(14)
+                  << (static_cast<double>(parallel.stats().messages) / (ns / 1e3))
+                  << std::setw(9) << (serial_ns / ns) << "x" << std::setw(10)
+                  << parallel.stats().resyncs << std::setw(8) << (match ? "yes" : "NO") << "\n";
+    }
+
+    std::remove(day_path);
+    return all_match ? 0 : 1;
+}
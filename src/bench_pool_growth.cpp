@@ -0,0 +1,93 @@
+/**
+ * @file bench_pool_growth.cpp
+ * @brief add_order tail latency across ObjectPool growth, per pool mode
+ *
+ * Adds N orders to one book whose order index is presized (so only pool
+ * growth shows), timing every call, with the pool in each growth mode:
+ * - inline:      default; a new block is allocated inside acquire()
+ * - background:  enable_background_refill(); a helper thread prepares and
+ *                prefaults blocks below the low watermark
+ * - hard cap:    set_hard_capacity(N); everything preallocated up front
+ * An optional gap between adds (busy-wait, ns) models feed inter-arrival
+ * time, which is when the helper gets to run on a loaded core.
+ *
+ * Usage: bench_pool_growth [orders] [gap_ns]
+ */
+
+#include "bench_common.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+enum class Mode { Inline, Background, HardCap };
+
+struct Result {
+    std::vector<std::uint64_t> latency;
+    std::size_t blocks = 0;
+    std::size_t inline_blocks = 0;
+};
+
+Result run(Mode mode, std::size_t count, std::uint64_t gap_ns) {
+    itch::ObjectPool<itch::Order> pool;
+    if (mode == Mode::Background) pool.enable_background_refill();
+    if (mode == Mode::HardCap) pool.set_hard_capacity(count);
+    auto book = std::make_unique<itch::OrderBook>(1, count * 2);
+
+    Result r;
+    r.latency.resize(count);
+    std::mt19937_64 rng(9);
+    for (std::size_t i = 0; i < count; ++i) {
+        const bool buy = i % 2 == 0;
+        const itch::Price offset = static_cast<itch::Price>(rng() % 200) * 100;
+        const auto start = std::chrono::steady_clock::now();
+        book->add_order(i + 1, buy ? itch::Side::Buy : itch::Side::Sell,
+                        buy ? 1000000 - offset : 1000100 + offset, 100, 0, pool);
+        const auto end = std::chrono::steady_clock::now();
+        r.latency[i] = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        if (gap_ns) {
+            const auto until = end + std::chrono::nanoseconds(gap_ns);
+            while (std::chrono::steady_clock::now() < until) {}
+        }
+    }
+    r.blocks = pool.capacity() / 4096;
+    r.inline_blocks = pool.inline_blocks();
+    return r;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    const std::uint64_t gap_ns = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+
+    bench::print_header("Order Pool Growth Benchmark");
+    std::cout << "Orders added: " << count << ", gap between adds: " << gap_ns << " ns\n\n";
+
+    const std::pair<const char*, Mode> modes[] = {
+        {"inline", Mode::Inline}, {"background", Mode::Background}, {"hard cap", Mode::HardCap}};
+    std::cout << std::left << std::setw(12) << "Mode" << std::right << std::setw(9) << "p50 ns"
+              << std::setw(9) << "p99 ns" << std::setw(11) << "p99.9 ns" << std::setw(12)
+              << "p99.99 ns" << std::setw(12) << "max ns" << std::setw(18) << "inline blocks\n";
+    for (const auto& m : modes) {
+        const Result r = run(m.second, count, gap_ns);
+        std::cout << std::left << std::setw(12) << m.first << std::right << std::setw(9)
+                  << bench::percentile(r.latency, 0.5) << std::setw(9)
+                  << bench::percentile(r.latency, 0.99) << std::setw(11)
+                  << bench::percentile(r.latency, 0.999) << std::setw(12)
+                  << bench::percentile(r.latency, 0.9999) << std::setw(12)
+                  << bench::percentile(r.latency, 1.0) << std::setw(10);
+        if (m.second == Mode::Background) {
+            std::cout << r.inline_blocks << " / " << r.blocks;
+        } else if (m.second == Mode::Inline) {
+            std::cout << r.blocks << " / " << r.blocks;
+        } else {
+            std::cout << "0";
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
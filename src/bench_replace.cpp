@@ -0,0 +1,109 @@
+/**
+ * @file bench_replace.cpp
+ * @brief OrderBook::replace_order in place vs. delete_order + add_order
+ *
+ * Seeds one book with live orders spread over a band of price levels, then
+ * applies the same pre-generated replace sequence both ways for three mixes:
+ * all same-price, all price-changing, and half/half.
+ *
+ * Usage: bench_replace [replaces] [live_orders] [runs]
+ */
+
+#include "bench_common.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+struct ReplaceOp {
+    std::uint32_t slot;         // Index into the live id table
+    itch::Quantity shares;
+    itch::Price price_offset;   // 0 keeps the current price
+};
+
+constexpr itch::Price BASE_PRICE = 1000000;
+constexpr itch::Price TICK = 100;
+constexpr std::size_t BAND = 50;    // Levels per side
+
+std::vector<ReplaceOp> make_ops(std::size_t count, std::size_t live, int same_price_pct) {
+    std::mt19937_64 rng(7);
+    std::vector<ReplaceOp> ops(count);
+    for (auto& op : ops) {
+        op.slot = static_cast<std::uint32_t>(rng() % live);
+        op.shares = static_cast<itch::Quantity>(100 + rng() % 900);
+        op.price_offset = static_cast<int>(rng() % 100) < same_price_pct
+            ? 0 : static_cast<itch::Price>(1 + rng() % BAND) * TICK;
+    }
+    return ops;
+}
+
+template<bool InPlace>
+double run(std::size_t live, const std::vector<ReplaceOp>& ops) {
+    itch::ObjectPool<itch::Order> pool;
+    auto book = std::make_unique<itch::OrderBook>(1, live * 2);
+    std::vector<itch::OrderId> ids(live);
+    std::vector<itch::Side> sides(live);
+    std::mt19937_64 rng(3);
+    for (std::size_t i = 0; i < live; ++i) {
+        ids[i] = i + 1;
+        sides[i] = i % 2 ? itch::Side::Sell : itch::Side::Buy;
+        const itch::Price offset = static_cast<itch::Price>(rng() % BAND) * TICK;
+        book->add_order(ids[i], sides[i], itch::is_buy(sides[i]) ? BASE_PRICE - offset
+                                                                  : BASE_PRICE + TICK + offset,
+                        100, 0, pool);
+    }
+
+    itch::OrderId next_id = live + 1;
+    return bench::time_ns([&] {
+        for (const auto& op : ops) {
+            const itch::OrderId old_id = ids[op.slot];
+            const itch::Order* order = book->get_order(old_id);
+            const itch::Side side = sides[op.slot];
+            itch::Price price = order->price;
+            if (op.price_offset) {
+                price = itch::is_buy(side) ? BASE_PRICE - op.price_offset + TICK
+                                           : BASE_PRICE + op.price_offset;
+            }
+            if (InPlace) {
+                book->replace_order(old_id, next_id, op.shares, price, 1, pool);
+            } else {
+                book->delete_order(old_id, pool);
+                book->add_order(next_id, side, price, op.shares, 1, pool);
+            }
+            ids[op.slot] = next_id++;
+        }
+    }) / static_cast<double>(ops.size());
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_replaces = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    const std::size_t live = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+    const std::size_t runs = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 3;
+
+    bench::print_header("Replace Order Benchmark");
+    std::cout << "Replaces: " << num_replaces << ", live orders: " << live
+              << ", levels/side: " << BAND << "\n\n";
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::left << std::setw(20) << "Mix" << std::right << std::setw(18)
+              << "delete+add ns" << std::setw(14) << "in-place ns" << std::setw(12)
+              << "speedup\n";
+    const std::pair<const char*, int> mixes[] = {
+        {"same price", 100}, {"50/50", 50}, {"price change", 0}};
+    for (const auto& mix : mixes) {
+        const auto ops = make_ops(num_replaces, live, mix.second);
+        double before = 1e30;
+        double after = 1e30;
+        for (std::size_t r = 0; r < runs; ++r) {
+            before = std::min(before, run<false>(live, ops));
+            after = std::min(after, run<true>(live, ops));
+        }
+        std::cout << std::left << std::setw(20) << mix.first << std::right << std::setw(18)
+                  << before << std::setw(14) << after << std::setw(11) << (before / after)
+                  << "x\n";
+    }
+    return 0;
+}
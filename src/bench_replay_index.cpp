@@ -0,0 +1,113 @@
+/**
+ * @file bench_replay_index.cpp
+ * @brief Seek-to-time with a sidecar index + checkpoints vs. full replay
+ *
+ * Writes a synthetic day file, indexes it in one pass and takes a checkpoint
+ * every `checkpoints`-th of the day. Then reconstructs the books as of a few
+ * query times two ways: replaying from byte zero, and loading the latest
+ * checkpoint before the query time and replaying forward to it.
+ *
+ * Usage: bench_replay_index [messages] [symbols] [checkpoints]
+ */
+
+#include "bench_common.hpp"
+#include "../include/checkpoint.hpp"
+#include "../include/replay_index.hpp"
+
+#include <cstdlib>
+#include <fstream>
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const std::size_t num_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    const std::size_t num_checkpoints = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 8;
+    const char* day_path = "bench_replay_day.itch";
+    const std::string index_path = itch::ReplayIndex::sidecar_path(day_path);
+
+    bench::print_header("Replay Index Seek-to-Time Benchmark");
+
+    bench::WorkloadGenerator gen(42, num_symbols, 1000);
+    const auto directory = gen.directory();
+    const auto workload = gen.generate(num_messages);
+    {
+        std::ofstream out(day_path, std::ios::binary);
+        out.write(directory.data.data(), static_cast<std::streamsize>(directory.data.size()));
+        out.write(workload.data.data(), static_cast<std::streamsize>(workload.data.size()));
+    }
+
+    itch::MemoryMappedFile day;
+    day.open(day_path);
+
+    itch::ReplayIndex index;
+    const double build_ns = bench::time_ns([&] { index.build(day.data(), day.size()); });
+    index.save(index_path.c_str());
+    itch::ReplayIndex loaded;
+    const double load_ns = bench::time_ns([&] { loaded.load(index_path.c_str()); });
+
+    // Checkpoints at evenly spaced sample points, as a live session would leave behind
+    std::vector<std::string> checkpoint_paths;
+    std::vector<itch::Timestamp> checkpoint_times;
+    {
+        itch::FeedHandler handler;
+        const auto& entries = loaded.entries();
+        for (std::size_t c = 1; c <= num_checkpoints; ++c) {
+            const itch::ReplayIndexEntry& e = entries[entries.size() * c / (num_checkpoints + 1)];
+            handler.process(day.data() + handler.position().offset,
+                            static_cast<std::size_t>(e.offset - handler.position().offset));
+            checkpoint_paths.push_back("bench_replay." + std::to_string(e.sequence) + ".ckpt");
+            checkpoint_times.push_back(e.timestamp);
+            itch::save_checkpoint(handler, checkpoint_paths.back().c_str());
+        }
+    }
+
+    const itch::Timestamp first = loaded.entries().front().timestamp;
+    const itch::Timestamp last = loaded.entries().back().timestamp;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "File: " << (static_cast<double>(day.size()) / 1e6) << " MB, "
+              << loaded.message_count() << " messages, " << loaded.entries().size()
+              << " samples, " << loaded.directory_offsets().size() << " directory records\n";
+    std::cout << "Index build: " << (build_ns / 1e6) << " ms, load: " << (load_ns / 1e6)
+              << " ms\n\n";
+    std::cout << std::left << std::setw(14) << "Query" << std::right << std::setw(16)
+              << "Full replay ms" << std::setw(16) << "Seek ms" << std::setw(10) << "Speedup"
+              << std::setw(10) << "Match\n";
+
+    bool all_match = true;
+    for (int q = 1; q <= 4; ++q) {
+        const itch::Timestamp t = first + (last - first) * static_cast<itch::Timestamp>(2 * q - 1) / 8;
+
+        itch::FeedHandler full;
+        const double full_ns = bench::time_ns([&] {
+            full.process(day.data(),
+                         static_cast<std::size_t>(loaded.locate(day.data(), day.size(), t + 1).offset));
+        });
+
+        itch::FeedHandler seeked;
+        const double seek_ns = bench::time_ns([&] {
+            std::size_t best = checkpoint_times.size();
+            for (std::size_t c = 0; c < checkpoint_times.size(); ++c) {
+                if (checkpoint_times[c] <= t) best = c;
+            }
+            if (best < checkpoint_times.size()) {
+                itch::load_checkpoint(seeked, checkpoint_paths[best].c_str());
+            }
+            itch::replay_until(seeked, day.data(), day.size(), loaded, t);
+        });
+
+        const bool match = full.position().sequence == seeked.position().sequence &&
+            full.book_manager().total_order_count() == seeked.book_manager().total_order_count();
+        all_match = all_match && match;
+        std::cout << std::left << std::setw(14) << (std::to_string(q * 25 - 12) + "% of day")
+                  << std::right << std::setw(16) << (full_ns / 1e6) << std::setw(16)
+                  << (seek_ns / 1e6) << std::setw(9) << (full_ns / seek_ns) << "x"
+                  << std::setw(9) << (match ? "yes" : "NO") << "\n";
+    }
+
+    std::remove(day_path);
+    std::remove(index_path.c_str());
+    for (const auto& path : checkpoint_paths) {
+        std::remove(path.c_str());
+    }
+    return all_match ? 0 : 1;
+}
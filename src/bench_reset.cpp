@@ -0,0 +1,97 @@
+/**
+ * @file bench_reset.cpp
+ * @brief FeedHandler::reset() and total_order_count() cost vs. the number of active books
+ *
+ * For each active-book count, a fresh handler gets that many books (spread
+ * over the locate range) holding a few resting orders each, then is reset
+ * several times, refilled between resets. Reported per count:
+ * - reset:   median reset() time (visits only the active books, and each
+ *            book drops its few index keys instead of wiping the index)
+ * - count:   median total_order_count() time
+ * - RSS:     resident growth across the resets; wiping the default-sized
+ *            index of every book would fault all of its pages in
+ * The last column estimates what wiping every active book's index would
+ * cost, from one timed wipe of a default-capacity OrderMap.
+ *
+ * Usage: bench_reset [orders_per_book] [rounds]
+ */
+
+#include "bench_common.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+void fill(itch::FeedHandler& handler, std::size_t books, std::size_t orders_per_book,
+          itch::OrderId& next_ref) {
+    auto& manager = handler.book_manager();
+    const std::size_t stride = itch::OrderBookManager::MAX_SYMBOLS / books;
+    for (std::size_t b = 0; b < books; ++b) {
+        const auto locate = static_cast<itch::StockLocate>(1 + b * stride);
+        auto& book = manager.get_book(locate);
+        for (std::size_t i = 0; i < orders_per_book; ++i) {
+            const bool buy = i % 2 == 0;
+            book.add_order(next_ref++, buy ? itch::Side::Buy : itch::Side::Sell,
+                           buy ? 1000000 - static_cast<itch::Price>(i) * 100
+                               : 1010000 + static_cast<itch::Price>(i) * 100,
+                           100, 0, manager.order_pool());
+        }
+    }
+}
+
+double median(std::vector<double> samples) {
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(samples.size() / 2),
+                     samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t orders_per_book = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    const std::size_t rounds = argc > 2 ? std::max<std::size_t>(1, std::strtoull(argv[2], nullptr, 10)) : 5;
+
+    bench::print_header("Reset / Active-Book Iteration Benchmark");
+
+    double wipe_ns = 0;
+    {
+        itch::OrderMap index;       // Default book index capacity
+        index.clear();              // Fault its pages in first
+        wipe_ns = bench::time_ns([&] { index.clear(); });
+    }
+    std::cout << "Orders per book: " << orders_per_book << ", rounds: " << rounds
+              << ", book slots: " << itch::OrderBookManager::MAX_SYMBOLS << "\n"
+              << "Default OrderMap wipe: " << std::fixed << std::setprecision(1)
+              << wipe_ns / 1e3 << " us\n\n"
+              << std::right << std::setw(8) << "books" << std::setw(14) << "reset us"
+              << std::setw(14) << "count ns" << std::setw(12) << "RSS +MiB"
+              << std::setw(18) << "wipe-all est us\n";
+
+    std::uint64_t sink = 0;
+    for (const std::size_t books : {1, 10, 100, 1000, 8000}) {
+        auto handler = std::make_unique<itch::FeedHandler>();
+        handler->book_manager().presize(books * orders_per_book, 0);
+        itch::OrderId next_ref = 1;
+        fill(*handler, books, orders_per_book, next_ref);
+
+        std::vector<double> reset_ns, count_ns;
+        const std::size_t rss_before = bench::rss_kib();
+        for (std::size_t r = 0; r < rounds; ++r) {
+            count_ns.push_back(bench::time_ns([&] {
+                sink += handler->book_manager().total_order_count();
+            }));
+            reset_ns.push_back(bench::time_ns([&] { handler->reset(); }));
+            fill(*handler, books, orders_per_book, next_ref);
+        }
+        const std::size_t rss_after = bench::rss_kib();
+
+        std::cout << std::setw(8) << books << std::fixed << std::setprecision(1)
+                  << std::setw(14) << median(reset_ns) / 1e3 << std::setw(14)
+                  << median(count_ns) << std::setw(12)
+                  << (static_cast<double>(rss_after) - static_cast<double>(rss_before)) / 1024.0
+                  << std::setw(17) << static_cast<double>(books) * wipe_ns / 1e3 << "\n";
+    }
+    std::cout << "\nChecksum: " << sink << "\n";
+    return 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file bench_sizing_profile.cpp
+ * @brief Growth events during a replay, cold vs. warm-started from yesterday's sizing profile
+ *
+ * Day 1 (seed 42) is replayed on a fresh handler and its end-of-day sizing
+ * profile saved. Day 2 (seed 43, same symbols and population) is then
+ * replayed twice, message by message:
+ * - cold: default sizing, so the order pool and the busy books' order
+ *         indexes grow during the opening build-up
+ * - warm: warm_start() from day 1's profile before the first message
+ * A growth event is the order pool's capacity or a book's order-index
+ * capacity increasing while a message is processed. Also reported: ns per
+ * message over the opening (first 10% of the day) and p99.9 per message.
+ *
+ * Usage: bench_sizing_profile [messages] [symbols] [live_per_symbol]
+ */
+
+#include "bench_common.hpp"
+#include "../include/sizing_profile.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+bench::Workload make_day(std::uint64_t seed, std::size_t messages, std::size_t symbols,
+                         std::size_t live_per_symbol) {
+    bench::WorkloadGenerator gen(seed, symbols, live_per_symbol);
+    bench::Workload day = gen.directory();
+    const bench::Workload stream = gen.generate(messages);
+    const std::size_t base = day.data.size();
+    day.data.insert(day.data.end(), stream.data.begin(), stream.data.end());
+    for (const std::uint32_t offset : stream.offsets) {
+        day.offsets.push_back(static_cast<std::uint32_t>(base + offset));
+    }
+    return day;
+}
+
+struct Result {
+    std::size_t pool_growths = 0;
+    std::size_t index_growths = 0;
+    double opening_ns = 0;
+    std::uint64_t p999_ns = 0;
+};
+
+Result replay(itch::FeedHandler& handler, const bench::Workload& day) {
+    using namespace itch::endian;
+    const auto& books = handler.book_manager();
+    std::vector<std::size_t> index_capacity(itch::OrderBookManager::MAX_SYMBOLS, 0);
+    books.for_each_book([&](const itch::OrderBook& book) {
+        index_capacity[book.stock_locate()] = book.order_capacity();
+    });
+    std::size_t pool_capacity = books.order_pool().capacity();
+
+    Result r;
+    std::vector<std::uint64_t> latency(day.message_count());
+    const std::size_t opening = day.message_count() / 10;
+    for (std::size_t i = 0; i < day.message_count(); ++i) {
+        const char* msg = day.message(i);
+        latency[i] = static_cast<std::uint64_t>(
+            bench::time_ns([&] { handler.process(msg, day.message_size(i)); }));
+
+        // Every message type starts with type, then the big-endian locate
+        std::uint16_t raw_locate;
+        std::memcpy(&raw_locate, msg + 1, sizeof(raw_locate));
+        const itch::StockLocate locate = be16_to_host(raw_locate);
+        if (const itch::OrderBook* book = books.find_book(locate)) {
+            std::size_t& seen = index_capacity[locate];
+            if (seen != 0 && book->order_capacity() > seen) ++r.index_growths;
+            seen = std::max(seen, book->order_capacity());
+        }
+        if (books.order_pool().capacity() > pool_capacity) {
+            ++r.pool_growths;
+            pool_capacity = books.order_pool().capacity();
+        }
+    }
+    std::uint64_t opening_total = 0;
+    for (std::size_t i = 0; i < opening; ++i) opening_total += latency[i];
+    r.opening_ns = opening ? static_cast<double>(opening_total) / static_cast<double>(opening) : 0;
+    r.p999_ns = bench::percentile(latency, 0.999);
+    return r;
+}
+
+void report(const char* name, const Result& r) {
+    std::cout << std::left << std::setw(8) << name << std::right << std::setw(14)
+              << r.pool_growths << std::setw(15) << r.index_growths << std::fixed
+              << std::setprecision(1) << std::setw(14) << r.opening_ns << std::setw(12)
+              << r.p999_ns << "\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 3000000;
+    const std::size_t num_symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+    const std::size_t live_per_symbol = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 50000;
+    const char* profile_path = "bench_sizing_profile.bin";
+
+    bench::print_header("Warm-Start Sizing Profile Benchmark");
+    const bench::Workload day1 = make_day(42, num_messages, num_symbols, live_per_symbol);
+    const bench::Workload day2 = make_day(43, num_messages, num_symbols, live_per_symbol);
+
+    {
+        auto handler = std::make_unique<itch::FeedHandler>();
+        handler->process(day1.data.data(), day1.data.size());
+        if (!itch::save_sizing_profile(*handler, profile_path)) {
+            std::cerr << "Cannot write " << profile_path << "\n";
+            return 1;
+        }
+    }
+    itch::SizingProfile profile;
+    itch::load_sizing_profile(profile_path, profile);
+    std::size_t max_book = 0;
+    for (const auto& rec : profile.books) max_book = std::max<std::size_t>(max_book, rec.peak_orders);
+    std::cout << "Messages per day: " << day2.message_count() << ", symbols: " << num_symbols
+              << "\nDay-1 profile: peak live " << profile.peak_live_orders << ", "
+              << profile.books.size() << " books, busiest book peak " << max_book << "\n\n"
+              << std::left << std::setw(8) << "Start" << std::right << std::setw(14)
+              << "pool grows" << std::setw(15) << "index grows" << std::setw(14)
+              << "opening ns" << std::setw(12) << "p99.9 ns\n";
+
+    {
+        auto cold = std::make_unique<itch::FeedHandler>();
+        report("cold", replay(*cold, day2));
+    }
+    {
+        auto warm = std::make_unique<itch::FeedHandler>();
+        itch::warm_start(*warm, profile_path);
+        report("warm", replay(*warm, day2));
+    }
+    std::remove(profile_path);
+    return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file bench_startup.cpp
+ * @brief FeedHandler start-up cost: construction, directory, first-message latency, RSS
+ *
+ * Books are allocated lazily, so a fresh handler holds only its pointer
+ * slots and presence bitmap. Measured:
+ * - construction:  median time to build a FeedHandler, and the RSS it adds
+ * - directory:     processing one StockDirectoryMessage per symbol, which
+ *                  allocates each symbol's book ahead of the session
+ * - first message: latency of the first AddOrder for a locate whose book the
+ *                  directory opened vs. one it never named (book allocated on
+ *                  that message), with a second add to the same book for
+ *                  reference
+ *
+ * Usage: bench_startup [symbols] [rounds]
+ */
+
+#include "bench_common.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+itch::AddOrderMessage make_add(itch::StockLocate locate, itch::OrderId id) {
+    itch::AddOrderMessage msg;
+    msg.message_type = 'A';
+    bench::set_be16(msg.stock_locate, locate);
+    bench::set_be16(msg.tracking_number, 0);
+    bench::set_timestamp(msg.timestamp, 34200000000000ULL);
+    bench::set_be64(msg.order_ref_number, id);
+    msg.buy_sell_indicator = 'B';
+    bench::set_be32(msg.shares, 100);
+    std::memset(msg.stock, ' ', 8);
+    bench::set_be32(msg.price, 1500000);
+    return msg;
+}
+
+/// Per-message latency of one add to each locate in [first, first + count)
+std::vector<std::uint64_t> time_adds(itch::FeedHandler& handler, std::size_t first,
+                                     std::size_t count, itch::OrderId& next_ref) {
+    std::vector<std::uint64_t> latency;
+    latency.reserve(count);
+    for (std::size_t l = first; l < first + count; ++l) {
+        const itch::AddOrderMessage msg = make_add(static_cast<itch::StockLocate>(l), next_ref++);
+        latency.push_back(static_cast<std::uint64_t>(bench::time_ns([&] {
+            handler.process(reinterpret_cast<const char*>(&msg), sizeof(msg));
+        })));
+    }
+    return latency;
+}
+
+double mib(std::size_t after_kib, std::size_t before_kib) {
+    return (static_cast<double>(after_kib) - static_cast<double>(before_kib)) / 1024.0;
+}
+
+void report(const char* name, const std::vector<std::uint64_t>& latency) {
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(12)
+              << bench::percentile(latency, 0.5) << std::setw(12)
+              << bench::percentile(latency, 0.99) << "\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t max_symbols = itch::OrderBookManager::MAX_SYMBOLS / 2;
+    const std::size_t symbols = std::min<std::size_t>(
+        max_symbols, argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000);
+    const std::size_t rounds = argc > 2 ? std::max<std::size_t>(1, std::strtoull(argv[2], nullptr, 10)) : 20;
+
+    bench::print_header("FeedHandler Start-up Benchmark");
+    std::cout << "Symbols: " << symbols << " from the directory + " << symbols
+              << " undeclared, book slots: " << itch::OrderBookManager::MAX_SYMBOLS << "\n\n";
+
+    // Construction
+    std::vector<std::uint64_t> construct_ns;
+    for (std::size_t r = 0; r < rounds; ++r) {
+        std::unique_ptr<itch::FeedHandler> handler;
+        construct_ns.push_back(static_cast<std::uint64_t>(
+            bench::time_ns([&] { handler = std::make_unique<itch::FeedHandler>(); })));
+    }
+    const std::size_t rss_start = bench::rss_kib();
+    auto handler = std::make_unique<itch::FeedHandler>();
+    const std::size_t rss_constructed = bench::rss_kib();
+
+    // Directory: locates 1..symbols
+    bench::WorkloadGenerator gen(42, symbols, 1);
+    const bench::Workload directory = gen.directory();
+    const double directory_ns = bench::time_ns([&] {
+        handler->process(directory.data.data(), directory.data.size());
+    });
+    const std::size_t rss_directory = bench::rss_kib();
+
+    const double construct_us = static_cast<double>(bench::percentile(construct_ns, 0.5)) / 1e3;
+    std::cout << std::fixed << std::setprecision(1)
+              << "Construction:  " << std::setw(10) << construct_us
+              << " us median   RSS +" << mib(rss_constructed, rss_start) << " MiB\n"
+              << "Directory:     " << std::setw(10) << directory_ns / 1e3 << " us total     RSS +"
+              << mib(rss_directory, rss_constructed) << " MiB ("
+              << handler->book_manager().active_book_count() << " books)\n\n"
+              << std::left << std::setw(28) << "First message" << std::right << std::setw(12)
+              << "p50 ns" << std::setw(12) << "p99 ns\n";
+
+    itch::OrderId next_ref = 1;
+    report("add, book from directory", time_adds(*handler, 1, symbols, next_ref));
+    report("add, book opened by it", time_adds(*handler, symbols + 1, symbols, next_ref));
+    report("second add, same book", time_adds(*handler, 1, symbols, next_ref));
+    const std::size_t rss_end = bench::rss_kib();
+
+    std::cout << "\nRSS after first orders: +" << mib(rss_end, rss_start) << " MiB, "
+              << handler->book_manager().active_book_count() << " books, "
+              << handler->book_manager().total_order_count() << " orders\n";
+    return 0;
+}
@@ -0,0 +1,439 @@
+/**
+ * @file bench_suite.cpp
+ * @brief Named end-to-end FeedHandler scenarios with JSON output and baseline comparison
+ *
+ * Scenarios (all deterministic for a given --seed):
+ * - add_only:      adds into empty books, the workload itch_benchmark measures
+ * - mixed:         steady-state add/execute/cancel/delete/replace mix (--mix)
+ * - cancel_storm:  steady traffic interrupted by bursts that cancel and delete
+ *                  half of the resting orders, each followed by a rebuild
+ * - replace_heavy: market makers re-quoting near the touch, half replaces
+ * - opening_cross: pre-open build-up with NOII rounds, a cross per symbol,
+ *                  the execution burst that follows, then continuous trading
+ * - deep_book:     a few symbols with tens of thousands of resting orders
+ *                  spread over thousands of levels
+ *
+ * Every run starts from a reset handler that has processed the stock
+ * directory. --warmup runs are untimed; each of the --runs timed runs then
+ * measures throughput over the whole stream in one process() call, and
+ * per-message latency in a second pass that times every message.
+ *
+ * Usage: bench_suite [--scenario a,b,...] [--messages N] [--seed S]
+ *                    [--mix add,execute,cancel,delete,replace] [--warmup W]
+ *                    [--runs R] [--json FILE|-] [--baseline FILE]
+ *                    [--threshold PCT] [--list]
+ *
+ * With --baseline (a --json file from an earlier run) it prints the change in
+ * median throughput and p50/p99 latency per scenario and exits with status 1
+ * if any moves the wrong way by more than --threshold percent (default 10).
+ */
+
+#include "bench_common.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+
+namespace {
+
+struct Options {
+    std::vector<std::string> scenarios;
+    std::size_t messages = 1000000;
+    std::uint64_t seed = 42;
+    bench::WorkloadMix mix;
+    std::size_t warmup = 1;
+    std::size_t runs = 5;
+    std::string json;
+    std::string baseline;
+    double threshold = 10.0;
+};
+
+/// Directory plus the message stream of one scenario
+struct Scenario {
+    bench::Workload directory;
+    bench::Workload stream;
+};
+
+/// Generate `count` messages with `mix` and append them to `s`
+void phase(bench::WorkloadGenerator& gen, Scenario& s, const bench::WorkloadMix& mix,
+           std::size_t count) {
+    gen.set_mix(mix);
+    s.stream.append(gen.generate(count));
+}
+
+Scenario add_only(const Options& opt) {
+    bench::WorkloadGenerator gen(opt.seed, 100, 1000);
+    Scenario s{gen.directory(), {}};
+    phase(gen, s, {1, 0, 0, 0, 0}, opt.messages);
+    return s;
+}
+
+Scenario mixed(const Options& opt) {
+    bench::WorkloadGenerator gen(opt.seed, 100, 1000);
+    Scenario s{gen.directory(), {}};
+    phase(gen, s, opt.mix, opt.messages);
+    return s;
+}
+
+Scenario cancel_storm(const Options& opt) {
+    constexpr std::size_t CYCLES = 5;
+    bench::WorkloadGenerator gen(opt.seed, 100, 1000);
+    Scenario s{gen.directory(), {}};
+    const std::size_t cycle = opt.messages / CYCLES;
+    for (std::size_t c = 0; c < CYCLES; ++c) {
+        phase(gen, s, {}, cycle * 6 / 10);
+        phase(gen, s, {2, 0, 8, 90, 0}, cycle * 2 / 10);     // Storm
+        phase(gen, s, {80, 5, 5, 10, 0}, cycle - cycle * 8 / 10);
+    }
+    return s;
+}
+
+Scenario replace_heavy(const Options& opt) {
+    bench::WorkloadGenerator gen(opt.seed, 100, 200);
+    gen.set_price_band(5);
+    Scenario s{gen.directory(), {}};
+    phase(gen, s, {20, 5, 5, 20, 50}, opt.messages);
+    return s;
+}
+
+Scenario opening_cross(const Options& opt) {
+    constexpr std::size_t NOII_ROUNDS = 10;
+    bench::WorkloadGenerator gen(opt.seed, 100, 2000);
+    Scenario s{gen.directory(), {}};
+    const std::size_t pre_open = opt.messages * 3 / 10;
+    for (std::size_t r = 0; r < NOII_ROUNDS; ++r) {
+        phase(gen, s, {85, 0, 5, 0, 10}, pre_open / NOII_ROUNDS);
+        s.stream.append(gen.imbalances('O'));
+    }
+    s.stream.append(gen.crosses('O'));
+    phase(gen, s, {5, 70, 0, 25, 0}, opt.messages / 5);     // Execution burst
+    const std::size_t done = s.stream.message_count();
+    phase(gen, s, {}, opt.messages > done ? opt.messages - done : 0);
+    return s;
+}
+
+Scenario deep_book(const Options& opt) {
+    bench::WorkloadGenerator gen(opt.seed, 4, 25000);
+    gen.set_price_band(2000);
+    Scenario s{gen.directory(), {}};
+    phase(gen, s, opt.mix, opt.messages);
+    return s;
+}
+
+struct ScenarioDef {
+    const char* name;
+    Scenario (*build)(const Options&);
+};
+
+constexpr ScenarioDef SCENARIOS[] = {
+    {"add_only", add_only},           {"mixed", mixed},
+    {"cancel_storm", cancel_storm},   {"replace_heavy", replace_heavy},
+    {"opening_cross", opening_cross}, {"deep_book", deep_book},
+};
+
+// =============================================================================
+// Measurement
+// =============================================================================
+
+struct Result {
+    std::string name;
+    std::size_t messages = 0;
+    std::vector<double> mps;                // Throughput per run, M msgs/s
+    std::vector<std::uint64_t> latency;     // ns per message, all runs
+    double mps_median = 0, mps_min = 0, mps_max = 0;
+    double latency_mean = 0;
+    std::uint64_t p50 = 0, p90 = 0, p99 = 0, p999 = 0, latency_max = 0;
+};
+
+void start_run(itch::FeedHandler& handler, const Scenario& s) {
+    handler.reset();
+    handler.process(s.directory.data.data(), s.directory.data.size());
+}
+
+Result measure(const char* name, const Scenario& s, const Options& opt) {
+    auto handler = std::make_unique<itch::FeedHandler>();
+    const bench::Workload& w = s.stream;
+    for (std::size_t i = 0; i < opt.warmup; ++i) {
+        start_run(*handler, s);
+        handler->process(w.data.data(), w.data.size());
+    }
+
+    Result r;
+    r.name = name;
+    r.messages = w.message_count();
+    r.latency.reserve(w.message_count() * opt.runs);
+    for (std::size_t run = 0; run < opt.runs; ++run) {
+        start_run(*handler, s);
+        const double ns = bench::time_ns([&] { handler->process(w.data.data(), w.data.size()); });
+        r.mps.push_back(static_cast<double>(w.message_count()) / ns * 1e3);
+
+        start_run(*handler, s);
+        for (std::size_t i = 0; i < w.message_count(); ++i) {
+            const char* msg = w.message(i);
+            const std::size_t size = w.message_size(i);
+            r.latency.push_back(static_cast<std::uint64_t>(
+                bench::time_ns([&] { handler->process(msg, size); })));
+        }
+    }
+
+    std::vector<double> sorted = r.mps;
+    std::sort(sorted.begin(), sorted.end());
+    r.mps_min = sorted.front();
+    r.mps_max = sorted.back();
+    r.mps_median = sorted[sorted.size() / 2];
+    std::uint64_t total = 0;
+    for (const std::uint64_t ns : r.latency) total += ns;
+    r.latency_mean = static_cast<double>(total) / static_cast<double>(r.latency.size());
+    std::sort(r.latency.begin(), r.latency.end());
+    const auto rank = [&](double p) {
+        return r.latency[std::min(r.latency.size() - 1,
+                                  static_cast<std::size_t>(p * static_cast<double>(r.latency.size())))];
+    };
+    r.p50 = rank(0.5);
+    r.p90 = rank(0.9);
+    r.p99 = rank(0.99);
+    r.p999 = rank(0.999);
+    r.latency_max = r.latency.back();
+    return r;
+}
+
+// =============================================================================
+// JSON
+// =============================================================================
+
+const char* order_index_name() {
+#if defined(ITCH_SWISS_ORDER_INDEX)
+    return "swiss";
+#elif defined(ITCH_PAGED_ORDER_INDEX)
+    return "paged";
+#else
+    return "linear";
+#endif
+}
+
+void write_json(std::ostream& out, const Options& opt, const std::vector<Result>& results) {
+    out << std::fixed << std::setprecision(3) << "{\n"
+        << "  \"suite\": \"bench_suite\",\n"
+        << "  \"seed\": " << opt.seed << ",\n"
+        << "  \"messages\": " << opt.messages << ",\n"
+        << "  \"warmup\": " << opt.warmup << ",\n"
+        << "  \"runs\": " << opt.runs << ",\n"
+        << "  \"order_index\": \"" << order_index_name() << "\",\n"
+        << "  \"mix\": {\"add\": " << opt.mix.add << ", \"execute\": " << opt.mix.execute
+        << ", \"cancel\": " << opt.mix.cancel << ", \"delete\": " << opt.mix.remove
+        << ", \"replace\": " << opt.mix.replace << "},\n"
+        << "  \"scenarios\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\n"
+            << "      \"name\": \"" << r.name << "\",\n"
+            << "      \"messages\": " << r.messages << ",\n"
+            << "      \"throughput_mps\": {\"median\": " << r.mps_median << ", \"min\": "
+            << r.mps_min << ", \"max\": " << r.mps_max << "},\n"
+            << "      \"latency_ns\": {\"mean\": " << r.latency_mean << ", \"p50\": " << r.p50
+            << ", \"p90\": " << r.p90 << ", \"p99\": " << r.p99 << ", \"p999\": " << r.p999
+            << ", \"max\": " << r.latency_max << "}\n"
+            << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+/// Number following `"key":` in `text` at or after `from` (NaN if absent before `to`)
+double json_number(const std::string& text, const char* key, std::size_t from, std::size_t to) {
+    const std::string needle = std::string("\"") + key + "\":";
+    const std::size_t at = text.find(needle, from);
+    if (at == std::string::npos || at >= to) return std::nan("");
+    return std::strtod(text.c_str() + at + needle.size(), nullptr);
+}
+
+struct BaselineEntry {
+    double mps = 0;
+    double p50 = 0;
+    double p99 = 0;
+};
+
+/**
+ * @brief Pull one scenario's figures out of a --json file written by this tool
+ * @return false if the baseline has no such scenario
+ */
+bool find_baseline(const std::string& text, const std::string& name, BaselineEntry& out) {
+    const std::string needle = "\"name\": \"" + name + "\"";
+    const std::size_t at = text.find(needle);
+    if (at == std::string::npos) return false;
+    std::size_t end = text.find("\"name\":", at + needle.size());
+    if (end == std::string::npos) end = text.size();
+    out.mps = json_number(text, "median", at, end);
+    out.p50 = json_number(text, "p50", at, end);
+    out.p99 = json_number(text, "p99", at, end);
+    return !std::isnan(out.mps);
+}
+
+/// Percent change from base to now, signed so that positive is worse
+double regression(double base, double now, bool higher_is_better) {
+    if (!(base > 0)) return 0;
+    const double change = (now - base) / base * 100.0;
+    return higher_is_better ? -change : change;
+}
+
+bool compare(std::ostream& log, const Options& opt, const std::vector<Result>& results) {
+    std::ifstream in(opt.baseline);
+    if (!in) {
+        std::cerr << "Cannot read baseline " << opt.baseline << "\n";
+        return false;
+    }
+    std::stringstream buf;
+    buf << in.rdbuf();
+    const std::string text = buf.str();
+    const std::size_t scenarios_at = text.find("\"scenarios\"");
+    if (json_number(text, "seed", 0, scenarios_at) != static_cast<double>(opt.seed) ||
+        json_number(text, "messages", 0, scenarios_at) != static_cast<double>(opt.messages)) {
+        log << "warning: baseline was recorded with a different --seed or --messages\n";
+    }
+
+    log << "\nBaseline " << opt.baseline << " (threshold " << std::defaultfloat << opt.threshold
+              << "%, positive = worse)\n"
+              << std::left << std::setw(16) << "Scenario" << std::right << std::setw(12)
+              << "Mmsg/s" << std::setw(10) << "p50" << std::setw(10) << "p99" << "\n";
+    bool ok = true;
+    for (const Result& r : results) {
+        BaselineEntry base;
+        log << std::left << std::setw(16) << r.name << std::right;
+        if (!find_baseline(text, r.name, base)) {
+            log << "  (not in baseline)\n";
+            continue;
+        }
+        const double d[] = {regression(base.mps, r.mps_median, true),
+                            regression(base.p50, static_cast<double>(r.p50), false),
+                            regression(base.p99, static_cast<double>(r.p99), false)};
+        bool regressed = false;
+        for (std::size_t k = 0; k < 3; ++k) {
+            log << std::setw(k == 0 ? 11 : 9) << std::showpos << std::fixed
+                << std::setprecision(1) << d[k] << std::noshowpos << "%";
+            regressed |= d[k] > opt.threshold;
+        }
+        log << (regressed ? "   REGRESSION" : "") << "\n";
+        ok &= !regressed;
+    }
+    return ok;
+}
+
+// =============================================================================
+// Command Line
+// =============================================================================
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> out;
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+bool parse_args(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--list") {
+            for (const ScenarioDef& def : SCENARIOS) std::cout << def.name << "\n";
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--scenario") {
+            opt.scenarios = split(value);
+        } else if (arg == "--messages") {
+            opt.messages = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--seed") {
+            opt.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--warmup") {
+            opt.warmup = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--runs") {
+            opt.runs = std::max<std::size_t>(1, std::strtoull(value, nullptr, 10));
+        } else if (arg == "--json") {
+            opt.json = value;
+        } else if (arg == "--baseline") {
+            opt.baseline = value;
+        } else if (arg == "--threshold") {
+            opt.threshold = std::strtod(value, nullptr);
+        } else if (arg == "--mix") {
+            const auto parts = split(value);
+            if (parts.size() != 5) {
+                std::cerr << "--mix takes add,execute,cancel,delete,replace\n";
+                return false;
+            }
+            std::uint32_t w[5];
+            for (std::size_t k = 0; k < 5; ++k) {
+                w[k] = static_cast<std::uint32_t>(std::strtoul(parts[k].c_str(), nullptr, 10));
+            }
+            opt.mix = {w[0], w[1], w[2], w[3], w[4]};
+            if (w[0] + w[1] + w[2] + w[3] + w[4] == 0) {
+                std::cerr << "--mix weights must not all be zero\n";
+                return false;
+            }
+        } else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    if (opt.scenarios.empty()) {
+        for (const ScenarioDef& def : SCENARIOS) opt.scenarios.push_back(def.name);
+    }
+    return true;
+}
+
+const ScenarioDef* find_scenario(const std::string& name) {
+    for (const ScenarioDef& def : SCENARIOS) {
+        if (name == def.name) return &def;
+    }
+    return nullptr;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) return 2;
+    for (const std::string& name : opt.scenarios) {
+        if (!find_scenario(name)) {
+            std::cerr << "Unknown scenario " << name << " (see --list)\n";
+            return 2;
+        }
+    }
+
+    // Keep stdout clean for the JSON document when it goes there
+    std::ostream& log = opt.json == "-" ? std::cerr : std::cout;
+    log << std::string(70, '=') << "\n Benchmark Suite\n" << std::string(70, '=') << "\n"
+        << "Seed: " << opt.seed << ", messages: " << opt.messages << ", warm-up runs: "
+        << opt.warmup << ", timed runs: " << opt.runs << ", order index: "
+        << order_index_name() << "\n\n"
+        << std::left << std::setw(16) << "Scenario" << std::right << std::setw(10) << "msgs"
+        << std::setw(10) << "Mmsg/s" << std::setw(8) << "p50" << std::setw(8) << "p90"
+        << std::setw(8) << "p99" << std::setw(9) << "p99.9" << std::setw(10) << "max"
+        << "   (ns)\n";
+
+    std::vector<Result> results;
+    for (const std::string& name : opt.scenarios) {
+        const Scenario s = find_scenario(name)->build(opt);
+        results.push_back(measure(name.c_str(), s, opt));
+        const Result& r = results.back();
+        log << std::left << std::setw(16) << r.name << std::right << std::setw(10) << r.messages
+            << std::setw(10) << std::fixed << std::setprecision(2) << r.mps_median
+            << std::setw(8) << r.p50 << std::setw(8) << r.p90 << std::setw(8) << r.p99
+            << std::setw(9) << r.p999 << std::setw(10) << r.latency_max << "\n";
+    }
+
+    if (opt.json == "-") {
+        write_json(std::cout, opt, results);
+    } else if (!opt.json.empty()) {
+        std::ofstream out(opt.json);
+        write_json(out, opt, results);
+        log << "\nWrote " << opt.json << "\n";
+    }
+    if (!opt.baseline.empty() && !compare(log, opt, results)) return 1;
+    return 0;
+}
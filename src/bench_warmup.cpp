@@ -0,0 +1,136 @@
+/**
+ * @file bench_warmup.cpp
+ * @brief Latency of the first messages after start-up and after a quiet spell, cold vs. warmed
+ *
+ * Two scenarios, each run `trials` times alternating cold and warm:
+ * - open:  a fresh handler processes the stock directory, other start-up
+ *          work evicts the caches (modelled by streaming a 64 MiB buffer),
+ *          then the first `measure` messages of the session are timed one by
+ *          one. warm calls FeedHandler::warmup() just before the first message.
+ * - idle:  a handler processes `prefix` messages, then sits through a quiet
+ *          spell of IDLE_CHUNKS polling intervals, each preceded by evicting
+ *          a slice of the caches, and the next `measure` messages are timed.
+ *          Both arms poll for the same wall time: cold just spins, warm calls
+ *          idle_warmup() on every empty poll, so neither gets a longer pause
+ *          before the measured messages.
+ * Reported per scenario: mean, p50, p99 and max over the measured messages,
+ * and the mean of the first 100 (where cold misses concentrate).
+ *
+ * Usage: bench_warmup [symbols] [measure] [trials] [prefix]
+ */
+
+#include "bench_common.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+constexpr std::size_t EVICT_BYTES = 64u << 20;
+constexpr std::size_t IDLE_CHUNKS = 64;
+constexpr auto IDLE_POLL = std::chrono::microseconds(200);
+
+std::vector<char> g_evict(EVICT_BYTES, 1);
+volatile std::uint64_t g_sink = 0;
+
+/// Stream [from, to) of the eviction buffer through the caches
+void evict(std::size_t from, std::size_t to) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = from; i < to; i += itch::CACHE_LINE_SIZE) {
+        g_evict[i] = static_cast<char>(g_evict[i] + 1);
+        sum += static_cast<unsigned char>(g_evict[i]);
+    }
+    g_sink = g_sink + sum;
+}
+
+void time_messages(itch::FeedHandler& handler, const bench::Workload& day, std::size_t first,
+                   std::size_t count, std::vector<std::uint64_t>& out) {
+    for (std::size_t i = first; i < first + count && i < day.message_count(); ++i) {
+        const char* msg = day.message(i);
+        const std::size_t size = day.message_size(i);
+        out.push_back(static_cast<std::uint64_t>(bench::time_ns([&] { handler.process(msg, size); })));
+    }
+}
+
+struct Samples {
+    std::vector<std::uint64_t> all;
+    std::vector<std::uint64_t> head;    // First 100 of every trial
+};
+
+void keep(Samples& s, const std::vector<std::uint64_t>& trial) {
+    s.all.insert(s.all.end(), trial.begin(), trial.end());
+    s.head.insert(s.head.end(), trial.begin(), trial.begin() + std::min<std::size_t>(100, trial.size()));
+}
+
+double mean(const std::vector<std::uint64_t>& v) {
+    if (v.empty()) return 0;
+    std::uint64_t total = 0;
+    for (const std::uint64_t x : v) total += x;
+    return static_cast<double>(total) / static_cast<double>(v.size());
+}
+
+void report(const char* name, const Samples& s) {
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << mean(s.all) << std::setw(10)
+              << bench::percentile(s.all, 0.5) << std::setw(10) << bench::percentile(s.all, 0.99)
+              << std::setw(10) << *std::max_element(s.all.begin(), s.all.end()) << std::setw(14)
+              << mean(s.head) << "\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t num_symbols = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100;
+    const std::size_t measure = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    const std::size_t trials = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20;
+    const std::size_t prefix = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 200000;
+
+    bench::print_header("Cache Warming Benchmark");
+    bench::WorkloadGenerator gen(42, num_symbols, 1000);
+    const bench::Workload directory = gen.directory();
+    const bench::Workload day = gen.generate(prefix + measure);
+    std::cout << "Symbols: " << num_symbols << ", measured messages: " << measure
+              << ", trials: " << trials << ", idle prefix: " << prefix << "\n\n"
+              << std::left << std::setw(12) << "Start" << std::right << std::setw(10) << "mean"
+              << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "max"
+              << std::setw(14) << "first-100" << "   (ns per message)\n";
+
+    Samples open_cold, open_warm, idle_cold, idle_warm;
+    std::vector<std::uint64_t> trial;
+    for (std::size_t t = 0; t < 2 * trials; ++t) {
+        const bool warm = (t & 1) != 0;
+        auto handler = std::make_unique<itch::FeedHandler>();
+        handler->process(directory.data.data(), directory.data.size());
+        evict(0, EVICT_BYTES);
+        if (warm) handler->warmup();
+        trial.clear();
+        time_messages(*handler, day, 0, measure, trial);
+        keep(warm ? open_warm : open_cold, trial);
+    }
+    for (std::size_t t = 0; t < 2 * trials; ++t) {
+        const bool warm = (t & 1) != 0;
+        auto handler = std::make_unique<itch::FeedHandler>();
+        handler->process(directory.data.data(), directory.data.size());
+        handler->process(day.data.data(), day.offsets[prefix]);
+        for (std::size_t c = 0; c < IDLE_CHUNKS; ++c) {
+            evict(c * EVICT_BYTES / IDLE_CHUNKS, (c + 1) * EVICT_BYTES / IDLE_CHUNKS);
+            const auto until = std::chrono::steady_clock::now() + IDLE_POLL;
+            while (std::chrono::steady_clock::now() < until) {
+                if (warm) {
+                    handler->idle_warmup();
+                } else {
+                    itch::cpu_relax();
+                }
+            }
+        }
+        trial.clear();
+        time_messages(*handler, day, prefix, measure, trial);
+        keep(warm ? idle_warm : idle_cold, trial);
+    }
+
+    report("open cold", open_cold);
+    report("open warm", open_warm);
+    report("idle cold", idle_cold);
+    report("idle warm", idle_warm);
+    return 0;
+}
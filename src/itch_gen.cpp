@@ -0,0 +1,163 @@
+/**
+ * @file itch_gen.cpp
+ * @brief Write a synthetic full ITCH 5.0 day (see day_generator.hpp) to a file
+ *
+ * Usage: itch_gen --out FILE [--messages N] [--symbols N] [--seed S]
+ *                 [--zipf S] [--halts N] [--noii FRACTION]
+ *                 [--mix add,execute,cancel,delete,replace,trade]
+ *                 [--raw] [--verify] [--null]
+ *
+ * --messages is the continuous order flow (default 100M); session messages
+ * (directory, system events, NOII, crosses, halts) come on top. Output is
+ * BinaryFILE framed unless --raw is given. --verify replays the written file
+ * through a FeedHandler and checks the per-type counts and the resting order
+ * count against the generator's; the handler opens a book per symbol, so this
+ * needs the memory of a full replay. --null generates into a discarding sink to
+ * measure the generator alone.
+ */
+
+#include "../include/day_generator.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+struct Options {
+    itch::DayGeneratorConfig config;
+    std::string out;
+    bool verify = false;
+    bool discard = false;
+};
+
+bool parse_args(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--raw") {
+            opt.config.binary_file = false;
+            continue;
+        }
+        if (arg == "--verify") {
+            opt.verify = true;
+            continue;
+        }
+        if (arg == "--null") {
+            opt.discard = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--out") {
+            opt.out = value;
+        } else if (arg == "--messages") {
+            opt.config.messages = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--symbols") {
+            opt.config.symbols = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--seed") {
+            opt.config.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--zipf") {
+            opt.config.zipf_exponent = std::strtod(value, nullptr);
+        } else if (arg == "--halts") {
+            opt.config.halts = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--noii") {
+            opt.config.noii_fraction = std::strtod(value, nullptr);
+        } else if (arg == "--mix") {
+            std::stringstream in(value);
+            std::string item;
+            std::uint32_t w[6] = {};
+            std::size_t k = 0;
+            while (k < 6 && std::getline(in, item, ',')) {
+                w[k++] = static_cast<std::uint32_t>(std::strtoul(item.c_str(), nullptr, 10));
+            }
+            if (k != 6 || w[0] == 0) {
+                std::cerr << "--mix takes add,execute,cancel,delete,replace,trade with add > 0\n";
+                return false;
+            }
+            opt.config.mix = {w[0], w[1], w[2], w[3], w[4], w[5]};
+        } else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    if (opt.out.empty() && !opt.discard) {
+        std::cerr << "Usage: itch_gen --out FILE [--messages N] [--symbols N] [--seed S] [--zipf S]\n"
+                  << "                [--halts N] [--noii FRACTION] [--mix a,e,c,d,r,t]\n"
+                  << "                [--raw] [--verify] [--null]\n";
+        return false;
+    }
+    if (opt.discard && opt.verify) {
+        std::cerr << "--verify needs a file, not --null\n";
+        return false;
+    }
+    return true;
+}
+
+/// Replay the file and compare what the handler saw with what was generated
+bool verify(const Options& opt, const itch::DayGeneratorStats& stats) {
+    itch::MemoryMappedFile file;
+    if (!file.open(opt.out.c_str())) {
+        std::cerr << "Cannot map " << opt.out << "\n";
+        return false;
+    }
+    auto handler = std::make_unique<itch::FeedHandler>();
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t consumed = opt.config.binary_file
+        ? handler->process_binaryfile(file.data(), file.size())
+        : handler->process(file.data(), file.size());
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const itch::FeedMetrics& m = handler->metrics();
+    const std::uint64_t executed = stats.count('E') + stats.count('C');
+    const bool ok = consumed == file.size() &&
+                    handler->position().sequence == stats.messages &&
+                    m.orders_executed == executed &&
+                    m.orders_cancelled == stats.count('X') &&
+                    m.orders_deleted == stats.count('D') &&
+                    m.orders_replaced == stats.count('U') &&
+                    handler->book_manager().total_order_count() == stats.live_orders;
+    std::cout << "Replayed " << handler->position().sequence << " messages in " << std::fixed
+              << std::setprecision(2) << seconds << " s ("
+              << static_cast<double>(handler->position().sequence) / seconds / 1e6 << "M msgs/s), "
+              << handler->book_manager().total_order_count() << " resting orders: "
+              << (ok ? "OK" : "MISMATCH") << "\n";
+    return ok;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) return 2;
+
+    itch::DayGenerator gen(opt.config);
+    const auto start = std::chrono::steady_clock::now();
+    if (opt.discard) {
+        gen.generate([](const char*, std::size_t) {});
+    } else if (!gen.write_file(opt.out.c_str())) {
+        std::cerr << "Cannot write " << opt.out << "\n";
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const itch::DayGeneratorStats& stats = gen.stats();
+    std::cout << "Generated " << stats.messages << " messages, " << std::fixed << std::setprecision(1)
+              << static_cast<double>(stats.bytes) / (1 << 20) << " MiB in " << std::setprecision(2)
+              << seconds << " s (" << static_cast<double>(stats.messages) / seconds / 1e6 << "M msgs/s, "
+              << static_cast<double>(stats.bytes) / seconds / (1 << 20) << " MiB/s)\n"
+              << "Symbols: " << gen.config().symbols << ", resting at end of day: " << stats.live_orders << "\n";
+    std::cout << "By type:";
+    for (const char type : {'S', 'R', 'H', 'A', 'F', 'E', 'C', 'X', 'D', 'U', 'P', 'Q', 'I'}) {
+        std::cout << " " << type << "=" << stats.count(type);
+    }
+    std::cout << "\n";
+
+    if (opt.verify && !verify(opt, stats)) return 1;
+    return 0;
+}
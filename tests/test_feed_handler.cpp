@@ -0,0 +1,1335 @@
+/**
+ * @file test_feed_handler.cpp
+ * @brief Unit tests for FeedHandler-level features
+ */
+
+// The checks below are asserts; keep them live in Release builds too
+#undef NDEBUG
+
+#include "../include/feed_handler.hpp"
+#include "../include/checkpoint.hpp"
+#include "../include/sizing_profile.hpp"
+#include "../include/warmup.hpp"
+#include "../include/replay_index.hpp"
+#include "../include/parallel_replay.hpp"
+#include "../include/decoded_cache.hpp"
+#include "../include/columnar_export.hpp"
+#include "../include/bar_engine.hpp"
+#include "../include/day_generator.hpp"
+#include <cassert>
+#include <iostream>
+#include <cstddef>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <random>
+
+using namespace itch;
+
+// =============================================================================
+// Test Utilities
+// =============================================================================
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    std::cout << "  " << #name << "... "; \
+    test_##name(); \
+    std::cout << "PASSED\n"; \
+} while(0)
+
+// Helper to set big-endian values
+void set_be16(std::uint16_t& field, std::uint16_t value) {
+    field = endian::be16_to_host(value);
+}
+
+void set_be32(std::uint32_t& field, std::uint32_t value) {
+    field = endian::be32_to_host(value);
+}
+
+void set_be64(std::uint64_t& field, std::uint64_t value) {
+    field = endian::be64_to_host(value);
+}
+
+void set_timestamp(std::uint8_t* ts, Timestamp value) {
+    ts[0] = static_cast<std::uint8_t>((value >> 40) & 0xFF);
+    ts[1] = static_cast<std::uint8_t>((value >> 32) & 0xFF);
+    ts[2] = static_cast<std::uint8_t>((value >> 24) & 0xFF);
+    ts[3] = static_cast<std::uint8_t>((value >> 16) & 0xFF);
+    ts[4] = static_cast<std::uint8_t>((value >> 8) & 0xFF);
+    ts[5] = static_cast<std::uint8_t>(value & 0xFF);
+}
+
+StockDirectoryMessage make_directory(StockLocate locate, const char* symbol) {
+    StockDirectoryMessage msg;
+    std::memset(&msg, ' ', sizeof(msg));
+    msg.message_type = 'R';
+    set_be16(msg.stock_locate, locate);
+    set_be16(msg.tracking_number, 0);
+    set_timestamp(msg.timestamp, 0);
+    std::memcpy(msg.stock, symbol, std::min<std::size_t>(8, std::strlen(symbol)));
+    msg.market_category = 'Q';
+    msg.financial_status = 'N';
+    set_be32(msg.round_lot_size, 100);
+    set_be32(msg.etp_leverage_factor, 0);
+    return msg;
+}
+
+AddOrderMessage make_add(StockLocate locate, OrderId id, char side,
+                         Price price, Quantity qty, Timestamp ts) {
+    AddOrderMessage msg;
+    msg.message_type = 'A';
+    set_be16(msg.stock_locate, locate);
+    set_be16(msg.tracking_number, 0);
+    set_timestamp(msg.timestamp, ts);
+    set_be64(msg.order_ref_number, id);
+    msg.buy_sell_indicator = side;
+    set_be32(msg.shares, qty);
+    std::memset(msg.stock, ' ', 8);
+    set_be32(msg.price, static_cast<std::uint32_t>(price));
+    return msg;
+}
+
+OrderDeleteMessage make_delete(StockLocate locate, OrderId id, Timestamp ts) {
+    OrderDeleteMessage msg;
+    msg.message_type = 'D';
+    set_be16(msg.stock_locate, locate);
+    set_be16(msg.tracking_number, 0);
+    set_timestamp(msg.timestamp, ts);
+    set_be64(msg.order_ref_number, id);
+    return msg;
+}
+
+OrderExecutedMessage make_execute(StockLocate locate, OrderId id, Quantity qty, Timestamp ts) {
+    OrderExecutedMessage msg;
+    msg.message_type = 'E';
+    set_be16(msg.stock_locate, locate);
+    set_be16(msg.tracking_number, 0);
+    set_timestamp(msg.timestamp, ts);
+    set_be64(msg.order_ref_number, id);
+    set_be32(msg.executed_shares, qty);
+    set_be64(msg.match_number, id);
+    return msg;
+}
+
+OrderCancelMessage make_cancel(StockLocate locate, OrderId id, Quantity qty, Timestamp ts) {
+    OrderCancelMessage msg;
+    msg.message_type = 'X';
+    set_be16(msg.stock_locate, locate);
+    set_be16(msg.tracking_number, 0);
+    set_timestamp(msg.timestamp, ts);
+    set_be64(msg.order_ref_number, id);
+    set_be32(msg.cancelled_shares, qty);
+    return msg;
+}
+
+OrderReplaceMessage make_replace(StockLocate locate, OrderId old_id, OrderId new_id,
+                                 Quantity qty, Price price, Timestamp ts) {
+    OrderReplaceMessage msg;
+    msg.message_type = 'U';
+    set_be16(msg.stock_locate, locate);
+    set_be16(msg.tracking_number, 0);
+    set_timestamp(msg.timestamp, ts);
+    set_be64(msg.original_order_ref_number, old_id);
+    set_be64(msg.new_order_ref_number, new_id);
+    set_be32(msg.shares, qty);
+    set_be32(msg.price, static_cast<std::uint32_t>(price));
+    return msg;
+}
+
+OrderExecutedPriceMessage make_execute_price(StockLocate locate, OrderId id, Quantity qty,
+                                             Price price, char printable, Timestamp ts) {
+    OrderExecutedPriceMessage msg;
+    msg.message_type = 'C';
+    set_be16(msg.stock_locate, locate);
+    set_be16(msg.tracking_number, 0);
+    set_timestamp(msg.timestamp, ts);
+    set_be64(msg.order_ref_number, id);
+    set_be32(msg.executed_shares, qty);
+    set_be64(msg.match_number, id);
+    msg.printable = printable;
+    set_be32(msg.execution_price, static_cast<std::uint32_t>(price));
+    return msg;
+}
+
+TradeMessage make_trade(StockLocate locate, std::uint64_t match, Price price, Quantity qty,
+                        Timestamp ts) {
+    TradeMessage msg;
+    msg.message_type = 'P';
+    set_be16(msg.stock_locate, locate);
+    set_be16(msg.tracking_number, 0);
+    set_timestamp(msg.timestamp, ts);
+    set_be64(msg.order_ref_number, 0);
+    msg.buy_sell_indicator = 'B';
+    set_be32(msg.shares, qty);
+    std::memset(msg.stock, ' ', 8);
+    set_be32(msg.price, static_cast<std::uint32_t>(price));
+    set_be64(msg.match_number, match);
+    return msg;
+}
+
+BrokenTradeMessage make_broken(StockLocate locate, std::uint64_t match, Timestamp ts) {
+    BrokenTradeMessage msg;
+    msg.message_type = 'B';
+    set_be16(msg.stock_locate, locate);
+    set_be16(msg.tracking_number, 0);
+    set_timestamp(msg.timestamp, ts);
+    set_be64(msg.match_number, match);
+    return msg;
+}
+
+CrossTradeMessage make_cross(StockLocate locate, std::uint64_t match, Price price,
+                             std::uint64_t qty, char cross_type, Timestamp ts) {
+    CrossTradeMessage msg;
+    msg.message_type = 'Q';
+    set_be16(msg.stock_locate, locate);
+    set_be16(msg.tracking_number, 0);
+    set_timestamp(msg.timestamp, ts);
+    set_be64(msg.shares, qty);
+    std::memset(msg.stock, ' ', 8);
+    set_be32(msg.cross_price, static_cast<std::uint32_t>(price));
+    set_be64(msg.match_number, match);
+    msg.cross_type = cross_type;
+    return msg;
+}
+
+template<typename Msg>
+void process_msg(FeedHandler& handler, const Msg& msg) {
+    handler.process(reinterpret_cast<const char*>(&msg), sizeof(msg));
+}
+
+template<typename Msg>
+void append_msg(std::vector<char>& out, const Msg& msg) {
+    const char* p = reinterpret_cast<const char*>(&msg);
+    out.insert(out.end(), p, p + sizeof(msg));
+}
+
+void process_directory(FeedHandler& handler, StockLocate locate, const char* symbol) {
+    process_msg(handler, make_directory(locate, symbol));
+}
+
+void process_add(FeedHandler& handler, StockLocate locate, OrderId id, char side,
+                 Price price, Quantity qty, Timestamp ts) {
+    process_msg(handler, make_add(locate, id, side, price, qty, ts));
+}
+
+void process_delete(FeedHandler& handler, StockLocate locate, OrderId id, Timestamp ts) {
+    process_msg(handler, make_delete(locate, id, ts));
+}
+
+/// Resident set size in KiB from /proc/self/status (0 where unavailable)
+std::size_t rss_kib() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return std::strtoull(line.c_str() + 6, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+// =============================================================================
+// Book Storage Tests
+// =============================================================================
+
+TEST(directory_opens_books) {
+    FeedHandler handler;
+    const OrderBookManager& books = handler.book_manager();
+    assert(books.active_book_count() == 0);
+
+    // Books are allocated by the directory, before their first order
+    process_directory(handler, 3, "AAPL");
+    assert(books.has_book(3));
+    assert(books.find_book(3)->order_count() == 0);
+    const OrderBook* book = books.find_book(3);
+    process_add(handler, 3, 1, 'B', 1500000, 100, 1000);
+    assert(books.find_book(3) == book);
+    assert(book->order_count() == 1);
+
+    // ...or by the first order for a locate the directory never named
+    process_add(handler, 4, 2, 'S', 1501000, 100, 2000);
+    assert(books.has_book(4));
+
+    // Filtered-out symbols get no book
+    handler.set_symbol_filter({3});
+    process_directory(handler, 5, "MSFT");
+    assert(!books.has_book(5));
+    assert(books.active_book_count() == 2);
+    (void)book;
+}
+
+// =============================================================================
+// BBO Publisher Tests
+// =============================================================================
+
+TEST(bbo_publisher_follows_book) {
+    FeedHandler handler;
+    assert(handler.bbo_publisher() == nullptr);
+    handler.enable_bbo_publishing();
+    const BBOPublisher* publisher = handler.bbo_publisher();
+    assert(publisher != nullptr);
+
+    process_add(handler, 7, 1, 'B', 1500000, 100, 1000);
+    process_add(handler, 7, 2, 'S', 1501000, 200, 2000);
+
+    BBOSnapshot snap = publisher->read(7);
+    assert(snap.bbo.bid_price == 1500000);
+    assert(snap.bbo.bid_quantity == 100);
+    assert(snap.bbo.ask_price == 1501000);
+    assert(snap.bbo.ask_quantity == 200);
+    assert(snap.timestamp == 2000);
+
+    // An order behind the touch does not republish
+    [[maybe_unused]] const std::uint64_t version = snap.version;
+    process_add(handler, 7, 3, 'B', 1490000, 100, 3000);
+    assert(publisher->read(7).version == version);
+
+    process_delete(handler, 7, 1, 4000);
+    snap = publisher->read(7);
+    assert(snap.version != version);
+    assert(snap.bbo.bid_price == 1490000);
+
+    handler.reset();
+    assert(!publisher->read(7).bbo.has_bid());
+}
+
+TEST(bbo_publisher_no_torn_reads) {
+    // Writer keeps ask = bid + 100 and quantities derived from bid; readers
+    // must never observe a mix of two versions.
+    BBOPublisher publisher;
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> torn{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+                const BBOSnapshot snap = publisher.read(42);
+                if (snap.version == 0) continue;
+                const BBO& b = snap.bbo;
+                if (b.ask_price != b.bid_price + 100 ||
+                    b.bid_quantity != static_cast<Quantity>(b.bid_price) ||
+                    b.ask_quantity != static_cast<Quantity>(b.bid_price) + 1 ||
+                    snap.timestamp != static_cast<Timestamp>(b.bid_price)) {
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    for (Price p = 1; p <= 200000; ++p) {
+        BBO bbo;
+        bbo.bid_price = p;
+        bbo.ask_price = p + 100;
+        bbo.bid_quantity = static_cast<Quantity>(p);
+        bbo.ask_quantity = static_cast<Quantity>(p) + 1;
+        publisher.publish(42, bbo, static_cast<Timestamp>(p));
+    }
+    done.store(true);
+    for (auto& t : readers) t.join();
+
+    assert(torn.load() == 0);
+    assert(publisher.read(42).bbo.bid_price == 200000);
+}
+
+// =============================================================================
+// Checkpoint Tests
+// =============================================================================
+
+TEST(checkpoint_round_trip) {
+    const char* path = "test_checkpoint.bin";
+    FeedHandler original;
+    process_directory(original, 1, "AAPL");
+    process_directory(original, 2, "MSFT");
+    process_add(original, 1, 10, 'B', 1500000, 100, 1000);
+    process_add(original, 1, 11, 'B', 1500000, 200, 1001);
+    process_add(original, 1, 12, 'B', 1500000, 300, 1002);
+    process_add(original, 1, 13, 'B', 1490000, 400, 1003);
+    process_add(original, 1, 14, 'S', 1510000, 500, 1004);
+    process_add(original, 2, 20, 'S', 3000000, 600, 1005);
+    process_delete(original, 1, 11, 1006);
+    original.book_manager().get_book(1).cancel_order(10, 40, original.book_manager().order_pool());
+
+    CheckpointInfo saved;
+    [[maybe_unused]] bool ok = save_checkpoint(original, path, &saved);
+    assert(ok);
+    assert(saved.order_count == 5);
+    assert(saved.book_count == 2);
+    assert(saved.position.sequence == 9);
+
+    FeedHandler restored;
+    restored.enable_bbo_publishing();
+    process_add(restored, 5, 99, 'B', 100, 1, 1); // Stale state must be discarded
+    CheckpointInfo loaded;
+    ok = load_checkpoint(restored, path, &loaded);
+    assert(ok);
+    assert(loaded.order_count == 5);
+    assert(restored.position().sequence == original.position().sequence);
+    assert(restored.position().offset == original.position().offset);
+    assert(restored.book_manager().total_order_count() == 5);
+    assert(restored.book_manager().get_book(5).order_count() == 0);
+
+    Symbol msft;
+    std::memcpy(msft.data, "MSFT    ", 8);
+    assert(restored.symbol_directory().get_locate(msft).value() == 2);
+
+    // FIFO order and quantities within the 150.00 level survive
+    const OrderBook& book = restored.book_manager().get_book(1);
+    [[maybe_unused]] const Order* head = book.get_order(10);
+    assert(head != nullptr);
+    assert(head->quantity == 60 && head->original_qty == 100);
+    assert(head->next != nullptr && head->next->order_id == 12);
+    assert(head->next->timestamp == 1002);
+    assert(book.bbo().bid_price == 1500000 && book.bbo().bid_quantity == 360);
+    assert(book.bbo().ask_price == 1510000);
+    assert(book.bid_level_count() == 2);
+
+    // Readers see the restored tops, not the empty slots left by reset()
+    assert(restored.bbo_publisher()->read(1).bbo.bid_price == 1500000);
+    assert(restored.bbo_publisher()->read(2).bbo.ask_price == 3000000);
+
+    // Both handlers continue identically
+    process_add(original, 1, 30, 'B', 1505000, 10, 2000);
+    process_add(restored, 1, 30, 'B', 1505000, 10, 2000);
+    assert(restored.book_manager().get_book(1).bbo().bid_price ==
+           original.book_manager().get_book(1).bbo().bid_price);
+    assert(restored.position().offset == original.position().offset);
+
+    // Corrupt files are rejected without touching state: an out-of-range
+    // book locate, then a bad magic
+    const long first_book = static_cast<long>(sizeof(CheckpointHeader) +
+                                              2 * sizeof(CheckpointSymbol));
+    std::FILE* f = std::fopen(path, "r+b");
+    std::fseek(f, first_book, SEEK_SET);
+    const StockLocate bad_locate = 0xFFFF;
+    std::fwrite(&bad_locate, sizeof(bad_locate), 1, f);
+    std::fclose(f);
+    assert(!load_checkpoint(restored, path));
+    assert(restored.book_manager().total_order_count() == 6);
+
+    f = std::fopen(path, "r+b");
+    std::fputc('X', f);
+    std::fclose(f);
+    assert(!load_checkpoint(restored, path));
+    assert(restored.book_manager().total_order_count() == 6);
+
+    std::remove(path);
+}
+
+TEST(background_checkpoint_is_point_in_time) {
+    FeedHandler handler;
+    process_directory(handler, 1, "AAPL");
+    for (OrderId id = 1; id <= 100; ++id) {
+        process_add(handler, 1, id, 'B', 1000000 + static_cast<Price>(id), 10, id);
+    }
+    [[maybe_unused]] const ReplayPosition at_fork = handler.position();
+
+    BackgroundCheckpointer checkpointer("test_background", std::chrono::hours(1));
+    [[maybe_unused]] bool started = checkpointer.checkpoint_now(handler);
+    assert(started);
+    assert(checkpointer.last_path() == checkpointer.path_for(at_fork.sequence));
+
+    // Mutations after the fork must not leak into the snapshot
+    for (OrderId id = 1; id <= 50; ++id) {
+        process_delete(handler, 1, id, 1000 + id);
+    }
+    checkpointer.wait();
+    assert(!checkpointer.in_progress());
+    assert(checkpointer.stats().completed == 1);
+    assert(checkpointer.stats().last_bytes > 0);
+
+    FeedHandler restored;
+    [[maybe_unused]] bool ok = load_checkpoint(restored, checkpointer.last_path().c_str());
+    assert(ok);
+    assert(restored.position().sequence == at_fork.sequence);
+    assert(restored.book_manager().total_order_count() == 100);
+    assert(handler.book_manager().total_order_count() == 50);
+
+    // Not due yet
+    assert(!checkpointer.poll(handler));
+    std::remove(checkpointer.last_path().c_str());
+}
+
+// =============================================================================
+// Sizing Profile Tests
+// =============================================================================
+
+TEST(sizing_profile_round_trip) {
+    const char* path = "test_sizing_profile.bin";
+    FeedHandler day;
+    process_directory(day, 1, "AAPL");
+    process_directory(day, 2, "MSFT");
+    process_directory(day, 3, "IDLE");
+    process_add(day, 1, 10, 'B', 1500000, 100, 1000);
+    process_add(day, 1, 11, 'B', 1490000, 100, 1001);
+    process_add(day, 1, 12, 'S', 1510000, 100, 1002);
+    process_add(day, 2, 20, 'S', 3000000, 100, 1003);
+    process_delete(day, 1, 10, 1004);
+    process_delete(day, 1, 11, 1005);
+    process_msg(day, make_replace(1, 12, 13, 100, 1520000, 1006));   // New ask level
+    process_add(day, 2, 21, 'B', 2990000, 100, 1007);
+
+    // Peaks outlive the orders: 4 live at most, book 1 held 3
+    SizingProfile profile = capture_sizing_profile(day);
+    assert(profile.peak_live_orders == 4);
+    assert(profile.books.size() == 2);                  // Idle book 3 is left out
+    const SizingProfileBook& aapl = profile.books[0];
+    assert(aapl.stock_locate == 1);
+    assert(aapl.peak_orders == 3);
+    assert(aapl.peak_bid_levels == 2);
+    assert(aapl.peak_ask_levels == 1);
+    assert(aapl.min_price == 1490000);
+    assert(aapl.max_price == 1520000);
+    assert(profile.books[1].peak_orders == 2);
+
+    bool ok = save_sizing_profile(day, path);
+    assert(ok);
+    SizingProfile loaded;
+    ok = load_sizing_profile(path, loaded);
+    assert(ok);
+    assert(loaded.peak_live_orders == 4);
+    assert(loaded.books.size() == 2);
+    assert(std::memcmp(loaded.books.data(), profile.books.data(),
+                       loaded.books.size() * sizeof(SizingProfileBook)) == 0);
+
+    // Next day: the pool and the profiled books are sized before any message
+    FeedHandler next;
+    ok = warm_start(next, path, 1000.0);
+    assert(ok);
+    assert(next.book_manager().order_pool().available() >= 4000);
+    assert(next.book_manager().has_book(1));
+    assert(next.book_manager().find_book(2)->order_capacity() >= 2000);
+    assert(!next.book_manager().has_book(3));
+    assert(!warm_start(next, "missing_sizing_profile.bin"));
+
+    // The end-of-day reset starts a fresh profile
+    day.reset();
+    profile = capture_sizing_profile(day);
+    assert(profile.peak_live_orders == 0);
+    assert(profile.books.empty());
+    std::remove(path);
+    (void)ok;
+    (void)aapl;
+}
+
+// =============================================================================
+// Warm-Up Tests
+// =============================================================================
+
+struct CountingEvents : FeedEventHandler {
+    std::size_t trades = 0;
+    std::size_t bbo_updates = 0;
+    void on_trade(const TradeEvent&) override { ++trades; }
+    void on_bbo_update(const BBOEvent&) override { ++bbo_updates; }
+};
+
+TEST(warmup_rolls_back_all_state) {
+    FeedHandler handler;
+    CountingEvents events;
+    handler.set_event_handler(&events);
+    handler.enable_bbo_publishing();
+    handler.enable_bars({60000000000ULL});
+    handler.enable_depth_feed(5);
+    handler.enable_metrics(true);
+    process_directory(handler, 1, "AAPL");
+    process_directory(handler, 2, "MSFT");
+    process_directory(handler, 3, "IDLE");
+    process_add(handler, 1, 10, 'B', 1500000, 100, 1000);
+    process_add(handler, 1, 11, 'S', 1510000, 200, 1001);
+    process_add(handler, 2, 20, 'B', 3000000, 300, 1002);
+    process_msg(handler, make_trade(2, 7, 3000000, 50, 1003));
+
+    const OrderBookManager& books = handler.book_manager();
+    const std::vector<DepthLevel> bids = books.find_book(1)->bid_depth();
+    const std::vector<DepthLevel> asks = books.find_book(1)->ask_depth();
+    [[maybe_unused]] const BookPeaks peaks = books.find_book(1)->peaks();
+    const std::size_t pool_peak = books.order_pool().peak_in_use();
+    const std::size_t deltas = handler.depth_deltas().size();
+    const std::uint64_t bbo_version = handler.bbo_publisher()->read(1).version;
+    const std::uint64_t bar_version = handler.bar_engine()->read(2, 0).version;
+    const std::uint64_t messages = handler.metrics().messages_processed;
+    const std::uint64_t parsed = handler.parser_stats().messages_parsed;
+    [[maybe_unused]] const ReplayPosition position = handler.position();
+    const std::size_t trades = events.trades;
+    [[maybe_unused]] const std::size_t bbo_updates = events.bbo_updates;
+
+    // Synthetic batches joined both books' best levels and traded, yet
+    // nothing outside the handler saw them and nothing inside kept them
+    handler.warmup();
+    for (int i = 0; i < 5; ++i) {
+        assert(handler.idle_warmup() == FeedHandler::IDLE_WARMUP_BOOKS);
+    }
+    assert(books.total_order_count() == 3);
+    assert(books.find_book(1)->get_order(10) != nullptr);
+    assert(books.find_book(1)->get_order(WARMUP_ORDER_REF_BASE | (1 << 8)) == nullptr);
+    assert(books.find_book(3)->order_count() == 0);
+    assert(books.find_book(3)->bid_level_count() == 0);
+    const std::vector<DepthLevel> bids_after = books.find_book(1)->bid_depth();
+    const std::vector<DepthLevel> asks_after = books.find_book(1)->ask_depth();
+    assert(bids_after.size() == bids.size() && asks_after.size() == asks.size());
+    assert(bids_after[0].price == bids[0].price && bids_after[0].quantity == bids[0].quantity);
+    assert(asks_after[0].price == asks[0].price && asks_after[0].quantity == asks[0].quantity);
+    assert(std::memcmp(&books.find_book(1)->peaks(), &peaks, sizeof(peaks)) == 0);
+    assert(books.order_pool().peak_in_use() == pool_peak);
+    assert(handler.depth_deltas().size() == deltas);
+    assert(handler.bbo_publisher()->read(1).version == bbo_version);
+    assert(handler.bar_engine()->read(2, 0).version == bar_version);
+    assert(handler.metrics().messages_processed == messages);
+    assert(handler.parser_stats().messages_parsed == parsed);
+    assert(handler.position().sequence == position.sequence);
+    assert(handler.position().offset == position.offset);
+    assert(events.trades == trades && events.bbo_updates == bbo_updates);
+
+    // Real traffic carries on as if the warm-up never ran
+    process_add(handler, 1, 12, 'B', 1505000, 100, 1004);
+    assert(books.find_book(1)->bbo().bid_price == 1505000);
+    assert(events.bbo_updates == bbo_updates + 1);
+    assert(handler.bbo_publisher()->read(1).bbo.bid_price == 1505000);
+    (void)bids; (void)asks; (void)pool_peak; (void)deltas; (void)bbo_version;
+    (void)bar_version; (void)messages; (void)parsed; (void)trades;
+}
+
+TEST(warmup_prefaults_only_sized_books) {
+    constexpr StockLocate SYMBOLS = 4000;
+    FeedHandler handler;
+    const std::size_t rss_before = rss_kib();
+    for (StockLocate l = 1; l <= SYMBOLS; ++l) {
+        process_directory(handler, l, ("S" + std::to_string(l)).c_str());
+    }
+    handler.warmup(1);
+    const std::size_t rss_after = rss_kib();
+
+    // A whole directory of unsized books opens and warms in a few KiB per
+    // symbol, not a default-sized (multi-MiB) order index each
+    const OrderBookManager& books = handler.book_manager();
+    assert(books.active_book_count() == SYMBOLS);
+    assert(!books.is_sized(1) && !books.is_sized(SYMBOLS));
+    assert(rss_after < rss_before + std::size_t{SYMBOLS} * 32);
+
+    // A presize() hint marks the open books sized, and warmup() faults them in
+    handler.presize(0, 1000);
+    assert(books.is_sized(1) && books.is_sized(SYMBOLS));
+    handler.warmup(1);
+    (void)rss_before; (void)rss_after;
+}
+
+// =============================================================================
+// Replay Index Tests
+// =============================================================================
+
+// Two symbols; order i is added at t = 1000 * i and orders i - 3 deleted
+// alongside, so the live set at any time is a small sliding window.
+std::vector<char> make_indexed_day() {
+    std::vector<char> day;
+    append_msg(day, make_directory(1, "AAPL"));
+    for (OrderId id = 1; id <= 200; ++id) {
+        const Timestamp ts = 1000 * id;
+        const StockLocate locate = static_cast<StockLocate>(1 + id % 2);
+        if (id == 50) {
+            append_msg(day, make_directory(2, "MSFT"));
+        }
+        append_msg(day, make_add(locate, id, (id % 4 < 2) ? 'B' : 'S',
+                                 1000000 + static_cast<Price>(id % 7) * 100, 100, ts));
+        if (id > 3) {
+            append_msg(day, make_delete(static_cast<StockLocate>(1 + (id - 3) % 2), id - 3, ts + 1));
+        }
+    }
+    return day;
+}
+
+bool same_books(const FeedHandler& a, const FeedHandler& b) {
+    bool equal = a.book_manager().total_order_count() == b.book_manager().total_order_count();
+    a.book_manager().for_each_book([&](const OrderBook& book) {
+        const OrderBook& other =
+            const_cast<FeedHandler&>(b).book_manager().get_book(book.stock_locate());
+        equal = equal && book.order_count() == other.order_count() &&
+                book.bbo().bid_price == other.bbo().bid_price &&
+                book.bbo().ask_price == other.bbo().ask_price;
+        book.for_each_order([&](const Order& o) {
+            equal = equal && other.get_order(o.order_id) != nullptr;
+        });
+    });
+    return equal;
+}
+
+TEST(replay_index_seek_and_locate) {
+    const std::vector<char> day = make_indexed_day();
+    ReplayIndex index;
+    ReplayIndex::Options options;
+    options.sample_messages = 8;
+    options.sample_ns = 1000000000;
+    [[maybe_unused]] bool ok = index.build(day.data(), day.size(), options);
+    assert(ok);
+    assert(index.message_count() == 1 + 200 + 197 + 1);
+    assert(index.file_size() == day.size());
+    assert(index.directory_offsets().size() == 2);
+    assert(index.directory_offsets()[0] == 0);
+    assert(day[index.directory_offsets()[1]] == 'R');
+    assert(index.entries().size() == (index.message_count() + 7) / 8);
+
+    // Every earlier message is before the sample's timestamp bound
+    [[maybe_unused]] const ReplayIndexEntry e = index.seek(100500);
+    assert(e.timestamp < 100500);
+    assert(e.offset > 0 && e.sequence > 0);
+    assert(index.seek(0).offset == 0);
+
+    // locate() lands exactly on the first message at or after the time
+    const ReplayPosition pos = index.locate(day.data(), day.size(), 100500);
+    assert(day[pos.offset] == 'A');
+    FeedHandler handler;
+    handler.process(day.data(), static_cast<std::size_t>(pos.offset));
+    assert(handler.position().sequence == pos.sequence);
+    assert(index.locate(day.data(), day.size(), ~0ULL).offset == day.size());
+
+    // Data that does not parse like the indexed file ends the scan
+    const std::vector<char> garbage(day.size(), 0);
+    assert(index.locate(garbage.data(), garbage.size(), 100500).offset == day.size());
+    assert(index.locate(day.data(), pos.offset - 1, 100500).offset == pos.offset - 1);
+
+    // Sidecar round trip
+    const std::string path = ReplayIndex::sidecar_path("test_replay.itch");
+    ok = index.save(path.c_str());
+    assert(ok);
+    ReplayIndex loaded;
+    ok = loaded.load(path.c_str());
+    assert(ok);
+    assert(loaded.entries().size() == index.entries().size());
+    assert(loaded.entries().back().offset == index.entries().back().offset);
+    assert(loaded.directory_offsets() == index.directory_offsets());
+    assert(loaded.message_count() == index.message_count());
+    std::remove(path.c_str());
+}
+
+TEST(replay_index_window_and_checkpoint) {
+    const std::vector<char> day = make_indexed_day();
+    ReplayIndex index;
+    index.build(day.data(), day.size());
+
+    // Window replay resolves symbols from earlier directory records
+    FeedHandler window;
+    replay_range(window, day.data(), day.size(), index, 150000, 160000);
+    Symbol msft;
+    std::memcpy(msft.data, "MSFT    ", 8);
+    assert(window.symbol_directory().get_locate(msft).value() == 2);
+    assert(window.book_manager().total_order_count() == 4); // 150..160 added, 150..156 deleted
+    assert(window.book_manager().get_book(1).get_order(160) != nullptr);
+
+    // Checkpoint at t=60us, then seek to t=120.5us: books match a full replay
+    FeedHandler full;
+    const ReplayPosition at_ckpt = index.locate(day.data(), day.size(), 60000);
+    full.process(day.data(), static_cast<std::size_t>(at_ckpt.offset));
+    const char* ckpt = "test_replay.ckpt";
+    [[maybe_unused]] bool ok = save_checkpoint(full, ckpt);
+    assert(ok);
+    full.process(day.data() + at_ckpt.offset,
+                 static_cast<std::size_t>(index.locate(day.data(), day.size(), 120501).offset -
+                                          at_ckpt.offset));
+
+    FeedHandler restored;
+    ok = load_checkpoint(restored, ckpt) &&
+         replay_until(restored, day.data(), day.size(), index, 120500);
+    assert(ok);
+    assert(restored.position().sequence == full.position().sequence);
+    assert(same_books(full, restored) && same_books(restored, full));
+
+    // Already past the requested time
+    assert(!replay_until(restored, day.data(), day.size(), index, 50000));
+    std::remove(ckpt);
+}
+
+// =============================================================================
+// Parallel Replay Tests
+// =============================================================================
+
+// Random order flow over 20 symbols with a few live orders each
+std::vector<char> make_random_day(std::size_t messages) {
+    std::mt19937 rng(7);
+    std::vector<char> day;
+    for (StockLocate l = 1; l <= 20; ++l) {
+        append_msg(day, make_directory(l, ("S" + std::to_string(l)).c_str()));
+    }
+    std::vector<std::pair<OrderId, StockLocate>> live;
+    OrderId next_id = 1;
+    for (std::size_t i = 0; i < messages; ++i) {
+        const Timestamp ts = 1000 + i;
+        const Price price = 1000000 + static_cast<Price>(rng() % 50) * 100;
+        if (live.size() < 50 || rng() % 2 == 0) {
+            const StockLocate l = static_cast<StockLocate>(1 + rng() % 20);
+            append_msg(day, make_add(l, next_id, (rng() % 2) ? 'B' : 'S', price,
+                                     static_cast<Quantity>(100 + rng() % 100), ts));
+            live.emplace_back(next_id++, l);
+            continue;
+        }
+        const std::size_t k = rng() % live.size();
+        switch (rng() % 4) {
+            case 0:
+                append_msg(day, make_execute(live[k].second, live[k].first, 10, ts));
+                break;
+            case 1:
+                append_msg(day, make_cancel(live[k].second, live[k].first, 10, ts));
+                break;
+            case 2:
+                append_msg(day, make_replace(live[k].second, live[k].first, next_id,
+                                             static_cast<Quantity>(100 + rng() % 100), price, ts));
+                live[k].first = next_id++;
+                break;
+            default:
+                append_msg(day, make_delete(live[k].second, live[k].first, ts));
+                live[k] = live.back();
+                live.pop_back();
+                break;
+        }
+    }
+    return day;
+}
+
+TEST(parallel_replay_matches_serial) {
+    const std::vector<char> day = make_random_day(5000);
+
+    FeedHandler serial;
+    serial.process(day.data(), day.size());
+
+    // Small windows force many windows and mid-message chunk cuts
+    ParallelReplay parallel(3, 4096);
+    [[maybe_unused]] const std::size_t consumed = parallel.process(day.data(), day.size());
+    assert(consumed == day.size());
+    assert(parallel.stats().messages == serial.position().sequence);
+    assert(parallel.stats().windows > 1);
+    assert(parallel.total_order_count() == serial.book_manager().total_order_count());
+
+    serial.book_manager().for_each_book([&](const OrderBook& book) {
+        const OrderBook* other = parallel.find_book(book.stock_locate());
+        assert(other != nullptr);
+        assert(other->order_count() == book.order_count());
+        assert(other->bbo().bid_price == book.bbo().bid_price);
+        assert(other->bbo().ask_quantity == book.bbo().ask_quantity);
+        (void)other;
+    });
+
+    // Each worker only ever saw its own locates
+    for (std::size_t w = 0; w < parallel.worker_count(); ++w) {
+        parallel.worker(w).book_manager().for_each_book([&](const OrderBook& book) {
+            assert(parallel.worker_for(book.stock_locate()) == w);
+            (void)book;
+        });
+    }
+}
+
+TEST(parallel_replay_boundaries) {
+    std::vector<char> day = make_random_day(200);
+
+    // A cut inside a message resolves to the next real boundary
+    [[maybe_unused]] const std::size_t second = sizeof(StockDirectoryMessage);
+    assert(find_message_boundary(day.data(), day.size(), 0) == 0);
+    assert(find_message_boundary(day.data(), day.size(), 1) == second);
+    assert(find_message_boundary(day.data(), day.size(), second) == second);
+
+    // A corrupt message stops replay exactly where the serial parser stops
+    const std::size_t corrupt = day.size() / 2;
+    std::size_t boundary = 0;
+    while (boundary < corrupt) boundary += get_message_size(day[boundary]);
+    day[boundary] = '?';
+
+    FeedHandler serial;
+    [[maybe_unused]] const std::size_t serial_bytes = serial.process(day.data(), day.size());
+    ParallelReplay parallel(4, 1024);
+    const std::size_t parallel_bytes = parallel.process(day.data(), day.size());
+    assert(serial_bytes == boundary);
+    assert(parallel_bytes == serial_bytes);
+    assert(parallel.total_order_count() == serial.book_manager().total_order_count());
+    (void)parallel_bytes;
+}
+
+// =============================================================================
+// Decoded Cache Tests
+// =============================================================================
+
+TEST(decoded_cache_replay_matches_raw) {
+    std::vector<char> day = make_random_day(5000);
+    SystemEventMessage sys;
+    sys.message_type = 'S';
+    set_be16(sys.stock_locate, 0);
+    set_be16(sys.tracking_number, 0);
+    set_timestamp(sys.timestamp, 9000);
+    sys.event_code = SystemEventMessage::EVENT_END_MARKET_HOURS;
+    append_msg(day, sys);
+
+    const char* path = "test_decoded.cache";
+    DecodedCacheInfo info;
+    [[maybe_unused]] bool ok = write_decoded_cache(day.data(), day.size(), path, &info);
+    assert(ok);
+    assert(info.source_bytes == day.size());
+    assert(info.side_messages == 21);   // 20 directory records + system event
+    assert(info.book_messages + info.side_messages == 5000 + 21);
+    assert(info.record_count > info.book_messages);     // Replaces take two slots
+
+    DecodedCache cache;
+    ok = cache.open(path);
+    assert(ok);
+    assert(cache.record_count() == info.record_count);
+    assert(cache.records()[0].type == 'A');
+    assert(cache.records()[0].timestamp == 1000);
+
+    FeedHandler raw;
+    raw.process(day.data(), day.size());
+    OrderBookManager books;
+    const std::size_t applied = cache.replay(books);
+    assert(applied == info.book_messages);
+    assert(books.total_order_count() == raw.book_manager().total_order_count());
+    raw.book_manager().for_each_book([&](const OrderBook& book) {
+        const OrderBook* other = books.find_book(book.stock_locate());
+        assert(other != nullptr && other->order_count() == book.order_count());
+        assert(other->bbo().bid_price == book.bbo().bid_price);
+        assert(other->bbo().bid_quantity == book.bbo().bid_quantity);
+        assert(other->bbo().ask_price == book.bbo().ask_price);
+        (void)other;
+    });
+
+    // The side stream is plain ITCH the feed handler can consume
+    FeedHandler side;
+    assert(side.process(cache.side_stream(), cache.side_size()) == cache.side_size());
+    assert(side.symbol_directory().symbol_count() == 20);
+
+    // The side index puts each side message back at its source position:
+    // the directory ahead of every record, the system event after all of them
+    assert(cache.side_message_count() == info.side_messages);
+    assert(cache.side_index()[0] == 0);
+    assert(cache.side_index()[info.side_messages - 1] == info.record_count);
+    FeedHandler merged;
+    std::size_t seen_records_at_event = 0;
+    const std::size_t merged_applied = cache.replay(merged.book_manager(),
+        [&](const char* msg, std::size_t size) {
+            if (msg[0] == 'S') seen_records_at_event = merged.book_manager().total_order_count();
+            merged.process(msg, size);
+        });
+    assert(merged_applied == info.book_messages);
+    assert(merged.symbol_directory().symbol_count() == 20);
+    assert(seen_records_at_event == raw.book_manager().total_order_count());
+    (void)merged_applied;
+    (void)seen_records_at_event;
+
+    // A replace whose extension slot is damaged ends the replay there
+    std::size_t first_replace = 0;
+    std::size_t messages_before = 0;
+    while (cache.records()[first_replace].type != 'U') {
+        ++first_replace;
+        ++messages_before;
+    }
+    {
+        std::FILE* f = std::fopen(path, "r+b");
+        std::fseek(f, static_cast<long>(sizeof(DecodedCacheHeader) +
+                                        (first_replace + 1) * sizeof(DecodedRecord) +
+                                        offsetof(DecodedRecord, type)), SEEK_SET);
+        std::fputc('A', f);
+        std::fclose(f);
+    }
+    DecodedCache damaged;
+    ok = damaged.open(path);
+    assert(ok);
+    OrderBookManager partial;
+    assert(damaged.replay(partial) == messages_before);
+
+    // Truncated files are rejected
+    {
+        std::FILE* f = std::fopen(path, "ab");
+        std::fputc(0, f);
+        std::fclose(f);
+    }
+    DecodedCache bad;
+    assert(!bad.open(path));
+    std::remove(path);
+    (void)applied;
+}
+
+// =============================================================================
+// Columnar Export Tests
+// =============================================================================
+
+TEST(columnar_export_round_trip) {
+    std::vector<char> day = make_random_day(3000);
+    append_msg(day, make_cross(3, 900, 1010000, 25000, 'C', 9000));
+    append_msg(day, make_broken(3, 900, 9001));
+    SystemEventMessage sys;
+    sys.message_type = 'S';
+    set_be16(sys.stock_locate, 0);
+    set_be16(sys.tracking_number, 0);
+    set_timestamp(sys.timestamp, 9002);
+    sys.event_code = SystemEventMessage::EVENT_END_MARKET_HOURS;
+    append_msg(day, sys);
+    const char* dir = "test_columnar";
+
+    ColumnarExporter exporter;
+    [[maybe_unused]] bool ok = exporter.open(dir);
+    assert(ok);
+    // Feed in two uneven pieces, as a streaming reader would
+    const std::size_t first = exporter.process(day.data(), day.size() / 3);
+    exporter.process(day.data() + first, day.size() - first);
+    ColumnarExportInfo info;
+    ok = exporter.finish(&info);
+    assert(ok);
+    assert(info.source_bytes == day.size());
+    assert(info.messages == 3000 + 20 + 3);
+    assert(info.exported == 3000 + 2);     // Directory and system events are not
+
+    ColumnarDay columns;
+    ok = columns.open(dir);
+    assert(ok);
+    assert(columns.messages() == info.messages);
+    assert(columns.exported() == info.exported);
+    assert(columns.rows('A') + columns.rows('E') + columns.rows('X') + columns.rows('U') +
+           columns.rows('D') == 3000);
+    assert(columns.rows('P') == 0 && columns.prices('P') == nullptr);
+    assert(columns.new_refs('A') == nullptr);
+
+    // Crosses and breaks carry their trade fields
+    assert(columns.rows('Q') == 1 && columns.rows('B') == 1);
+    assert(columns.shares('Q')[0] == 25000 && columns.prices('Q')[0] == 1010000);
+    assert(columns.matches('Q')[0] == 900 && columns.cross_types('Q')[0] == 'C');
+    assert(columns.locates('Q')[0] == 3 && columns.refs('Q') == nullptr);
+    assert(columns.matches('B')[0] == 900 && columns.timestamps('B')[0] == 9001);
+
+    // Columns match the raw messages row for row
+    std::size_t add_row = 0;
+    std::size_t replace_row = 0;
+    for (std::size_t offset = 0; offset < day.size(); offset += get_message_size(day[offset])) {
+        const char* msg = day.data() + offset;
+        if (msg[0] == 'A') {
+            [[maybe_unused]] const auto& m = *reinterpret_cast<const AddOrderMessage*>(msg);
+            assert(columns.refs('A')[add_row] == endian::be64_to_host(m.order_ref_number));
+            assert(columns.prices('A')[add_row] == endian::be32_to_host(m.price));
+            assert(columns.sides('A')[add_row] == m.buy_sell_indicator);
+            assert(columns.locates('A')[add_row] == endian::be16_to_host(m.stock_locate));
+            ++add_row;
+        } else if (msg[0] == 'U') {
+            const auto& m = *reinterpret_cast<const OrderReplaceMessage*>(msg);
+            assert(columns.new_refs('U')[replace_row] == endian::be64_to_host(m.new_order_ref_number));
+            assert(columns.timestamps('U')[replace_row] ==
+                   endian::be48_to_host(reinterpret_cast<const std::uint8_t*>(msg + 5)));
+            ++replace_row;
+            (void)m;
+        }
+    }
+    assert(add_row == columns.rows('A') && replace_row == columns.rows('U'));
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(columnar_kernels_match_scalar) {
+    std::mt19937 rng(11);
+    for (std::size_t n : {0u, 1u, 3u, 15u, 16u, 17u, 1000u, 1027u}) {
+        std::vector<std::uint16_t> keys(n);
+        std::vector<std::uint32_t> a(n), b(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            keys[i] = static_cast<std::uint16_t>(rng() % 5);
+            a[i] = static_cast<std::uint32_t>(rng());
+            b[i] = static_cast<std::uint32_t>(rng() % 100000);
+        }
+        std::size_t count = 0;
+        std::uint64_t total = 0, where = 0, dot = 0;
+        std::vector<std::uint32_t> rows;
+        for (std::size_t i = 0; i < n; ++i) {
+            total += a[i];
+            if (keys[i] == 3) {
+                ++count;
+                where += a[i];
+                dot += static_cast<std::uint64_t>(a[i]) * b[i];
+                rows.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        assert(columnar::count_equal(keys.data(), n, 3) == count);
+        assert(columnar::sum(a.data(), n) == total);
+        assert(columnar::sum_where_equal(a.data(), keys.data(), n, 3) == where);
+        assert(columnar::dot_where_equal(a.data(), b.data(), keys.data(), n, 3) == dot);
+        std::vector<std::uint32_t> out(n);
+        assert(columnar::filter_equal(keys.data(), n, 3, out.data()) == rows.size());
+        assert(std::equal(rows.begin(), rows.end(), out.begin()));
+        (void)count; (void)total; (void)where; (void)dot;
+    }
+
+    const std::uint64_t ts[] = {10, 20, 20, 30, 40};
+    const auto range = columnar::time_range(ts, 5, 20, 30);
+    assert(range.first == 1 && range.second == 4);
+    (void)range;
+}
+
+// =============================================================================
+// Bar Engine Tests
+// =============================================================================
+
+TEST(bar_engine_ohlcv_and_breaks) {
+    FeedHandler handler;
+    handler.enable_bars({1000, 10000});
+    const BarEngine& bars = *handler.bar_engine();
+    assert(bars.interval_count() == 2);
+
+    process_msg(handler, make_trade(1, 1, 100, 10, 100));
+    process_msg(handler, make_trade(1, 2, 120, 5, 200));
+    process_msg(handler, make_trade(1, 3, 90, 5, 300));
+    process_msg(handler, make_trade(1, 4, 110, 10, 1100));
+
+    BarSnapshot fast = bars.read(1, 0);
+    assert(fast.previous.start == 0 && fast.previous.trade_count == 3);
+    assert(fast.previous.open == 100 && fast.previous.high == 120);
+    assert(fast.previous.low == 90 && fast.previous.close == 90);
+    assert(fast.previous.volume == 20 && fast.previous.notional == 2050);
+    assert(fast.current.start == 1000 && fast.current.open == 110 && fast.current.volume == 10);
+
+    BarSnapshot slow = bars.read(1, 1);
+    assert(slow.previous.empty() && slow.current.trade_count == 4);
+    assert(slow.current.high == 120 && slow.current.close == 110 && slow.current.volume == 30);
+
+    // Book executions use the resting price; non-printable executions are skipped
+    process_add(handler, 1, 50, 'S', 105, 100, 1200);
+    process_msg(handler, make_execute(1, 50, 30, 1300));
+    process_msg(handler, make_execute_price(1, 50, 20, 104, 'N', 1400));
+    process_msg(handler, make_execute_price(1, 50, 20, 103, 'Y', 1500));
+    fast = bars.read(1, 0);
+    assert(fast.current.trade_count == 3 && fast.current.volume == 60);
+    assert(fast.current.low == 103 && fast.current.close == 103);
+
+    // Break the 120 print: volume, VWAP and the high are corrected in both intervals
+    process_msg(handler, make_broken(1, 2, 1600));
+    fast = bars.read(1, 0);
+    assert(fast.previous.trade_count == 2 && fast.previous.volume == 15);
+    assert(fast.previous.high == 100 && fast.previous.notional == 1450);
+    assert(fast.previous.vwap() > 96.6 && fast.previous.vwap() < 96.7);
+    slow = bars.read(1, 1);
+    assert(slow.current.high == 110 && slow.current.open == 100 && slow.current.volume == 75);
+
+    // Unknown and repeated breaks change nothing
+    process_msg(handler, make_broken(1, 99, 1700));
+    process_msg(handler, make_broken(1, 2, 1700));
+    assert(bars.stats().breaks == 1 && bars.stats().unmatched_breaks == 2);
+    assert(bars.read(1, 1).current.volume == 75);
+
+    // Breaking the only trade of a bar empties it
+    process_msg(handler, make_trade(2, 7, 500, 1, 1800));
+    process_msg(handler, make_broken(2, 7, 1900));
+    assert(bars.read(2, 0).current.empty() && bars.read(2, 0).current.high == 0);
+
+    handler.reset();
+    assert(bars.read(1, 0).current.empty() && bars.stats().trades == 0);
+    (void)fast; (void)slow;
+}
+
+TEST(bar_engine_breaks_through_a_wrapped_log) {
+    BarEngine bars({1000000}, 64);
+
+    // Symbol 2 floods the log between symbol 1's trades
+    std::uint64_t match = 1000;
+    for (int i = 0; i < 40; ++i) {
+        bars.on_trade(1, 100 + i, 1, match++, static_cast<Timestamp>(10 * i));
+        bars.on_trade(2, 500, 1, match++, static_cast<Timestamp>(10 * i + 1));
+    }
+    // Log holds the last 64 trades: symbol 1's trades from i = 8 on
+    bars.on_broken_trade(1, 1000);                  // Evicted
+    assert(bars.stats().unmatched_breaks == 1);
+
+    // Breaking the newest print moves the close and the high back one trade,
+    // but the bar's early trades are gone from the log so OHLC is kept
+    bars.on_broken_trade(1, 1000 + 2 * 39);
+    assert(bars.stats().breaks == 1 && bars.stats().inexact_breaks == 1);
+    BarSnapshot snap = bars.read(1, 0);
+    assert(snap.current.trade_count == 39 && snap.current.volume == 39);
+
+    // A bar that fits in the log is rebuilt exactly from the symbol's chain
+    bars.on_trade(1, 300, 5, 5000, 2000000);
+    bars.on_trade(2, 900, 5, 5001, 2000001);
+    bars.on_trade(1, 250, 5, 5002, 2000002);
+    bars.on_trade(1, 280, 5, 5003, 2000003);
+    bars.on_broken_trade(1, 5000);
+    snap = bars.read(1, 0);
+    assert(snap.current.trade_count == 2 && snap.current.open == 250);
+    assert(snap.current.high == 280 && snap.current.low == 250 && snap.current.close == 280);
+    assert(bars.stats().inexact_breaks == 1);
+
+    // Wrong symbol for the match number does not match
+    bars.on_broken_trade(1, 5001);
+    assert(bars.stats().unmatched_breaks == 2);
+    (void)snap;
+}
+
+TEST(bar_engine_no_torn_reads) {
+    BarEngine bars({100000}, 1024);
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> checked{0};
+
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            BarSnapshot snap;
+            if (!bars.try_read(3, 0, snap) || snap.current.empty()) continue;
+            const Bar& b = snap.current;
+            // Every trade is 10 shares at price == its sequence number
+            assert(b.volume == b.trade_count * 10);
+            assert(b.low <= b.open && b.open <= b.close && b.close == b.high);
+            assert(b.notional == static_cast<std::uint64_t>(b.open + b.close) * b.trade_count * 5);
+            (void)b;
+            checked.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    for (std::uint64_t i = 1; i <= 2000000; ++i) {
+        bars.on_trade(3, static_cast<Price>(i), 10, i, i);
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    assert(bars.stats().trades == 2000000);
+    (void)checked;
+}
+
+// =============================================================================
+// Day Generator Tests
+// =============================================================================
+
+std::vector<char> generate_day(const DayGeneratorConfig& config, DayGeneratorStats* stats = nullptr) {
+    std::vector<char> day;
+    DayGenerator gen(config);
+    gen.generate([&](const char* data, std::size_t len) { day.insert(day.end(), data, data + len); });
+    if (stats) *stats = gen.stats();
+    return day;
+}
+
+TEST(day_generator_replays_cleanly) {
+    DayGeneratorConfig config;
+    config.seed = 7;
+    config.symbols = 50;
+    config.messages = 20000;
+    config.halts = 2;
+    config.max_live_per_symbol = 200;
+    DayGeneratorStats stats;
+    const std::vector<char> day = generate_day(config, &stats);
+    assert(stats.bytes == day.size());
+    assert(generate_day(config) == day);                // Deterministic per seed
+    config.seed = 8;
+    assert(generate_day(config) != day);
+    config.seed = 7;
+
+    // Framing, session structure and monotonic timestamps
+    std::size_t offset = 0, messages = 0;
+    Timestamp last = 0;
+    char first_event = 0, last_event = 0;
+    while (offset + 2 <= day.size()) {
+        const std::size_t len = static_cast<std::size_t>(static_cast<unsigned char>(day[offset])) << 8 |
+                                static_cast<unsigned char>(day[offset + 1]);
+        const char* msg = day.data() + offset + 2;
+        assert(len == get_message_size(msg[0]));
+        const Timestamp ts = endian::be48_to_host(reinterpret_cast<const std::uint8_t*>(msg + 5));
+        assert(ts >= last);
+        last = ts;
+        if (msg[0] == 'S') {
+            if (first_event == 0) first_event = msg[11];
+            last_event = msg[11];
+        }
+        offset += 2 + len;
+        ++messages;
+    }
+    assert(offset == day.size() && messages == stats.messages);
+    assert(first_event == SystemEventMessage::EVENT_START_OF_MESSAGES);
+    assert(last_event == SystemEventMessage::EVENT_END_OF_MESSAGES);
+    assert(stats.count('S') == 6 && stats.count('R') == 50);
+    assert(stats.count('H') == 50 + 2 * 2);             // Initial state, then halt and resume
+    assert(stats.count('Q') == 2 * 50 + 2);             // Open and close per symbol, halt crosses
+    assert(stats.count('I') > 0);
+
+    // Every execute, cancel, delete and replace hits a live order with the shares it needs
+    FeedHandler handler;
+    assert(handler.process_binaryfile(day.data(), day.size()) == day.size());
+    assert(handler.position().sequence == stats.messages);
+    assert(handler.position().offset == day.size());
+    assert(handler.symbol_directory().symbol_count() == 50);
+    [[maybe_unused]] const FeedMetrics& m = handler.metrics();
+    assert(m.orders_executed == stats.count('E') + stats.count('C'));
+    assert(m.orders_cancelled == stats.count('X'));
+    assert(m.orders_deleted == stats.count('D'));
+    assert(m.orders_replaced == stats.count('U'));
+    assert(handler.book_manager().total_order_count() == stats.live_orders);
+    assert(stats.live_orders > 0);
+
+    // A truncated stream stops at the last whole message
+    FeedHandler truncated;
+    const std::size_t consumed = truncated.process_binaryfile(day.data(), day.size() - 1);
+    assert(consumed < day.size() - 1 && consumed + 2 + sizeof(SystemEventMessage) == day.size());
+
+    // Raw output carries the same day without the framing
+    config.binary_file = false;
+    DayGeneratorStats raw_stats;
+    const std::vector<char> raw = generate_day(config, &raw_stats);
+    assert(raw.size() == day.size() - 2 * stats.messages);
+    FeedHandler raw_handler;
+    assert(raw_handler.process(raw.data(), raw.size()) == raw.size());
+    assert(raw_handler.book_manager().total_order_count() == stats.live_orders);
+    (void)consumed;
+    (void)raw_stats;
+    (void)last;
+    (void)last_event;
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "Running Feed Handler Tests\n";
+    std::cout << std::string(40, '=') << "\n";
+
+    // Book storage tests
+    std::cout << "\nBook Storage Tests:\n";
+    RUN_TEST(directory_opens_books);
+
+    // BBO publisher tests
+    std::cout << "\nBBO Publisher Tests:\n";
+    RUN_TEST(bbo_publisher_follows_book);
+    RUN_TEST(bbo_publisher_no_torn_reads);
+
+    // Checkpoint tests
+    std::cout << "\nCheckpoint Tests:\n";
+    RUN_TEST(checkpoint_round_trip);
+    RUN_TEST(background_checkpoint_is_point_in_time);
+
+    // Sizing profile tests
+    std::cout << "\nSizing Profile Tests:\n";
+    RUN_TEST(sizing_profile_round_trip);
+
+    // Warm-up tests
+    std::cout << "\nWarm-Up Tests:\n";
+    RUN_TEST(warmup_rolls_back_all_state);
+    RUN_TEST(warmup_prefaults_only_sized_books);
+
+    // Replay index tests
+    std::cout << "\nReplay Index Tests:\n";
+    RUN_TEST(replay_index_seek_and_locate);
+    RUN_TEST(replay_index_window_and_checkpoint);
+
+    // Parallel replay tests
+    std::cout << "\nParallel Replay Tests:\n";
+    RUN_TEST(parallel_replay_matches_serial);
+    RUN_TEST(parallel_replay_boundaries);
+
+    // Decoded cache tests
+    std::cout << "\nDecoded Cache Tests:\n";
+    RUN_TEST(decoded_cache_replay_matches_raw);
+
+    // Columnar export tests
+    std::cout << "\nColumnar Export Tests:\n";
+    RUN_TEST(columnar_export_round_trip);
+    RUN_TEST(columnar_kernels_match_scalar);
+
+    // Bar engine tests
+    std::cout << "\nBar Engine Tests:\n";
+    RUN_TEST(bar_engine_ohlcv_and_breaks);
+    RUN_TEST(bar_engine_breaks_through_a_wrapped_log);
+    RUN_TEST(bar_engine_no_torn_reads);
+
+    // Day generator tests
+    std::cout << "\nDay Generator Tests:\n";
+    RUN_TEST(day_generator_replays_cleanly);
+
+    std::cout << "\n" << std::string(40, '=') << "\n";
+    std::cout << "All feed handler tests PASSED!\n";
+
+    return 0;
+}
@@ -7,6 +7,10 @@
 #include <cassert>
 #include <iostream>
 #include <vector>
+#include <random>
+#include <unordered_map>
+#include <algorithm>
+#include <thread>
 
 using namespace itch;
 
@@ -67,6 +71,254 @@ TEST(object_pool_growth) {
     }
 }
 
+TEST(object_pool_hard_capacity) {
+    ObjectPool<Order> pool;
+    pool.set_hard_capacity(200);
+    const std::size_t capacity = pool.capacity();
+    assert(pool.hard_capacity());
+    assert(pool.available() >= 200);
+    
+    std::vector<Order*> orders;
+    while (Order* order = pool.acquire()) {
+        orders.push_back(order);
+    }
+    // Refuses instead of growing, and recovers once objects come back
+    assert(orders.size() == capacity);
+    assert(pool.capacity() == capacity);
+    assert(pool.exhausted() == 1);
+    assert(pool.acquire() == nullptr);
+    assert(pool.exhausted() == 2);
+    pool.release(orders.back());
+    assert(pool.acquire() == orders.back());
+    (void)capacity;
+    
+    // The book drops the add rather than touching a null order
+    OrderBook book(1, 16);
+    assert(book.add_order(1, Side::Buy, 1000000, 100, 0, pool) == nullptr);
+    assert(book.order_count() == 0);
+    assert(book.get_order(1) == nullptr);
+}
+
+TEST(object_pool_background_refill) {
+    ObjectPool<Order, 256> pool;
+    pool.enable_background_refill(128);
+    assert(pool.background_refill());
+    
+    std::vector<Order*> orders;
+    for (int i = 0; i < 5000; ++i) {
+        Order* order = pool.acquire();
+        assert(order != nullptr);
+        order->order_id = static_cast<OrderId>(i);
+        orders.push_back(order);
+        if (pool.available() == 128) {
+            // Give the helper its chance once per block; a late one only costs an inline block
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    assert(pool.capacity() >= 5000);
+    assert(pool.inline_blocks() < pool.capacity() / 256);
+    
+    // Every object handed out is distinct and still holds what was written
+    std::vector<Order*> sorted = orders;
+    std::sort(sorted.begin(), sorted.end());
+    assert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+        assert(orders[i]->order_id == i);
+    }
+    
+    // Adopted blocks came with free-list room, so releasing never reallocates
+    const std::size_t free_capacity = pool.free_list_capacity();
+    assert(free_capacity >= pool.capacity());
+    for (auto* order : orders) {
+        pool.release(order);
+    }
+    assert(pool.available() >= 5000);
+    assert(pool.free_list_capacity() == free_capacity);
+    (void)free_capacity;
+}
+
+TEST(object_pool_hard_capacity_after_background_refill) {
+    ObjectPool<Order, 256> pool;
+    pool.enable_background_refill(128);
+    std::vector<Order*> orders;
+    for (int i = 0; i < 400; ++i) {
+        orders.push_back(pool.acquire());
+    }
+    
+    // Objects left in an adopted block still count once the helper is gone
+    pool.set_hard_capacity(1000);
+    assert(!pool.background_refill());
+    const std::size_t available = pool.available();
+    assert(available >= 1000);
+    std::size_t acquired = 0;
+    while (pool.acquire() != nullptr) {
+        ++acquired;
+    }
+    assert(acquired == available);
+    assert(pool.exhausted() == 1);
+    (void)available;
+    (void)acquired;
+}
+
+// =============================================================================
+// Order Index Tests
+// =============================================================================
+
+// Random insert / extract churn checked against std::unordered_map. Ids are
+// base + k * stride, so stride 1 is a sequential feed and a large power-of-two
+// stride puts every id in the same low bits.
+template<typename Index>
+void check_order_index(OrderId stride) {
+    Index index(16);    // Start tiny so the churn crosses several resizes
+    std::unordered_map<OrderId, Order*> reference;
+    std::vector<OrderId> live;
+    std::mt19937_64 rng(11);
+    OrderId next = 1;
+    for (int i = 0; i < 200000; ++i) {
+        if (live.empty() || rng() % 3 != 0) {
+            const OrderId id = next++ * stride;
+            Order* order = reinterpret_cast<Order*>(static_cast<std::uintptr_t>(id) * 64);
+            assert(index.insert(id, order));
+            assert(!index.insert(id, order));
+            reference[id] = order;
+            live.push_back(id);
+        } else {
+            const std::size_t pick = rng() % live.size();
+            const OrderId id = live[pick];
+            live[pick] = live.back();
+            live.pop_back();
+            assert(index.extract(id) == reference[id]);
+            assert(index.extract(id) == nullptr);
+            reference.erase(id);
+        }
+    }
+    assert(index.size() == reference.size());
+    for (const auto& [id, order] : reference) {
+        assert(index.find(id) == order);
+        (void)order;
+    }
+    assert(index.find(next * stride) == nullptr);
+
+    index.clear();
+    assert(index.size() == 0);
+    assert(index.find(live.front()) == nullptr);
+    index.put(live.front(), nullptr);
+    assert(index.size() == 1);
+}
+
+TEST(order_index_backends) {
+    check_order_index<OrderMap>(1);
+    check_order_index<OrderMap>(1024);
+    check_order_index<SwissOrderMap>(1);
+    check_order_index<SwissOrderMap>(1024);
+    check_order_index<SwissOrderMap>(OrderId{1} << 32);
+    check_order_index<PagedOrderMap>(1);
+    check_order_index<PagedOrderMap>(1024);
+    check_order_index<PagedOrderMap>(OrderId{1} << 32);
+}
+
+TEST(order_map_incremental_resize) {
+    OrderMap index(OrderMap::INCREMENTAL_MIN);
+    auto order_for = [](OrderId id) {
+        return reinterpret_cast<Order*>(static_cast<std::uintptr_t>(id) * 64);
+    };
+    // Clustered ids (multiples of 8) so migration has to move multi-entry runs
+    OrderId next = 1;
+    while (!index.resizing()) {
+        index.put(next * 8, order_for(next * 8));
+        ++next;
+    }
+    const std::size_t grown = index.capacity();
+    assert(grown == 2 * OrderMap::INCREMENTAL_MIN);
+    std::size_t steps = 0;
+    while (index.resizing()) {
+        // Every id stays reachable while entries straddle both tables
+        for (OrderId id = steps / 2 + 1; id < next; id += 97) {
+            assert(index.find(id * 8) == order_for(id * 8));
+        }
+        if (steps % 2 == 0) {
+            index.put(next * 8, order_for(next * 8));
+            ++next;
+        } else {
+            assert(index.extract((steps / 2 + 1) * 8) == order_for((steps / 2 + 1) * 8));
+            assert(!index.insert((steps / 2 + 2) * 8, nullptr));
+        }
+        ++steps;
+    }
+    // Drains well before the new table reaches its own threshold
+    assert(steps * OrderMap::MIGRATE_STEP <= grown);
+    assert(index.capacity() == grown);
+    const std::size_t removed = steps / 2;
+    assert(index.size() == next - 1 - removed);
+    for (OrderId id = 1; id < next; ++id) {
+        assert(index.find(id * 8) == (id <= removed ? nullptr : order_for(id * 8)));
+    }
+    (void)grown;
+    (void)removed;
+}
+
+TEST(swiss_order_map_bounds) {
+    SwissOrderMap index(0);
+    index.reserve(100000);
+    const std::size_t capacity = index.capacity();
+    assert(capacity >= 100000 * 8 / 7);
+    for (OrderId id = 1; id <= 100000; ++id) {
+        index.put(id << 20, nullptr);
+    }
+    // Presized: no growth, and the mix keeps even strided ids inside the bound
+    assert(index.capacity() == capacity);
+    assert(index.max_probe() <= SwissOrderMap::MAX_PROBE_GROUPS);
+    (void)capacity;
+}
+
+TEST(paged_order_map_pages) {
+    constexpr std::size_t PAGE = PagedOrderMap::PAGE_SLOTS;
+    auto order_for = [](OrderId id) {
+        return reinterpret_cast<Order*>(static_cast<std::uintptr_t>(id) * 64);
+    };
+    PagedOrderMap index(0);
+    
+    // Sequential refs: every one lands in a page
+    for (OrderId id = 1; id <= 8 * PAGE; ++id) index.put(id, order_for(id));
+    assert(index.fallback_size() == 0);
+    assert(index.pages_in_use() == 9);
+    
+    // A page goes back to the free list once its last order leaves
+    for (OrderId id = PAGE; id < 2 * PAGE; ++id) assert(index.extract(id) == order_for(id));
+    assert(index.pages_in_use() == 8);
+    assert(index.find(PAGE) == nullptr && index.find(2 * PAGE) == order_for(2 * PAGE));
+    
+    // Out of pattern: a ref below the window front goes to the fallback
+    for (OrderId id = 1; id < PAGE; ++id) index.remove(id);
+    index.put(5, order_for(5));
+    assert(index.fallback_size() == 1 && index.find(5) == order_for(5));
+    assert(index.size() == 6 * PAGE + 2 && index.pages_in_use() == 7);
+    
+    // One ref per three pages never pays for a page past MIN_PAGES: hashed
+    PagedOrderMap sparse(0);
+    for (OrderId i = 1; i <= 1000; ++i) sparse.put(i * PAGE * 3, order_for(i));
+    assert(sparse.pages_in_use() == PagedOrderMap::MIN_PAGES);
+    assert(sparse.fallback_size() == 1000 - PagedOrderMap::MIN_PAGES);
+    for (OrderId i = 1; i <= 1000; ++i) assert(sparse.find(i * PAGE * 3) == order_for(i));
+    
+    // A long-lived order is moved to the fallback when the window outgrows it
+    PagedOrderMap window(0);
+    window.put(1, order_for(1));
+    const OrderId far = 2 * PagedOrderMap::MIN_SPAN_PAGES * PAGE + 1;
+    for (OrderId id = far; id < far + 64; ++id) window.put(id, order_for(id));
+    assert(window.fallback_size() == 1 && window.find(1) == order_for(1));
+    assert(window.extract(1) == order_for(1) && window.size() == 64);
+    
+    // Refs beyond any real session hash and leave the window alone
+    const std::size_t pages = window.pages_in_use();
+    window.put(PagedOrderMap::HASHED_REF_FLOOR + 7, order_for(7));
+    assert(window.fallback_size() == 1 && window.pages_in_use() == pages);
+    assert(window.find(far) == order_for(far));
+    assert(window.extract(PagedOrderMap::HASHED_REF_FLOOR + 7) == order_for(7));
+    (void)order_for;
+    (void)pages;
+}
+
 // =============================================================================
 // Price Level Tests
 // =============================================================================
@@ -331,6 +583,125 @@ TEST(order_book_replace_order) {
     assert(bbo.bid_quantity == 750);
 }
 
+TEST(order_book_replace_in_place) {
+    ObjectPool<Order> pool;
+    OrderBook book(1);
+    
+    Order* first = book.add_order(1, Side::Buy, 1500000, 100, 1, pool);
+    book.add_order(2, Side::Buy, 1500000, 200, 2, pool);
+    book.add_order(3, Side::Buy, 1499000, 50, 3, pool);
+    const std::size_t available = pool.available();
+    
+    // Same price: same object, new id, loses priority to order 2
+    Order* replaced = book.replace_order(1, 10, 300, 1500000, 4, pool);
+    assert(replaced == first);
+    assert(replaced->order_id == 10 && replaced->quantity == 300 && replaced->timestamp == 4);
+    assert(book.get_order(1) == nullptr && book.get_order(10) == replaced);
+    assert(book.bbo().bid_price == 1500000 && book.bbo().bid_quantity == 500);
+    assert(pool.available() == available);
+    std::vector<OrderId> fifo;
+    book.for_each_order([&](const Order& o) { fifo.push_back(o.order_id); });
+    assert((fifo == std::vector<OrderId>{2, 10, 3}));
+    
+    // New price: moves to the tail of the other level
+    replaced = book.replace_order(10, 11, 40, 1499000, 5, pool);
+    assert(replaced == first && replaced->price == 1499000);
+    assert(book.bbo().bid_quantity == 200 && book.bid_level_count() == 2);
+    fifo.clear();
+    book.for_each_order([&](const Order& o) { fifo.push_back(o.order_id); });
+    assert((fifo == std::vector<OrderId>{2, 3, 11}));
+    
+    // Last order of a level moves away: the level disappears
+    book.replace_order(2, 12, 200, 1498000, 6, pool);
+    assert(book.bbo().bid_price == 1499000 && book.bbo().bid_quantity == 90);
+    
+    // Clashing new id: the old order is removed and nothing is added
+    assert(book.replace_order(12, 3, 10, 1499000, 7, pool) == nullptr);
+    assert(book.get_order(12) == nullptr && book.get_order(3) != nullptr);
+    assert(book.order_count() == 2 && book.bid_level_count() == 1);
+    assert(pool.available() == available + 1);
+    assert(book.replace_order(999, 1000, 1, 1, 8, pool) == nullptr);
+    
+    // Deltas and the depth cache stay in step with the levels through replaces
+    constexpr std::size_t LEVELS = 4;
+    OrderBook depth_book(2);
+    DepthDeltaBuffer deltas(1024);
+    depth_book.set_depth_feed(&deltas, LEVELS);
+    depth_book.set_depth_cache(LEVELS);
+    std::vector<DepthLevel> bids;
+    std::vector<OrderId> live;
+    std::mt19937 rng(5);
+    OrderId next_id = 1;
+    std::array<DepthLevel, LEVELS> cached;
+    for (int i = 0; i < 20000; ++i) {
+        if (live.empty() || rng() % 3 == 0) {
+            depth_book.add_order(next_id, Side::Buy, 1000000 - static_cast<Price>(rng() % 12) * 100,
+                                 static_cast<Quantity>(1 + rng() % 500), static_cast<Timestamp>(i), pool);
+            live.push_back(next_id++);
+        } else {
+            const std::size_t pick = rng() % live.size();
+            const Order* o = depth_book.get_order(live[pick]);
+            const Price price = rng() % 2 ? o->price : 1000000 - static_cast<Price>(rng() % 12) * 100;
+            depth_book.replace_order(live[pick], next_id, static_cast<Quantity>(1 + rng() % 500), price,
+                                     static_cast<Timestamp>(i), pool);
+            live[pick] = next_id++;
+        }
+        for (const auto& d : deltas) {
+            const DepthLevel level{d.price, d.quantity, d.order_count};
+            switch (d.action) {
+                case DepthAction::New:    bids.insert(bids.begin() + d.level, level); break;
+                case DepthAction::Change: bids[d.level] = level; break;
+                case DepthAction::Delete: bids.erase(bids.begin() + d.level); break;
+            }
+        }
+        deltas.clear();
+        
+        const auto expected = depth_book.bid_depth(LEVELS);
+        const std::size_t n = depth_book.bid_depth(cached);
+        assert(bids.size() == expected.size() && n == expected.size());
+        for (std::size_t l = 0; l < n; ++l) {
+            assert(bids[l].price == expected[l].price && cached[l].price == expected[l].price);
+            assert(bids[l].quantity == expected[l].quantity);
+            assert(cached[l].quantity == expected[l].quantity);
+            assert(cached[l].order_count == expected[l].order_count);
+        }
+        (void)n;
+    }
+    assert(depth_book.order_count() == live.size());
+}
+
+TEST(order_book_handle_api) {
+    ObjectPool<Order> pool;
+    OrderBook book(1);
+    
+    book.add_order(1, Side::Buy, 1500000, 100, 1, pool);
+    book.add_order(2, Side::Buy, 1500000, 200, 2, pool);
+    book.add_order(3, Side::Sell, 1501000, 300, 3, pool);
+    
+    // Orders point at the level that holds them
+    Order* bid = book.get_order(1);
+    assert(bid->level != nullptr && bid->level->price() == 1500000);
+    assert(bid->level == book.get_order(2)->level);
+    assert(bid->level->total_quantity() == 300);
+    
+    assert(book.execute_order(bid, 40, pool) == 40);
+    assert(bid->quantity == 60 && bid->level->total_quantity() == 260);
+    assert(book.bbo().bid_quantity == 260);
+    
+    assert(book.cancel_order(bid, 100, pool) == 60);   // Clamped; fully removes
+    assert(book.get_order(1) == nullptr && book.order_count() == 2);
+    assert(book.bbo().bid_quantity == 200);
+    
+    // Deleting the last order of a level removes the level
+    book.delete_order(book.get_order(3), pool);
+    assert(book.get_order(3) == nullptr && book.ask_level_count() == 0);
+    assert(!book.bbo().has_ask());
+    
+    // Replaced orders follow their new level
+    Order* moved = book.replace_order(2, 4, 50, 1499000, 4, pool);
+    assert(moved->level->price() == 1499000 && moved->level->order_count() == 1);
+}
+
 TEST(order_book_market_depth) {
     ObjectPool<Order> pool;
     OrderBook book(1);
@@ -382,6 +753,188 @@ TEST(order_book_duplicate_order_id) {
     assert(book.order_count() == 1);
 }
 
+TEST(order_book_depth_deltas) {
+    ObjectPool<Order> pool;
+    OrderBook book(1);
+    DepthDeltaBuffer deltas(64);
+    book.set_depth_feed(&deltas, 2);
+    
+    book.add_order(1, Side::Buy, 1500000, 100, 1, pool);   // New @0
+    book.add_order(2, Side::Buy, 1499000, 200, 2, pool);   // New @1
+    book.add_order(3, Side::Buy, 1498000, 300, 3, pool);   // Outside window
+    assert(deltas.size() == 2);
+    assert(deltas[0].action == DepthAction::New && deltas[0].level == 0);
+    assert(deltas[1].action == DepthAction::New && deltas[1].level == 1);
+    assert(deltas[1].price == 1499000 && deltas[1].quantity == 200);
+    deltas.clear();
+    
+    // Better bid pushes 149.9 out of the window
+    book.add_order(4, Side::Buy, 1501000, 50, 4, pool);
+    assert(deltas.size() == 2);
+    assert(deltas[0].action == DepthAction::Delete && deltas[0].level == 1);
+    assert(deltas[0].price == 1499000);
+    assert(deltas[1].action == DepthAction::New && deltas[1].level == 0);
+    assert(deltas[1].price == 1501000);
+    deltas.clear();
+    
+    // Partial execute at the best level
+    book.execute_order(4, 20, pool);
+    assert(deltas.size() == 1);
+    assert(deltas[0].action == DepthAction::Change && deltas[0].level == 0);
+    assert(deltas[0].quantity == 30 && deltas[0].order_count == 1);
+    deltas.clear();
+    
+    // Removing the best level backfills from beyond the window
+    book.delete_order(4, pool);
+    assert(deltas.size() == 2);
+    assert(deltas[0].action == DepthAction::Delete && deltas[0].level == 0);
+    assert(deltas[1].action == DepthAction::New && deltas[1].level == 1);
+    assert(deltas[1].price == 1499000);
+    deltas.clear();
+    
+    // Changes outside the window are silent
+    book.cancel_order(3, 100, pool);
+    assert(deltas.empty());
+    assert(!deltas.overflowed());
+}
+
+TEST(order_book_depth_deltas_replay) {
+    // Applying deltas to a consumer-side array must reproduce bid/ask_depth(N)
+    constexpr std::size_t LEVELS = 5;
+    ObjectPool<Order> pool;
+    OrderBook book(1);
+    DepthDeltaBuffer deltas(1024);
+    book.set_depth_feed(&deltas, LEVELS);
+    
+    std::vector<DepthLevel> bids, asks;
+    std::vector<OrderId> live;
+    std::mt19937 rng(7);
+    OrderId next_id = 1;
+    
+    for (int i = 0; i < 20000; ++i) {
+        const int action = static_cast<int>(rng() % 4);
+        if (action == 0 || live.empty()) {
+            const bool buy = rng() % 2 == 0;
+            const Price price = buy ? 1000000 - static_cast<Price>(rng() % 20) * 100
+                                    : 1000100 + static_cast<Price>(rng() % 20) * 100;
+            book.add_order(next_id, buy ? Side::Buy : Side::Sell, price,
+                           static_cast<Quantity>(1 + rng() % 500), static_cast<Timestamp>(i), pool);
+            live.push_back(next_id++);
+        } else {
+            const std::size_t pick = rng() % live.size();
+            const OrderId id = live[pick];
+            if (action == 1) {
+                book.execute_order(id, static_cast<Quantity>(1 + rng() % 300), pool);
+            } else {
+                book.delete_order(id, pool);
+            }
+            if (book.get_order(id) == nullptr) {
+                live[pick] = live.back();
+                live.pop_back();
+            }
+        }
+        
+        for (const auto& d : deltas) {
+            auto& side = is_buy(d.side) ? bids : asks;
+            const DepthLevel level{d.price, d.quantity, d.order_count};
+            switch (d.action) {
+                case DepthAction::New:    side.insert(side.begin() + d.level, level); break;
+                case DepthAction::Change: side[d.level] = level; break;
+                case DepthAction::Delete: side.erase(side.begin() + d.level); break;
+            }
+        }
+        deltas.clear();
+        
+        const auto expected_bids = book.bid_depth(LEVELS);
+        const auto expected_asks = book.ask_depth(LEVELS);
+        assert(bids.size() == expected_bids.size());
+        assert(asks.size() == expected_asks.size());
+        for (std::size_t l = 0; l < bids.size(); ++l) {
+            assert(bids[l].price == expected_bids[l].price);
+            assert(bids[l].quantity == expected_bids[l].quantity);
+            assert(bids[l].order_count == expected_bids[l].order_count);
+        }
+        for (std::size_t l = 0; l < asks.size(); ++l) {
+            assert(asks[l].price == expected_asks[l].price);
+            assert(asks[l].quantity == expected_asks[l].quantity);
+        }
+    }
+}
+
+TEST(order_book_depth_cache) {
+    // Cached top-N reads must match a walk of the price levels after every update
+    constexpr std::size_t LEVELS = 5;
+    ObjectPool<Order> pool;
+    OrderBook book(1);
+    DepthDeltaBuffer deltas(1024);
+    book.add_order(1, Side::Buy, 1000000, 100, 0, pool);
+    book.add_order(2, Side::Sell, 1000100, 100, 0, pool);
+    book.set_depth_cache(LEVELS);
+    book.set_depth_feed(&deltas, 3);
+    
+    std::array<DepthLevel, LEVELS> cached;
+    assert(book.bid_depth(cached) == 1 && cached[0].price == 1000000);
+    
+    std::vector<OrderId> live = {1, 2};
+    std::mt19937 rng(11);
+    OrderId next_id = 3;
+    DepthLevel walked[64];
+    
+    for (int i = 0; i < 20000; ++i) {
+        const int action = static_cast<int>(rng() % 4);
+        if (action == 0 || live.empty()) {
+            const bool buy = rng() % 2 == 0;
+            const Price price = buy ? 1000000 - static_cast<Price>(rng() % 20) * 100
+                                    : 1000100 + static_cast<Price>(rng() % 20) * 100;
+            book.add_order(next_id, buy ? Side::Buy : Side::Sell, price,
+                           static_cast<Quantity>(1 + rng() % 500), static_cast<Timestamp>(i), pool);
+            live.push_back(next_id++);
+        } else {
+            const std::size_t pick = rng() % live.size();
+            const OrderId id = live[pick];
+            if (action == 1) {
+                book.execute_order(id, static_cast<Quantity>(1 + rng() % 300), pool);
+            } else {
+                book.delete_order(id, pool);
+            }
+            if (book.get_order(id) == nullptr) {
+                live[pick] = live.back();
+                live.pop_back();
+            }
+        }
+        deltas.clear();
+        
+        // Requests deeper than the cache fall back to the level walk
+        const std::size_t bid_levels = book.bid_depth(walked, 64);
+        const std::size_t n = book.bid_depth(cached);
+        assert(n == std::min(LEVELS, bid_levels));
+        for (std::size_t l = 0; l < n; ++l) {
+            assert(cached[l].price == walked[l].price);
+            assert(cached[l].quantity == walked[l].quantity);
+            assert(cached[l].order_count == walked[l].order_count);
+        }
+        const std::size_t ask_levels = book.ask_depth(walked, 64);
+        const std::size_t m = book.ask_depth(cached.data(), 3);
+        assert(m == std::min<std::size_t>(3, ask_levels));
+        for (std::size_t l = 0; l < m; ++l) {
+            assert(cached[l].price == walked[l].price);
+            assert(cached[l].quantity == walked[l].quantity);
+        }
+        (void)bid_levels; (void)ask_levels; (void)n; (void)m;
+    }
+    
+    book.clear(pool);
+    assert(book.bid_depth(cached) == 0 && book.ask_depth(cached) == 0);
+    
+    // The manager applies the cache to books created later
+    OrderBookManager manager;
+    manager.set_depth_cache(LEVELS);
+    OrderBook& later = manager.get_book(9);
+    assert(later.depth_cache_levels() == LEVELS);
+    later.add_order(1, Side::Sell, 1000500, 10, 0, manager.order_pool());
+    assert(later.ask_depth(cached) == 1 && cached[0].quantity == 10);
+}
+
 // =============================================================================
 // Order Book Manager Tests
 // =============================================================================
@@ -418,6 +971,229 @@ TEST(book_manager_total_count) {
     assert(manager.total_order_count() == 0);
 }
 
+TEST(book_manager_active_books) {
+    OrderBookManager manager;
+    auto& pool = manager.order_pool();
+    
+    // Touched out of order; iteration is in locate order
+    for (StockLocate locate : std::initializer_list<StockLocate>{8000, 3, 64, 63, 3}) {
+        manager.get_book(locate).add_order(locate * 10 + manager.get_book(locate).order_count(),
+                                           Side::Buy, 1000000, 100, 0, pool);
+    }
+    assert(manager.active_book_count() == 4);
+    std::vector<StockLocate> seen;
+    manager.for_each_book([&](const OrderBook& book) { seen.push_back(book.stock_locate()); });
+    assert((seen == std::vector<StockLocate>{3, 63, 64, 8000}));
+    assert(manager.total_order_count() == 5);
+    
+    // clear() empties the active books (sparse index: keys removed one by one)
+    // and keeps them; the index accepts the same refs again
+    manager.clear();
+    assert(manager.total_order_count() == 0);
+    assert(manager.active_book_count() == 4);
+    assert(manager.has_book(64));
+    assert(pool.available() == pool.capacity());
+    assert(manager.get_book(3).add_order(30, Side::Sell, 1010000, 100, 0, pool));
+    assert(manager.get_book(3).get_order(31) == nullptr);
+    
+    // A well-filled index (OrderMap backend) is wiped in one pass instead
+    OrderBook dense(7, 64);
+    for (OrderId id = 1; id <= 20; ++id) {
+        dense.add_order(id, Side::Buy, 1000000 - static_cast<Price>(id), 100, 0, pool);
+    }
+    dense.clear(pool);
+    assert(dense.order_count() == 0);
+    assert(dense.get_order(5) == nullptr);
+    assert(dense.add_order(5, Side::Buy, 1000000, 100, 0, pool));
+    dense.clear(pool);
+    
+    manager.set_depth_cache(4);
+    manager.for_each_book([](const OrderBook& book) {
+        assert(book.depth_cache_levels() == 4);
+        (void)book;
+    });
+    (void)seen;
+}
+
+TEST(book_manager_sparse_books) {
+    OrderBookManager manager;
+    assert(manager.active_book_count() == 0);
+    assert(!manager.has_book(0));
+    assert(manager.find_book(5) == nullptr);
+    assert(!manager.has_book(OrderBookManager::MAX_SYMBOLS));
+    
+    // Locate 0 is an ordinary locate, not an "unused" marker
+    auto& zero = manager.get_book(0);
+    zero.add_order(1, Side::Buy, 1000000, 100, 0, manager.order_pool());
+    assert(manager.has_book(0));
+    assert(manager.find_book(0) == &zero);
+    assert(manager.total_order_count() == 1);
+    
+    // open_book() allocates once; later opens and get_book() return the same book
+    auto& opened = manager.open_book(5);
+    assert(manager.has_book(5));
+    opened.add_order(2, Side::Sell, 1010000, 100, 0, manager.order_pool());
+    assert(&manager.open_book(5) == &opened);
+    assert(&manager.get_book(5) == &opened);
+    assert(opened.order_count() == 1);
+    assert(manager.active_book_count() == 2);
+    
+    // Without a sizing hint a book starts small and grows with its orders
+    assert(opened.order_capacity() < OrderBookManager::UNSIZED_BOOK_CAPACITY * 4);
+    for (OrderId id = 10; id < 30000; ++id) {
+        opened.add_order(id, Side::Sell, 1010000, 100, 0, manager.order_pool());
+    }
+    assert(opened.order_count() == 30000 - 10 + 1);
+    assert(opened.get_order(29999) != nullptr && opened.get_order(2) != nullptr);
+    (void)zero;
+    (void)opened;
+}
+
+TEST(book_manager_presize) {
+    OrderBookManager manager;
+    auto& existing = manager.get_book(1);
+    manager.presize(50000, 20000);
+    assert(manager.order_pool().available() >= 50000);
+    
+    // Existing and later books both hold the hinted peak
+    auto& fresh = manager.get_book(2);
+    assert(fresh.order_capacity() > OrderBookManager().open_book(2).order_capacity());
+    for (OrderId id = 1; id <= 20000; ++id) {
+        existing.add_order(id, Side::Buy, 1000000, 100, 0, manager.order_pool());
+        fresh.add_order(100000 + id, Side::Sell, 1010000, 100, 0, manager.order_pool());
+    }
+    assert(existing.order_count() == 20000);
+    assert(fresh.order_count() == 20000);
+    (void)existing;
+    (void)fresh;
+}
+
+// =============================================================================
+// Compact Layout Tests
+// =============================================================================
+
+TEST(compact_order_store) {
+    CompactOrderStore store(2);
+    std::vector<CompactOrderHandle> handles;
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        const CompactOrderHandle h = store.acquire();
+        assert(h);
+        store.hot(h).quantity = i;
+        store.cold(h).order_id = i + 1000;
+        handles.push_back(h);
+    }
+    // Growth relocates the arrays but handles stay valid
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        assert(store.hot(handles[i]).quantity == i);
+        assert(store.cold(handles[i]).order_id == i + 1000);
+    }
+    store.release(handles[7]);
+    assert(store.acquire() == handles[7]);
+    assert(!CompactOrderHandle{});
+}
+
+TEST(compact_book_matches_wide) {
+    // The same random add/execute/cancel/replace/delete stream through both
+    // layouts must leave identical books, level by level and order by order
+    ObjectPool<Order> pool;
+    CompactOrderStore store;
+    OrderBook wide(1);
+    CompactOrderBook compact(1);
+    std::vector<OrderId> live;
+    std::mt19937 rng(13);
+    OrderId next_id = 1;
+    
+    for (int i = 0; i < 20000; ++i) {
+        const int action = static_cast<int>(rng() % 5);
+        if (action == 0 || live.empty()) {
+            const bool buy = rng() % 2 == 0;
+            const Price price = buy ? 1000000 - static_cast<Price>(rng() % 30) * 100
+                                    : 1000100 + static_cast<Price>(rng() % 30) * 100;
+            const Quantity qty = static_cast<Quantity>(1 + rng() % 500);
+            const Side side = buy ? Side::Buy : Side::Sell;
+            const bool added = wide.add_order(next_id, side, price, qty, i, pool) != nullptr;
+            const bool added_compact = static_cast<bool>(
+                compact.add_order(next_id, side, price, qty, i, store));
+            assert(added && added_compact);
+            (void)added; (void)added_compact;
+            live.push_back(next_id++);
+        } else {
+            const std::size_t pick = rng() % live.size();
+            const OrderId id = live[pick];
+            const Quantity qty = static_cast<Quantity>(1 + rng() % 300);
+            if (action == 1) {
+                const Quantity a = wide.execute_order(id, qty, pool);
+                const Quantity b = compact.execute_order(id, qty, store);
+                assert(a == b);
+                (void)a; (void)b;
+            } else if (action == 2) {
+                const Quantity a = wide.cancel_order(wide.get_order(id), qty, pool);
+                const Quantity b = compact.cancel_order(compact.get_order(id), qty, store);
+                assert(a == b);
+                (void)a; (void)b;
+            } else if (action == 3) {
+                const Price price = 1000000 + (static_cast<Price>(rng() % 30) - 15) * 100;
+                wide.replace_order(id, next_id, qty, price, i, pool);
+                compact.replace_order(id, next_id, qty, price, i, store);
+                live[pick] = next_id++;
+            } else {
+                wide.delete_order(id, pool);
+                compact.delete_order(id, store);
+            }
+            if (wide.get_order(live[pick]) == nullptr) {
+                assert(!compact.get_order(live[pick]));
+                live[pick] = live.back();
+                live.pop_back();
+            }
+        }
+        
+        assert(wide.order_count() == compact.order_count());
+        assert(wide.bbo().bid_price == compact.bbo().bid_price);
+        assert(wide.bbo().bid_quantity == compact.bbo().bid_quantity);
+        assert(wide.bbo().ask_price == compact.bbo().ask_price);
+        assert(wide.bbo().ask_quantity == compact.bbo().ask_quantity);
+    }
+    
+    const auto wide_bids = wide.bid_depth(100);
+    const auto compact_bids = compact.bid_depth(100);
+    assert(wide_bids.size() == compact_bids.size());
+    for (std::size_t l = 0; l < wide_bids.size(); ++l) {
+        assert(wide_bids[l].price == compact_bids[l].price);
+        assert(wide_bids[l].quantity == compact_bids[l].quantity);
+        assert(wide_bids[l].order_count == compact_bids[l].order_count);
+    }
+    
+    std::vector<Order> expected;
+    wide.for_each_order([&](const Order& o) { expected.push_back(o); });
+    std::size_t n = 0;
+    compact.for_each_order(store, [&](const CompactOrder& hot, const CompactOrderCold& cold) {
+        const Order& o = expected[n++];
+        assert(cold.order_id == o.order_id && cold.price == o.price);
+        assert(hot.quantity == o.quantity && hot.side == o.side);
+        assert(cold.original_qty == o.original_qty && cold.timestamp == o.timestamp);
+        (void)o; (void)hot; (void)cold;
+    });
+    assert(n == expected.size() && n == compact.order_count());
+    
+    compact.clear(store);
+    assert(compact.order_count() == 0 && !compact.bbo().has_bid());
+}
+
+TEST(compact_book_manager) {
+    CompactOrderBookManager manager;
+    manager.presize(1000, 500);
+    CompactOrderBook& book = manager.get_book(42);
+    assert(book.stock_locate() == 42);
+    const CompactOrderHandle h = book.add_order(1, Side::Buy, 1500000, 100, 0, manager.order_pool());
+    assert(h && manager.order_pool().cold(h).stock_locate == 42);
+    book.add_order(2, Side::Sell, 1500100, 200, 0, manager.order_pool());
+    assert(manager.total_order_count() == 2);
+    assert(book.bbo().spread() == 100);
+    (void)h;
+    manager.clear();
+    assert(manager.total_order_count() == 0);
+}
+
 // =============================================================================
 // Symbol Directory Tests
 // =============================================================================
@@ -455,6 +1231,7 @@ TEST(order_alignment) {
     // Verify Order is cache-line aligned
     assert(sizeof(Order) == 64);
     assert(alignof(Order) >= 64);
+    assert(sizeof(CompactOrder) + sizeof(CompactOrderCold) < sizeof(Order));
 }
 
 // =============================================================================
@@ -469,6 +1246,16 @@ int main() {
     std::cout << "\nObject Pool Tests:\n";
     RUN_TEST(object_pool_acquire_release);
     RUN_TEST(object_pool_growth);
+    RUN_TEST(object_pool_hard_capacity);
+    RUN_TEST(object_pool_background_refill);
+    RUN_TEST(object_pool_hard_capacity_after_background_refill);
+    
+    // Order index tests
+    std::cout << "\nOrder Index Tests:\n";
+    RUN_TEST(order_index_backends);
+    RUN_TEST(order_map_incremental_resize);
+    RUN_TEST(swiss_order_map_bounds);
+    RUN_TEST(paged_order_map_pages);
     
     // Price level tests
     std::cout << "\nPrice Level Tests:\n";
@@ -484,13 +1271,27 @@ int main() {
     RUN_TEST(order_book_cancel_order);
     RUN_TEST(order_book_delete_order);
     RUN_TEST(order_book_replace_order);
+    RUN_TEST(order_book_replace_in_place);
+    RUN_TEST(order_book_handle_api);
     RUN_TEST(order_book_market_depth);
     RUN_TEST(order_book_duplicate_order_id);
+    RUN_TEST(order_book_depth_deltas);
+    RUN_TEST(order_book_depth_deltas_replay);
+    RUN_TEST(order_book_depth_cache);
     
     // Order book manager tests
     std::cout << "\nOrder Book Manager Tests:\n";
     RUN_TEST(book_manager_get_book);
     RUN_TEST(book_manager_total_count);
+    RUN_TEST(book_manager_active_books);
+    RUN_TEST(book_manager_sparse_books);
+    RUN_TEST(book_manager_presize);
+    
+    // Compact layout tests
+    std::cout << "\nCompact Layout Tests:\n";
+    RUN_TEST(compact_order_store);
+    RUN_TEST(compact_book_matches_wide);
+    RUN_TEST(compact_book_manager);
     
     // Symbol directory tests
     std::cout << "\nSymbol Directory Tests:\n";